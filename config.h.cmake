@@ -18,6 +18,8 @@
 #cmakedefine HAVE_IO_H 1
 #cmakedefine HAVE_LANGINFO_H 1
 #cmakedefine HAVE_LOCALE_H 1
+#cmakedefine HAVE_RECVMMSG 1
+#cmakedefine HAVE_SENDMMSG 1
 #cmakedefine HAVE_SHARE_H 1
 #cmakedefine HAVE_SIGNAL_H 1
 #cmakedefine HAVE_STDINT_H 1
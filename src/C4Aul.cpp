@@ -22,6 +22,7 @@
 
 #include <C4Config.h>
 #include <C4Def.h>
+#include <C4Game.h>
 #include <C4Log.h>
 #include <C4Components.h>
 
@@ -473,6 +474,10 @@ void C4AulScriptEngine::UnLink()
 {
 	// unlink scripts
 	C4AulScript::UnLink();
+	// overloads are resolved anew on the next link
+	++FuncLookUp.Generation;
+	// cached search conditions are keyed by call sites in the freed byte code
+	Game.FindObjectCache.Clear();
 	// clear string table ("hold" strings only)
 	Strings.Clear();
 	// Do not clear global variables and constants, because they are registered by the
@@ -522,7 +527,7 @@ void C4AulScriptEngine::CompileFunc(StdCompiler *pComp)
 
 static const size_t CapacityInc = 1024;
 
-C4AulFuncMap::C4AulFuncMap() : Capacity(CapacityInc), FuncCnt(0), Funcs(new C4AulFunc *[CapacityInc])
+C4AulFuncMap::C4AulFuncMap() : Generation(1), Capacity(CapacityInc), FuncCnt(0), Funcs(new C4AulFunc *[CapacityInc])
 {
 	memset(Funcs, 0, sizeof(C4AulFunc *) * Capacity);
 }
@@ -576,6 +581,7 @@ C4AulFunc *C4AulFuncMap::GetFunc(const char *Name, const C4AulScript *Owner, con
 
 void C4AulFuncMap::Add(C4AulFunc *func, bool bAtStart)
 {
+	++Generation;
 	if (++FuncCnt > Capacity)
 	{
 		int NCapacity = Capacity + CapacityInc;
@@ -622,6 +628,7 @@ void C4AulFuncMap::Add(C4AulFunc *func, bool bAtStart)
 
 void C4AulFuncMap::Remove(C4AulFunc *func)
 {
+	++Generation;
 	C4AulFunc **pFunc = &Funcs[Hash(func->Name) % Capacity];
 	while (*pFunc != func)
 	{
@@ -30,6 +30,8 @@
 #include <C4Script.h>
 #include <C4StringTable.h>
 #include <cstdint>
+#include <new>
+#include <type_traits>
 
 #include <vector>
 
@@ -96,24 +98,53 @@ enum C4AulAccess
 	AA_GLOBAL
 };
 
-struct C4AulParSet
+// parameters of an engine call
+// only the parameters actually passed are constructed; all others read as nil
+class C4AulParSet
 {
-	C4Value Par[C4AUL_MAX_Par];
+	alignas(C4Value) unsigned char Storage[C4AUL_MAX_Par * sizeof(C4Value)];
+	int Count = 0; // constructed parameters
 
+	C4Value *Values() { return std::launder(reinterpret_cast<C4Value *>(Storage)); }
+	const C4Value *Values() const { return std::launder(reinterpret_cast<const C4Value *>(Storage)); }
+
+public:
 	C4AulParSet() {}
-	C4AulParSet(const C4Value &par0, const C4Value &par1 = C4Value(), const C4Value &par2 = C4Value(), const C4Value &par3 = C4Value(), const C4Value &par4 = C4Value(),
-		const C4Value &par5 = C4Value(), const C4Value &par6 = C4Value(), const C4Value &par7 = C4Value(), const C4Value &par8 = C4Value(), const C4Value &par9 = C4Value())
+
+	template <typename... Pars, typename = std::enable_if_t<sizeof...(Pars) <= C4AUL_MAX_Par && (std::is_convertible_v<const Pars &, const C4Value &> && ...)>>
+	C4AulParSet(const Pars &...pars)
 	{
-		Par[0].Set(par0); Par[1].Set(par1); Par[2].Set(par2); Par[3].Set(par3); Par[4].Set(par4);
-		Par[5].Set(par5); Par[6].Set(par6); Par[7].Set(par7); Par[8].Set(par8); Par[9].Set(par9);
+		(new (Values() + Count++) C4Value(pars), ...);
 	}
 
-	C4Value &operator[](int iIdx) { return Par[iIdx]; }
-	const C4Value &operator[](int iIdx) const { return Par[iIdx]; }
-};
+	C4AulParSet(const C4AulParSet &other)
+	{
+		for (; Count < other.Count; ++Count) new (Values() + Count) C4Value(other.Values()[Count]);
+	}
 
-#define Copy2ParSet8(Pars, Vars) Pars[0].Set(Vars##0); Pars[1].Set(Vars##1); Pars[2].Set(Vars##2); Pars[3].Set(Vars##3); Pars[4].Set(Vars##4); Pars[5].Set(Vars##5); Pars[6].Set(Vars##6); Pars[7].Set(Vars##7);
-#define Copy2ParSet9(Pars, Vars) Pars[0].Set(Vars##0); Pars[1].Set(Vars##1); Pars[2].Set(Vars##2); Pars[3].Set(Vars##3); Pars[4].Set(Vars##4); Pars[5].Set(Vars##5); Pars[6].Set(Vars##6); Pars[7].Set(Vars##7); Pars[8].Set(Vars##8);
+	C4AulParSet &operator=(const C4AulParSet &other)
+	{
+		for (int i = 0; i < other.Count; ++i) (*this)[i].Set(other.Values()[i]);
+		for (int i = other.Count; i < Count; ++i) Values()[i].Set0();
+		return *this;
+	}
+
+	~C4AulParSet()
+	{
+		while (Count) Values()[--Count].~C4Value();
+	}
+
+	// constructs all parameters up to iIdx
+	C4Value &operator[](int iIdx)
+	{
+		for (; Count <= iIdx; ++Count) new (Values() + Count) C4Value();
+		return Values()[iIdx];
+	}
+	const C4Value &operator[](int iIdx) const { return iIdx < Count ? Values()[iIdx] : C4VNull; }
+
+	int GetCount() const { return Count; }
+	const C4Value *GetValues() const { return Values(); }
+};
 
 // byte code chunk type
 // some special script functions defined hard-coded to reduce the exec context
@@ -237,8 +268,10 @@ extern C4ScriptOpDef C4ScriptOpMap[];
 struct C4AulBCC
 {
 	C4AulBCCType bccType; // chunk type
+	std::uint32_t CacheGeneration; // call cache: function map generation CacheDef was resolved in
 	std::intptr_t bccX;
 	const char *SPos;
+	C4Def *CacheDef; // call cache: target definition bccX was resolved for
 };
 
 // call context
@@ -369,6 +402,8 @@ public:
 	C4AulFunc *GetFirstFunc(const char *Name);
 	C4AulFunc *GetNextSNFunc(const C4AulFunc *After);
 
+	std::uint32_t Generation; // changed whenever functions are added, removed or relinked; invalidates call caches
+
 private:
 	C4AulFunc **Funcs;
 	int FuncCnt;
@@ -409,9 +444,11 @@ private:
 
 	// items
 	std::vector<Entry> Times;
+	int32_t CallCacheHits = 0, CallCacheMisses = 0;
 
 public:
 	void CollectEntry(C4AulScriptFunc *pFunc, time_t tProfileTime);
+	void SetCallCacheStats(int32_t iHits, int32_t iMisses) { CallCacheHits = iHits; CallCacheMisses = iMisses; }
 	void Show();
 
 	static void Abort();
@@ -419,6 +456,8 @@ public:
 	static void StopProfiling();
 };
 
+void C4AulSetMaxCallDepth(int32_t iMaxDepth); // limits nested script calls; 0 for the engine default
+
 #endif
 
 // script class
@@ -464,6 +503,7 @@ protected:
 	void AddBCC(C4AulBCCType eType, std::intptr_t = 0, const char *SPos = nullptr); // add byte code chunk and advance
 	bool Preparse(); // preparse script; return if successfull
 	void ParseFn(C4AulScriptFunc *Fn, bool fExprOnly = false); // parse single script function
+	void OptimizeFn(C4AulScriptFunc *Fn); // optimize byte code of the function parsed last
 
 	bool Parse(); // parse preparsed script; return if successfull
 	void ParseDescs(); // parse function descs
@@ -562,6 +602,8 @@ public:
 		return FuncLookUp.GetNextSNFunc(After);
 	}
 
+	std::uint32_t GetFuncGeneration() const { return FuncLookUp.Generation; }
+
 	// For the list of functions in the PropertyDlg
 	C4AulFunc *GetFirstFunc() { return Func0; }
 	C4AulFunc *GetNextFunc(C4AulFunc *pFunc) { return pFunc->Next; }
@@ -26,6 +26,10 @@
 #include <C4ValueHash.h>
 #include <C4Wrappers.h>
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 C4AulExecError::C4AulExecError(C4Object *pObj, const char *szError) : cObj(pObj)
 {
 	// direct error message string
@@ -46,8 +50,12 @@ void C4AulExecError::show() const
 #endif
 }
 
-const int MAX_CONTEXT_STACK = 512;
-const int MAX_VALUE_STACK = 1024;
+const int32_t DEFAULT_CALL_DEPTH = 512;
+const int32_t MAX_CALL_DEPTH = 4096;
+// nested executions through engine functions; each one takes up to ~4 KB of native stack in debug builds.
+// The old fixed value stack (1024 values, at least 11 per level) never allowed deeper nesting either.
+const int32_t MAX_NATIVE_DEPTH = 93;
+const int32_t VALUE_STACK_PER_CALL = 32; // parameters, variables and temporaries
 
 void C4AulScriptContext::dump(StdStrBuf Dump)
 {
@@ -94,29 +102,75 @@ void C4AulScriptContext::dump(StdStrBuf Dump)
 	DebugLog(Dump.getData());
 }
 
+// Script stack storage: reserved up to its limit, but elements are only
+// constructed (and their memory touched) once the stack grows that far.
+// Elements never move, because contexts and values are referenced by address.
+template<typename T>
+class C4AulExecStack
+{
+public:
+	C4AulExecStack(int32_t iLimit) : Data(nullptr), Limit(0), Constructed(0) { Reserve(iLimit); }
+	~C4AulExecStack() { Clear(); }
+	C4AulExecStack(const C4AulExecStack &) = delete;
+	C4AulExecStack &operator=(const C4AulExecStack &) = delete;
+
+	T *Data;
+	int32_t Limit, Constructed;
+
+	void Grow(int32_t iCnt) // construct elements up to iCnt (which must be <= Limit)
+	{
+		for (; Constructed < iCnt; ++Constructed)
+			new (Data + Constructed) T;
+	}
+
+	void Reserve(int32_t iLimit)
+	{
+		Clear();
+		Data = static_cast<T *>(::operator new(sizeof(T) * iLimit));
+		Limit = iLimit;
+	}
+
+	void Clear()
+	{
+		while (Constructed) Data[--Constructed].~T();
+		::operator delete(Data);
+		Data = nullptr;
+		Limit = 0;
+	}
+};
+
 class C4AulExec
 {
 public:
 	C4AulExec()
-		: pCurCtx(Contexts - 1), pCurVal(Values - 1), iTraceStart(-1) {}
+		: ContextStack(DEFAULT_CALL_DEPTH), ValueStack(DEFAULT_CALL_DEPTH * VALUE_STACK_PER_CALL),
+		Contexts(ContextStack.Data), Values(ValueStack.Data),
+		pCurCtx(Contexts - 1), pCurVal(Values - 1), iNativeDepth(0), iTraceStart(-1) {}
 
 private:
-	C4AulScriptContext Contexts[MAX_CONTEXT_STACK];
-	C4Value Values[MAX_VALUE_STACK];
+	C4AulExecStack<C4AulScriptContext> ContextStack;
+	C4AulExecStack<C4Value> ValueStack;
+	C4AulScriptContext *Contexts;
+	C4Value *Values;
 
 	C4AulScriptContext *pCurCtx;
 	C4Value *pCurVal;
+	int32_t iNativeDepth; // nested calls of Exec
+	// iterators of running for-in loops over maps by their stack slot, innermost last
+	std::vector<std::pair<C4Value *, std::unique_ptr<C4ValueHash::Iterator>>> MapIterators;
 
 	int iTraceStart;
 	bool fProfiling;
 	time_t tDirectExecStart, tDirectExecTotal; // profiler time for DirectExec
 	C4AulScript *pProfiledScript;
+	int32_t iCallCacheHits, iCallCacheMisses; // profiler call cache statistics
 
 public:
-	C4Value Exec(C4AulScriptFunc *pSFunc, C4Object *pObj, const C4Value pPars[], bool fPassErrors, bool fTemporaryScript = false);
+	C4Value Exec(C4AulScriptFunc *pSFunc, C4Object *pObj, const C4Value pPars[], bool fPassErrors, bool fTemporaryScript = false, int iParCnt = C4AUL_MAX_Par);
 	C4Value Exec(C4AulBCC *pCPos, bool fPassErrors);
 
 	void StartTrace();
+	void SetMaxCallDepth(int32_t iMaxDepth);
 	void StartProfiling(C4AulScript *pScript); // resets profling times and starts recording the times
 	void StopProfiling(); // stop the profiler and displays results
 	void AbortProfiling() { fProfiling = false; }
@@ -126,8 +180,10 @@ public:
 private:
 	void PushContext(const C4AulScriptContext &rContext)
 	{
-		if (pCurCtx >= Contexts + MAX_CONTEXT_STACK - 1)
+		const int32_t iSize = ContextStackSize() + 1;
+		if (iSize > ContextStack.Limit)
 			throw C4AulExecError(pCurCtx->Obj, "context stack overflow!");
+		if (iSize > ContextStack.Constructed) ContextStack.Grow(iSize);
 		*++pCurCtx = rContext;
 		// Trace?
 		if (iTraceStart >= 0)
@@ -166,8 +222,11 @@ private:
 
 	void CheckOverflow(int iCnt)
 	{
-		if (ValueStackSize() + iCnt > MAX_VALUE_STACK)
+		const int32_t iSize = ValueStackSize() + iCnt;
+		if (iSize > ValueStack.Limit)
 			throw C4AulExecError(pCurCtx->Obj, "internal error: value stack overflow!");
+		// values above the top are nil: constructed nil or reset when popped
+		if (iSize > ValueStack.Constructed) ValueStack.Grow(iSize);
 	}
 
 	void PushString(C4String *Str)
@@ -218,6 +277,7 @@ private:
 	{
 		if (LocalValueStackSize() < n)
 			throw C4AulExecError(pCurCtx->Obj, "internal error: value stack underflow!");
+		ReleaseMapIterators(pCurVal - n);
 		while (n--)
 			(pCurVal--)->Set0();
 	}
@@ -226,10 +286,18 @@ private:
 	{
 		if (pUntilVal < Values - 1)
 			throw C4AulExecError(pCurCtx->Obj, "internal error: value stack underflow!");
+		ReleaseMapIterators(pUntilVal);
 		while (pCurVal > pUntilVal)
 			(pCurVal--)->Set0();
 	}
 
+	// loops left by break, return or an error, too; before the values, as those may hold the last reference to the map
+	void ReleaseMapIterators(C4Value *pUntilVal)
+	{
+		while (!MapIterators.empty() && MapIterators.back().first > pUntilVal)
+			MapIterators.pop_back();
+	}
+
 	int ContextStackSize() const
 	{
 		return pCurCtx - Contexts + 1;
@@ -312,13 +380,16 @@ private:
 
 C4AulExec AulExec;
 
-C4Value C4AulExec::Exec(C4AulScriptFunc *pSFunc, C4Object *pObj, const C4Value *pnPars, bool fPassErrors, bool fTemporaryScript)
+C4Value C4AulExec::Exec(C4AulScriptFunc *pSFunc, C4Object *pObj, const C4Value *pnPars, bool fPassErrors, bool fTemporaryScript, int iParCnt)
 {
-	// Push parameters
+	// Push parameters; the ones not passed are nil
 	C4Value *pPars = pCurVal + 1;
 	if (pnPars)
-		for (int i = 0; i < C4AUL_MAX_Par; i++)
+	{
+		for (int i = 0; i < iParCnt; i++)
 			PushValue(pnPars[i]);
+		PushNullVals(C4AUL_MAX_Par - iParCnt);
+	}
 
 	// Push variables
 	C4Value *pVars = pCurVal + 1;
@@ -353,8 +424,14 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos, bool fPassErrors)
 	// Save start context
 	C4AulScriptContext *pOldCtx = pCurCtx;
 
+	// Script calls don't recurse natively, but engine functions calling back into script do
+	struct NativeDepthGuard { int32_t &iDepth; ~NativeDepthGuard() { iDepth--; } } DepthGuard{++iNativeDepth};
+
 	try
 	{
+		if (iNativeDepth > MAX_NATIVE_DEPTH)
+			throw C4AulExecError(pCurCtx->Obj, "native call depth exceeded!");
+
 		for (;;)
 		{
 			bool fJump = false;
@@ -856,7 +933,7 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos, bool fPassErrors)
 			case AB_ARRAY:
 			{
 				// Create array
-				C4ValueArray *pArray = new C4ValueArray(pCPos->bccX);
+				C4ValueArray *pArray = C4ValueArray::New(pCPos->bccX);
 
 				// Pop values from stack
 				for (int i = 0; i < pCPos->bccX; i++)
@@ -876,7 +953,7 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos, bool fPassErrors)
 
 			case AB_MAP:
 			{
-				C4ValueHash *map = new C4ValueHash;
+				C4ValueHash *map = C4ValueHash::New();
 				for (int i = 0; i < pCPos->bccX; ++i)
 				{
 					(*map)[pCurVal[2 * (i - pCPos->bccX) + 1]] = pCurVal[2 * (i - pCPos->bccX) + 2];
@@ -1149,34 +1226,27 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos, bool fPassErrors)
 			{
 				// This should always hold
 				assert(pCurVal[-1].ConvertTo(C4V_Int));
-				using Iterator = C4ValueHash::Iterator;
-				auto iterator = reinterpret_cast<Iterator *>(pCurVal[0]._getRef());
-				// Check map the first time only
-				if (!iterator)
+				// Check map and start iterating the first time only
+				if (!pCurVal[0]._getInt())
 				{
 					if (!pCurVal[-2].ConvertTo(C4V_Map))
 						throw C4AulExecError(pCurCtx->Obj, FormatString("for: map expected, but got %s!", pCurVal[-1].GetTypeName()).getData());
 					if (!pCurVal[-2]._getMap())
 						throw C4AulExecError(pCurCtx->Obj, FormatString("for: map expected, but got nil!").getData());
-				}
-				C4ValueHash *map = pCurVal[-2]._getMap();
-				if (!iterator)
-				{
-					iterator = new Iterator (map->begin());
+					MapIterators.emplace_back(pCurVal, std::make_unique<C4ValueHash::Iterator>(pCurVal[-2]._getMap()->begin()));
 					pCurVal[0].SetInt(1);
-					pCurVal[0].GetData().Ref = reinterpret_cast<C4Value *>(iterator);
 				}
-				// No more entries?
-				if (*iterator == map->end())
-				{
-					delete iterator;
+				// loops within the body have released theirs already
+				assert(!MapIterators.empty() && MapIterators.back().first == pCurVal);
+				C4ValueHash::Iterator &iterator = *MapIterators.back().second;
+				// No more entries? The iterator is released with the loop's stack values.
+				if (iterator.atEnd())
 					break;
-				}
 				// Get next
-				pCurCtx->Vars[pCPos->bccX] = (**iterator).first;
-				pCurCtx->Vars[pCurVal[-1]._getInt()] = (**iterator).second;
+				pCurCtx->Vars[pCPos->bccX] = (*iterator).first;
+				pCurCtx->Vars[pCurVal[-1]._getInt()] = (*iterator).second;
 
-				++(*iterator);
+				++iterator;
 				// Jump over next instruction
 				pCPos += 2;
 				fJump = true;
@@ -1229,46 +1299,60 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos, bool fPassErrors)
 							FormatString("Object call: Invalid target type %s, expected object or id!", pTargetVal->GetTypeName()).getData());
 				}
 
-				// Resolve overloads
 				C4AulFunc *pFunc = reinterpret_cast<C4AulFunc *>(pCPos->bccX);
-				while (pFunc->OverloadedBy)
-					pFunc = pFunc->OverloadedBy;
 
-				if (!isGlobal)
+				// Call cache: bccX is already resolved for this target definition?
+				const std::uint32_t iGeneration = Game.ScriptEngine.GetFuncGeneration();
+				if (pCPos->CacheGeneration == iGeneration && pCPos->CacheDef == pDestDef)
 				{
-					// Search function for given context
-					pFunc = pFunc->FindSameNameFunc(pDestDef);
-					if (!pFunc && pCPos->bccType == AB_CALLFS)
+					if (fProfiling) ++iCallCacheHits;
+				}
+				else
+				{
+					if (fProfiling) ++iCallCacheMisses;
+
+					// Resolve overloads
+					while (pFunc->OverloadedBy)
+						pFunc = pFunc->OverloadedBy;
+
+					if (!isGlobal)
 					{
-						PopValuesUntil(pTargetVal);
-						pTargetVal->Set0();
-						break;
+						// Search function for given context
+						pFunc = pFunc->FindSameNameFunc(pDestDef);
+						if (!pFunc && pCPos->bccType == AB_CALLFS)
+						{
+							PopValuesUntil(pTargetVal);
+							pTargetVal->Set0();
+							break;
+						}
 					}
-				}
 
-				// Function not found?
-				if (!pFunc)
-				{
-					const char *szFuncName = reinterpret_cast<C4AulFunc *>(pCPos->bccX)->Name;
-					if (pDestObj)
-						throw C4AulExecError(pCurCtx->Obj,
-							FormatString("Object call: No function \"%s\" in object \"%s\"!", szFuncName, pTargetVal->GetDataString().getData()).getData());
-					else
-						throw C4AulExecError(pCurCtx->Obj,
-							FormatString("Definition call: No function \"%s\" in definition \"%s\"!", szFuncName, pDestDef->Name.getData()).getData());
-				}
+					// Function not found?
+					if (!pFunc)
+					{
+						const char *szFuncName = reinterpret_cast<C4AulFunc *>(pCPos->bccX)->Name;
+						if (pDestObj)
+							throw C4AulExecError(pCurCtx->Obj,
+								FormatString("Object call: No function \"%s\" in object \"%s\"!", szFuncName, pTargetVal->GetDataString().getData()).getData());
+						else
+							throw C4AulExecError(pCurCtx->Obj,
+								FormatString("Definition call: No function \"%s\" in definition \"%s\"!", szFuncName, pDestDef->Name.getData()).getData());
+					}
 
-				else if (C4AulScriptFunc *sfunc = pFunc->SFunc(); sfunc)
-				{
-					C4AulScript *script = sfunc->pOrgScript;
-					if (sfunc->Access < script->GetAllowedAccess(pFunc, sfunc->pOrgScript))
+					else if (C4AulScriptFunc *sfunc = pFunc->SFunc(); sfunc)
 					{
-						throw C4AulExecError(pCurCtx->Obj, FormatString("Insufficient access level for function \"%s\"!", pFunc->Name).getData());
+						C4AulScript *script = sfunc->pOrgScript;
+						if (sfunc->Access < script->GetAllowedAccess(pFunc, sfunc->pOrgScript))
+						{
+							throw C4AulExecError(pCurCtx->Obj, FormatString("Insufficient access level for function \"%s\"!", pFunc->Name).getData());
+						}
 					}
-				}
 
-				// Save function back (optimization)
-				pCPos->bccX = reinterpret_cast<std::intptr_t>(pFunc);
+					// Save function back (optimization)
+					pCPos->bccX = reinterpret_cast<std::intptr_t>(pFunc);
+					pCPos->CacheDef = pDestDef;
+					pCPos->CacheGeneration = iGeneration;
+				}
 
 				// Save current position
 				pCurCtx->CPos = pCPos;
@@ -1460,12 +1544,29 @@ void C4AulStartTrace()
 	AulExec.StartTrace();
 }
 
+void C4AulSetMaxCallDepth(int32_t iMaxDepth)
+{
+	AulExec.SetMaxCallDepth(iMaxDepth);
+}
+
 void C4AulExec::StartTrace()
 {
 	if (iTraceStart < 0)
 		iTraceStart = ContextStackSize();
 }
 
+void C4AulExec::SetMaxCallDepth(int32_t iMaxDepth)
+{
+	// stacks can only be replaced while no script is running
+	if (ContextStackSize() || ValueStackSize()) return;
+	iMaxDepth = iMaxDepth > 0 ? std::min(iMaxDepth, MAX_CALL_DEPTH) : DEFAULT_CALL_DEPTH;
+	if (iMaxDepth == ContextStack.Limit) return;
+	ContextStack.Reserve(iMaxDepth);
+	ValueStack.Reserve(iMaxDepth * VALUE_STACK_PER_CALL);
+	Contexts = ContextStack.Data; pCurCtx = Contexts - 1;
+	Values = ValueStack.Data; pCurVal = Values - 1;
+}
+
 void C4AulExec::StartProfiling(C4AulScript *pProfiledScript)
 {
 	// stop previous profiler run
@@ -1476,6 +1577,7 @@ void C4AulExec::StartProfiling(C4AulScript *pProfiledScript)
 	time_t tNow = timeGetTime();
 	tDirectExecStart = tNow; // in case profiling is started from DirectExec
 	tDirectExecTotal = 0;
+	iCallCacheHits = iCallCacheMisses = 0;
 	pProfiledScript->ResetProfilerTimes();
 	for (C4AulScriptContext *pCtx = Contexts; pCtx <= pCurCtx; ++pCtx)
 		pCtx->tTime = tNow;
@@ -1490,6 +1592,7 @@ void C4AulExec::StopProfiling()
 	C4AulProfiler Profiler;
 	Profiler.CollectEntry(nullptr, tDirectExecTotal);
 	pProfiledScript->CollectProfilerTimes(Profiler);
+	Profiler.SetCallCacheStats(iCallCacheHits, iCallCacheMisses);
 	Profiler.Show();
 }
 
@@ -1533,6 +1636,7 @@ void C4AulProfiler::Show()
 		LogF("%05dms\t%s", static_cast<int>(e.tProfileTime), e.pFunc ? (e.pFunc->GetFullName().getData()) : "Direct exec");
 	}
 	Log("==============================");
+	LogF("Call cache: %d hits, %d misses", CallCacheHits, CallCacheMisses);
 	// done!
 }
 
@@ -1543,8 +1647,11 @@ C4Value C4AulFunc::Exec(C4Object *pObj, const C4AulParSet &pPars, bool fPassErro
 	ctx.Obj = pObj;
 	ctx.Def = pObj ? pObj->Def : nullptr;
 	ctx.Caller = nullptr;
+	// engine functions read all parameters
+	C4Value Pars[C4AUL_MAX_Par];
+	for (int i = 0; i < pPars.GetCount(); i++) Pars[i].Set(pPars[i]);
 	// execute
-	return Exec(&ctx, pPars.Par, fPassErrors);
+	return Exec(&ctx, Pars, fPassErrors);
 }
 
 C4Value C4AulScriptFunc::Exec(C4AulContext *pCtx, const C4Value pPars[], bool fPassErrors)
@@ -1572,7 +1679,7 @@ C4Value C4AulScriptFunc::Exec(C4Object *pObj, const C4AulParSet &pPars, bool fPa
 	if (Owner->State != ASS_PARSED) return C4VNull;
 
 	// execute
-	return AulExec.Exec(this, pObj, pPars.Par, fPassErrors);
+	return AulExec.Exec(this, pObj, pPars.GetValues(), fPassErrors, false, pPars.GetCount());
 
 #else
 
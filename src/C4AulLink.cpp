@@ -280,6 +280,9 @@ void C4AulScriptEngine::Link(C4DefList *rDefs)
 		// get common funcs
 		AfterLink();
 
+		// overloads may have changed: invalidate call caches
+		++FuncLookUp.Generation;
+
 		// non-strict scripts?
 		if (nonStrictCnt)
 		{
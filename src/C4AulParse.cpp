@@ -20,6 +20,7 @@
 #include <C4Include.h>
 #include <C4Aul.h>
 
+#include <C4Config.h>
 #include <C4Def.h>
 #include <C4Game.h>
 #include <C4Wrappers.h>
@@ -913,6 +914,21 @@ static const char *GetTTName(C4AulBCCType e)
 	}
 }
 
+static void DumpBCC(const C4AulBCC &rBCC)
+{
+	const C4AulBCCType eType = rBCC.bccType;
+	const auto X = rBCC.bccX;
+	switch (eType)
+	{
+	case AB_FUNC: case AB_CALL: case AB_CALLFS: case AB_CALLGLOBAL:
+		LogSilentF("%s\t'%s'\n", GetTTName(eType), X ? (reinterpret_cast<C4AulFunc *>(X))->Name : ""); break;
+	case AB_STRING:
+		LogSilentF("%s\t'%s'\n", GetTTName(eType), X ? (reinterpret_cast<C4String *>(X))->Data.getData() : ""); break;
+	default:
+		LogSilentF("%s\t%" PRIdPTR "\n", GetTTName(eType), X); break;
+	}
+}
+
 void C4AulScript::AddBCC(C4AulBCCType eType, std::intptr_t X, const char *SPos)
 {
 	// range check
@@ -931,8 +947,10 @@ void C4AulScript::AddBCC(C4AulBCCType eType, std::intptr_t X, const char *SPos)
 	}
 	// store chunk
 	CPos->bccType = eType;
+	CPos->CacheGeneration = 0;
 	CPos->bccX = X;
 	CPos->SPos = SPos;
+	CPos->CacheDef = nullptr;
 	CPos++; CodeSize++;
 }
 
@@ -3516,6 +3534,7 @@ bool C4AulScript::Parse()
 			try
 			{
 				ParseFn(Fn);
+				OptimizeFn(Fn);
 			}
 			catch (const C4AulError &err)
 			{
@@ -3582,18 +3601,8 @@ bool C4AulScript::Parse()
 				LogSilentF("%s:", Fn->Name);
 				for (C4AulBCC *pBCC = Fn->Code;; pBCC++)
 				{
-					C4AulBCCType eType = pBCC->bccType;
-					const auto X = pBCC->bccX;
-					switch (eType)
-					{
-					case AB_FUNC: case AB_CALL: case AB_CALLFS: case AB_CALLGLOBAL:
-						LogSilentF("%s\t'%s'\n", GetTTName(eType), X ? (reinterpret_cast<C4AulFunc *>(X))->Name : ""); break;
-					case AB_STRING:
-						LogSilentF("%s\t'%s'\n", GetTTName(eType), X ? (reinterpret_cast<C4String *>(X))->Data.getData() : ""); break;
-					default:
-						LogSilentF("%s\t%" PRIdPTR "\n", GetTTName(eType), X); break;
-					}
-					if (eType == AB_EOFN) break;
+					DumpBCC(*pBCC);
+					if (pBCC->bccType == AB_EOFN) break;
 				}
 			}
 		}
@@ -3604,6 +3613,155 @@ bool C4AulScript::Parse()
 	return true;
 }
 
+namespace
+{
+	bool IsJump(C4AulBCCType eType)
+	{
+		return eType == AB_JUMP || eType == AB_JUMPAND || eType == AB_JUMPOR || eType == AB_JUMPNIL || eType == AB_CONDN;
+	}
+
+	// chunks that push a plain value, never a reference
+	// (variable reads don't qualify: by-reference parameters hold a reference that is pushed as is)
+	bool PushesValue(C4AulBCCType eType)
+	{
+		switch (eType)
+		{
+		case AB_NIL: case AB_INT: case AB_BOOL: case AB_STRING: case AB_C4ID: case AB_ARRAY: case AB_MAP:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// Fold an operator applied to int constants at the end of pCode into a single constant.
+	// Only folds what the executor would evaluate identically and without error.
+	bool FoldConstants(C4AulBCC *pCode, int32_t &iCnt, const std::vector<bool> &Targets)
+	{
+		if (iCnt < 2 || Targets[iCnt - 1]) return false;
+		C4AulBCC &rOp = pCode[iCnt - 1];
+
+		// unary operator
+		if (pCode[iCnt - 2].bccType == AB_INT)
+		{
+			const auto a = static_cast<int32_t>(pCode[iCnt - 2].bccX);
+			if (rOp.bccType == AB_Neg || rOp.bccType == AB_BitNot)
+			{
+				pCode[iCnt - 2].bccX = rOp.bccType == AB_Neg ? static_cast<int32_t>(0u - static_cast<uint32_t>(a)) : ~a;
+				--iCnt;
+				return true;
+			}
+		}
+
+		// binary operator
+		if (iCnt < 3 || Targets[iCnt - 2] || pCode[iCnt - 3].bccType != AB_INT || pCode[iCnt - 2].bccType != AB_INT) return false;
+		const auto a = static_cast<int32_t>(pCode[iCnt - 3].bccX), b = static_cast<int32_t>(pCode[iCnt - 2].bccX);
+		const auto ua = static_cast<uint32_t>(a), ub = static_cast<uint32_t>(b);
+		C4AulBCCType eType = AB_INT; int32_t iResult;
+		switch (rOp.bccType)
+		{
+		case AB_Sum: iResult = static_cast<int32_t>(ua + ub); break;
+		case AB_Sub: iResult = static_cast<int32_t>(ua - ub); break;
+		case AB_Mul: iResult = static_cast<int32_t>(ua * ub); break;
+		case AB_Div: case AB_Mod:
+			// division by zero yields nil at runtime
+			if (!b || (a == INT32_MIN && b == -1)) return false;
+			iResult = rOp.bccType == AB_Div ? a / b : a % b;
+			break;
+		case AB_BitAnd: iResult = a & b; break;
+		case AB_BitOr:  iResult = a | b; break;
+		case AB_BitXOr: iResult = a ^ b; break;
+		case AB_LessThan:         eType = AB_BOOL; iResult = a < b; break;
+		case AB_LessThanEqual:    eType = AB_BOOL; iResult = a <= b; break;
+		case AB_GreaterThan:      eType = AB_BOOL; iResult = a > b; break;
+		case AB_GreaterThanEqual: eType = AB_BOOL; iResult = a >= b; break;
+		case AB_EqualIdent: case AB_Equal:       eType = AB_BOOL; iResult = a == b; break;
+		case AB_NotEqualIdent: case AB_NotEqual: eType = AB_BOOL; iResult = a != b; break;
+		default: return false;
+		}
+		pCode[iCnt - 3].bccType = eType;
+		pCode[iCnt - 3].bccX = iResult;
+		iCnt -= 2;
+		return true;
+	}
+}
+
+void C4AulScript::OptimizeFn(C4AulScriptFunc *Fn)
+{
+	// Fn->Code is still relative while the script is parsed
+	const auto iStart = reinterpret_cast<std::intptr_t>(Fn->Code);
+	C4AulBCC *const pCode = Code + iStart;
+	const auto iCnt = static_cast<int32_t>(CodeSize - iStart);
+	if (iCnt <= 0) return;
+
+	if (Config.Developer.DumpScriptBytecode)
+	{
+		LogSilentF("%s (unoptimized):", Fn->Name);
+		for (int32_t i = 0; i < iCnt; ++i) DumpBCC(pCode[i]);
+	}
+
+	// thread jumps that lead to unconditional jumps
+	int32_t i;
+	for (i = 0; i < iCnt; ++i)
+		if (IsJump(pCode[i].bccType))
+		{
+			std::intptr_t iTarget = i + pCode[i].bccX;
+			for (int iHops = 0; iHops < 16 && iTarget >= 0 && iTarget < iCnt && pCode[iTarget].bccType == AB_JUMP; ++iHops)
+				iTarget += pCode[iTarget].bccX;
+			pCode[i].bccX = iTarget - i;
+		}
+
+	// collect jump targets; FOREACH_NEXT jumps over the chunk following it
+	std::vector<bool> Targets(iCnt + 1), Pinned(iCnt + 1);
+	for (i = 0; i < iCnt; ++i)
+		if (IsJump(pCode[i].bccType))
+		{
+			const std::intptr_t iTarget = i + pCode[i].bccX;
+			if (iTarget < 0 || iTarget > iCnt) return; // leaves the function? don't touch
+			Targets[iTarget] = true;
+		}
+		else if (pCode[i].bccType == AB_FOREACH_NEXT || pCode[i].bccType == AB_FOREACH_MAP_NEXT)
+		{
+			if (i + 2 > iCnt) return;
+			Pinned[i + 1] = true;
+			Targets[i + 2] = true;
+		}
+
+	// compact: drop unreachable chunks, redundant derefs and jumps to the next chunk, fold constants
+	std::vector<int32_t> NewPos(iCnt + 1), OldPos(iCnt);
+	std::vector<bool> NewTargets(iCnt);
+	int32_t iNewCnt = 0;
+	bool fReachable = true;
+	for (i = 0; i < iCnt; ++i)
+	{
+		NewPos[i] = iNewCnt;
+		if (Targets[i]) fReachable = true;
+		if (!fReachable) continue;
+		const C4AulBCC &rBCC = pCode[i];
+		if (rBCC.bccType == AB_DEREF && !Targets[i] && iNewCnt && PushesValue(pCode[iNewCnt - 1].bccType)) continue;
+		if (rBCC.bccType == AB_JUMP && rBCC.bccX == 1 && !Pinned[i]) continue;
+		if (rBCC.bccType == AB_JUMP || rBCC.bccType == AB_RETURN) fReachable = false;
+		OldPos[iNewCnt] = i;
+		NewTargets[iNewCnt] = Targets[i];
+		pCode[iNewCnt++] = rBCC;
+		while (FoldConstants(pCode, iNewCnt, NewTargets));
+	}
+	NewPos[iCnt] = iNewCnt;
+
+	// relocate jumps
+	for (i = 0; i < iNewCnt; ++i)
+		if (IsJump(pCode[i].bccType))
+			pCode[i].bccX = NewPos[OldPos[i] + pCode[i].bccX] - i;
+
+	CodeSize = iStart + iNewCnt;
+	CPos = Code + CodeSize;
+
+	if (Config.Developer.DumpScriptBytecode)
+	{
+		LogSilentF("%s (optimized, %d of %d chunks):", Fn->Name, static_cast<int>(iNewCnt), static_cast<int>(iCnt));
+		for (i = 0; i < iNewCnt; ++i) DumpBCC(pCode[i]);
+	}
+}
+
 void C4AulScript::ParseDescs()
 {
 	// parse children
@@ -238,7 +238,8 @@ void C4Command::MoveTo()
 					{
 						Game.PathFinder.EnableTransferZones(!cObj->Def->NoTransferZones);
 						Game.PathFinder.SetLevel(cObj->Def->Pathfinder);
-						if (!Game.PathFinder.Find(cObj->x, cObj->y,
+						Game.PathFinder.SetNavGraph(cObj->Def->PathfinderGraph);
+						if (!Game.PathFinder.FindShared(cObj->x, cObj->y,
 							Tx._getInt(), Ty,
 							&ObjectAddWaypoint,
 							reinterpret_cast<intptr_t>(cObj))) // intptr for 64bit?
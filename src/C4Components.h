@@ -100,6 +100,9 @@
 #define C4CFN_PlayerInfos      "PlayerInfos.txt"
 #define C4CFN_SavePlayerInfos  "SavePlayerInfos.txt"
 #define C4CFN_RecPlayerInfos   "RecPlayerInfos.txt"
+#define C4CFN_RecKeyframe      "Keyframe%d.c4g"
+#define C4CFN_RecKeyframeFiles "Keyframe*.c4g"
+#define C4CFN_RecKeyframes     "Keyframes.txt"
 #define C4CFN_Teams            "Teams.txt"
 #define C4CFN_Parameters       "Parameters.txt"
 #define C4CFN_RoundResults     "RoundResults.txt"
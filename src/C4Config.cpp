@@ -87,6 +87,7 @@ void C4ConfigGeneral::CompileFunc(StdCompiler *pComp)
 #endif
 	pComp->Value(mkNamingAdapt(FPS,              "FPS",              false,         false, true));
 	pComp->Value(mkNamingAdapt(Record,           "Record",           false,         false, true));
+	pComp->Value(mkNamingAdapt(RecordKeyframes,  "RecordKeyframes",  false,         false, true));
 	pComp->Value(mkNamingAdapt(ScreenshotFolder, "ScreenshotFolder", "Screenshots", false, true));
 	pComp->Value(mkNamingAdapt(FairCrew,         "NoCrew",           false,         false, true));
 	pComp->Value(mkNamingAdapt(FairCrewStrength, "DefCrewStrength",  1000,          false, true));
@@ -109,7 +110,8 @@ void C4ConfigGeneral::CompileFunc(StdCompiler *pComp)
 
 void C4ConfigDeveloper::CompileFunc(StdCompiler *pComp)
 {
-	pComp->Value(mkNamingAdapt(AutoFileReload, "AutoFileReload", true, false, true));
+	pComp->Value(mkNamingAdapt(AutoFileReload,     "AutoFileReload",     true,  false, true));
+	pComp->Value(mkNamingAdapt(DumpScriptBytecode, "DumpScriptBytecode", false, false, true));
 }
 
 #ifdef C4ENGINE
@@ -61,6 +61,7 @@ public:
 	char MissionAccess[CFG_MaxString + 1];
 	bool FPS;
 	bool Record;
+	bool RecordKeyframes; // if set: synchronize periodically in local games to save seekable game states into records
 	bool MMTimer;    // use multimedia-timers
 	bool FairCrew;   // don't use permanent crew physicals
 	int32_t FairCrewStrength; // strength of clonks in fair crew mode
@@ -93,6 +94,7 @@ class C4ConfigDeveloper
 {
 public:
 	bool AutoFileReload;
+	bool DumpScriptBytecode; // log byte code of parsed script functions before and after optimization
 	void CompileFunc(StdCompiler *pComp);
 };
 
@@ -191,6 +191,7 @@ void C4DefCore::Default()
 	DragImagePicture = 0;
 	VehicleControl = 0;
 	Pathfinder = 0;
+	PathfinderGraph = 0;
 	NoComponentMass = 0;
 	MoveToRange = 0;
 	NoStabilize = 0;
@@ -408,6 +409,7 @@ void C4DefCore::CompileFunc(StdCompiler *pComp)
 	pComp->Value(mkNamingAdapt(DragImagePicture,          "DragImagePicture",   0));
 	pComp->Value(mkNamingAdapt(VehicleControl,            "VehicleControl",     0));
 	pComp->Value(mkNamingAdapt(Pathfinder,                "Pathfinder",         0));
+	pComp->Value(mkNamingAdapt(PathfinderGraph,           "PathfinderGraph",    0));
 	pComp->Value(mkNamingAdapt(MoveToRange,               "MoveToRange",        0));
 	pComp->Value(mkNamingAdapt(NoComponentMass,           "NoComponentMass",    0));
 	pComp->Value(mkNamingAdapt(NoStabilize,               "NoStabilize",        0));
@@ -1405,6 +1407,33 @@ void C4DefList::BuildTable()
 	SortByID();
 }
 
+void C4DefList::PackGraphics()
+{
+	// collect all small graphics
+	std::vector<C4DefGraphics *> Graphics;
+	for (C4Def *pDef = FirstDef; pDef; pDef = pDef->Next)
+		for (C4DefGraphics *pGfx = &pDef->Graphics; pGfx; pGfx = pGfx->GetNext())
+			if (pGfx->Bitmap && pGfx->Bitmap->Wdt <= CTexAtlas::MaxSurfaceSize && pGfx->Bitmap->Hgt <= CTexAtlas::MaxSurfaceSize)
+				Graphics.push_back(pGfx);
+	if (Graphics.empty()) return;
+	// highest first, so shelves are filled evenly
+	std::stable_sort(Graphics.begin(), Graphics.end(), [](C4DefGraphics *pGfx1, C4DefGraphics *pGfx2)
+	{
+		return pGfx1->Bitmap->Hgt > pGfx2->Bitmap->Hgt;
+	});
+	if (!pTexAtlas) pTexAtlas = new CTexAtlas();
+	for (C4DefGraphics *pGfx : Graphics)
+	{
+		// ColorByOwner-surfaces must move along with their main surface
+		pTexAtlas->Add(pGfx->Bitmap, pGfx->BitmapClr);
+	}
+	// upload pages
+	pTexAtlas->Commit();
+	CTexAtlas::DeleteIfEmpty();
+	if (!pTexAtlas) return;
+	LogSilentF("%s", pTexAtlas->GetStats().getData());
+}
+
 bool C4Def::LoadPortraits(C4Group &hGroup)
 {
 #ifdef C4ENGINE
@@ -243,6 +243,7 @@ public:
 	int32_t DragImagePicture;
 	int32_t VehicleControl;
 	int32_t Pathfinder;
+	int32_t PathfinderGraph; // search a navigation graph instead of launching rays: 1 surfaces and walls (walking and climbing), 2 free space (flying)
 	int32_t MoveToRange;
 	int32_t Timer;
 	int32_t NoComponentMass;
@@ -409,6 +410,7 @@ public:
 	bool Reload(C4Def *pDef, uint32_t dwLoadWhat, const char *szLanguage, C4SoundSystem *pSoundSystem = nullptr);
 	bool Add(C4Def *ndef, bool fOverload);
 	void BuildTable(); // build quick access table
+	void PackGraphics(); // move small graphics into shared textures
 	void ResetIncludeDependencies(); // resets all pointers into foreign definitions caused by include chains
 #ifdef C4ENGINE
 	void Synchronize();
@@ -321,10 +321,14 @@ void C4Effect::Execute(C4Object *pObj)
 			// execute effect: time elapsed
 			++pEffect->iTime;
 			// check timer execution
-			if (pEffect->iIntervall && !(pEffect->iTime % pEffect->iIntervall))
+			if (pEffect->iIntervall && !((pEffect->iTime + pEffect->GetTimerPhase()) % pEffect->iIntervall))
 				if (pEffect->pFnTimer)
 				{
-					if (pEffect->pFnTimer->Exec(pEffect->pCommandTarget, {C4VObj(pObj), C4VInt(pEffect->iNumber), C4VInt(pEffect->iTime)}).getInt() == C4Fx_Execute_Kill)
+					const auto tStart = C4TimerStats::Clock::now();
+					const C4ID idTarget = pEffect->pCommandTarget ? pEffect->pCommandTarget->id : pEffect->idCommandTarget;
+					const int32_t iResult = pEffect->pFnTimer->Exec(pEffect->pCommandTarget, {C4VObj(pObj), C4VInt(pEffect->iNumber), C4VInt(pEffect->iTime)}).getInt();
+					Game.TimerStats.Stop(tStart, idTarget, pEffect->pFnTimer->Name);
+					if (iResult == C4Fx_Execute_Kill)
 					{
 						// safety: this class got deleted!
 						if (pObj && !pObj->Status) return;
@@ -344,6 +348,13 @@ void C4Effect::Execute(C4Object *pObj)
 	} while (pEffect);
 }
 
+int32_t C4Effect::GetTimerPhase()
+{
+	// effects without timer function keep their exact duration
+	if (!Game.C4S.Game.DistributeTimers || !pFnTimer || !iIntervall) return 0;
+	return iNumber % iIntervall;
+}
+
 void C4Effect::Kill(C4Object *pObj)
 {
 	// active?
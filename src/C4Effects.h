@@ -118,6 +118,7 @@ public:
 	C4AulScript *GetCallbackScript(); // get script context for effect callbacks
 
 	void Execute(C4Object *pObj); // execute all effects
+	int32_t GetTimerPhase(); // timer offset if effect timers are spread
 	void Kill(C4Object *pObj); // mark this effect deleted and do approprioate calls
 	void ClearAll(C4Object *pObj, int32_t iClearFlag); // kill all effects doing removal calls w/o reagard of inactive effects
 	void DoDamage(C4Object *pObj, int32_t &riDamage, int32_t iDamageType, int32_t iCausePlr); // ask all effects for damage
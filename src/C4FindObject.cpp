@@ -21,6 +21,9 @@
 #include <C4Game.h>
 #include <C4Wrappers.h>
 #include <C4Random.h>
+#include <C4FacetEx.h>
+
+#include <algorithm>
 
 // *** C4FindObject
 
@@ -157,6 +160,20 @@ C4FindObject *C4FindObject::CreateByValue(const C4Value &DataVal, C4SortObject *
 	return nullptr;
 }
 
+bool C4FindObject::RebindByValue(C4FindObject *pFO, const C4Value &DataVal)
+{
+	// Must be an array
+	C4ValueArray *pArray = C4Value(DataVal).getArray();
+	if (!pArray) return false;
+
+	const C4ValueArray &Data = *pArray;
+	// Trivial combinations are created as their condition
+	int32_t iType = Data[0].getInt();
+	if ((iType == C4FO_And || iType == C4FO_Or) && Data.GetSize() == 2)
+		return RebindByValue(pFO, Data[1]);
+	return pFO->Rebind(Data);
+}
+
 int32_t C4FindObject::Count(const C4ObjectList &Objs)
 {
 	// Trivial cases
@@ -407,32 +424,37 @@ bool C4FindObjectNot::Check(C4Object *pObj)
 	return !pCond->Check(pObj);
 }
 
+bool C4FindObjectNot::Rebind(const C4ValueArray &Data)
+{
+	return Data[0].getInt() == C4FO_Not && RebindByValue(pCond, Data[1]);
+}
+
 // *** C4FindObjectAnd
 
 C4FindObjectAnd::C4FindObjectAnd(int32_t inCnt, C4FindObject **ppConds, bool fFreeArray)
-	: iCnt(inCnt), ppConds(ppConds), fHasBounds(false), fUseShapes(false), fFreeArray(fFreeArray)
+	: iCnt(inCnt), ppConds(ppConds), fFreeArray(fFreeArray), iActiveCnt(0), ppActiveConds(new C4FindObject *[inCnt])
 {
+	UpdateConditions();
+}
+
+void C4FindObjectAnd::UpdateConditions()
+{
+	fHasBounds = fUseShapes = false;
 	// Filter ensured entries
 	int32_t i;
-	for (i = 0; i < iCnt;)
-		if (ppConds[i]->IsEnsured())
-		{
-			delete ppConds[i];
-			iCnt--;
-			for (int32_t j = i; j < iCnt; j++)
-				ppConds[j] = ppConds[j + 1];
-		}
-		else
-			i++;
-	// Intersect all child bounds
+	iActiveCnt = 0;
 	for (i = 0; i < iCnt; i++)
+		if (!ppConds[i]->IsEnsured())
+			ppActiveConds[iActiveCnt++] = ppConds[i];
+	// Intersect all child bounds
+	for (i = 0; i < iActiveCnt; i++)
 	{
-		C4Rect *pChildBounds = ppConds[i]->GetBounds();
+		C4Rect *pChildBounds = ppActiveConds[i]->GetBounds();
 		if (pChildBounds)
 		{
 			// some objects might be in an rect and at a point not in that rect
 			// so do not intersect an atpoint bound with an rect bound
-			fUseShapes = ppConds[i]->UseShapes();
+			fUseShapes = ppActiveConds[i]->UseShapes();
 			if (fUseShapes)
 			{
 				Bounds = *pChildBounds;
@@ -456,50 +478,62 @@ C4FindObjectAnd::~C4FindObjectAnd()
 		delete ppConds[i];
 	if (fFreeArray)
 		delete[] ppConds;
+	delete[] ppActiveConds;
 }
 
 bool C4FindObjectAnd::Check(C4Object *pObj)
 {
-	for (int32_t i = 0; i < iCnt; i++)
-		if (!ppConds[i]->Check(pObj))
+	for (int32_t i = 0; i < iActiveCnt; i++)
+		if (!ppActiveConds[i]->Check(pObj))
 			return false;
 	return true;
 }
 
 bool C4FindObjectAnd::IsImpossible()
 {
-	for (int32_t i = 0; i < iCnt; i++)
-		if (ppConds[i]->IsImpossible())
+	for (int32_t i = 0; i < iActiveCnt; i++)
+		if (ppActiveConds[i]->IsImpossible())
 			return true;
 	return false;
 }
 
+bool C4FindObjectAnd::Rebind(const C4ValueArray &Data)
+{
+	// all conditions must have been created
+	if (Data[0].getInt() != C4FO_And || Data.GetSize() - 1 != iCnt) return false;
+	for (int32_t i = 0; i < iCnt; i++)
+		if (!RebindByValue(ppConds[i], Data[i + 1]))
+			return false;
+	UpdateConditions();
+	return true;
+}
+
 // *** C4FindObjectOr
 
 C4FindObjectOr::C4FindObjectOr(int32_t inCnt, C4FindObject **ppConds)
-	: iCnt(inCnt), ppConds(ppConds), fHasBounds(false)
+	: iCnt(inCnt), ppConds(ppConds), iActiveCnt(0), ppActiveConds(new C4FindObject *[inCnt])
+{
+	UpdateConditions();
+}
+
+void C4FindObjectOr::UpdateConditions()
 {
+	fHasBounds = false;
 	// Filter impossible entries
 	int32_t i;
-	for (i = 0; i < iCnt;)
-		if (ppConds[i]->IsImpossible())
-		{
-			delete ppConds[i];
-			iCnt--;
-			for (int32_t j = i; j < iCnt; j++)
-				ppConds[j] = ppConds[j + 1];
-		}
-		else
-			i++;
-	// Sum up all child bounds
+	iActiveCnt = 0;
 	for (i = 0; i < iCnt; i++)
+		if (!ppConds[i]->IsImpossible())
+			ppActiveConds[iActiveCnt++] = ppConds[i];
+	// Sum up all child bounds
+	for (i = 0; i < iActiveCnt; i++)
 	{
-		C4Rect *pChildBounds = ppConds[i]->GetBounds();
+		C4Rect *pChildBounds = ppActiveConds[i]->GetBounds();
 		if (!pChildBounds) { fHasBounds = false; break; }
 		// Do not optimize atpoint: It could lead to having to search multiple
 		// sectors. An object's shape can be in multiple sectors. We do not want
 		// to find the same object twice.
-		if (ppConds[i]->UseShapes())
+		if (ppActiveConds[i]->UseShapes())
 		{
 			fHasBounds = false; break;
 		}
@@ -518,24 +552,36 @@ C4FindObjectOr::~C4FindObjectOr()
 	for (int32_t i = 0; i < iCnt; i++)
 		delete ppConds[i];
 	delete[] ppConds;
+	delete[] ppActiveConds;
 }
 
 bool C4FindObjectOr::Check(C4Object *pObj)
 {
-	for (int32_t i = 0; i < iCnt; i++)
-		if (ppConds[i]->Check(pObj))
+	for (int32_t i = 0; i < iActiveCnt; i++)
+		if (ppActiveConds[i]->Check(pObj))
 			return true;
 	return false;
 }
 
 bool C4FindObjectOr::IsEnsured()
 {
-	for (int32_t i = 0; i < iCnt; i++)
-		if (ppConds[i]->IsEnsured())
+	for (int32_t i = 0; i < iActiveCnt; i++)
+		if (ppActiveConds[i]->IsEnsured())
 			return true;
 	return false;
 }
 
+bool C4FindObjectOr::Rebind(const C4ValueArray &Data)
+{
+	// all conditions must have been created
+	if (Data[0].getInt() != C4FO_Or || Data.GetSize() - 1 != iCnt) return false;
+	for (int32_t i = 0; i < iCnt; i++)
+		if (!RebindByValue(ppConds[i], Data[i + 1]))
+			return false;
+	UpdateConditions();
+	return true;
+}
+
 // *** C4FindObject* (primitive conditions)
 
 bool C4FindObjectExclude::Check(C4Object *pObj)
@@ -543,6 +589,13 @@ bool C4FindObjectExclude::Check(C4Object *pObj)
 	return pObj != pExclude;
 }
 
+bool C4FindObjectExclude::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_Exclude) return false;
+	pExclude = Data[1].getObj();
+	return true;
+}
+
 bool C4FindObjectID::Check(C4Object *pObj)
 {
 	return pObj->id == id;
@@ -554,6 +607,13 @@ bool C4FindObjectID::IsImpossible()
 	return !pDef || !pDef->Count;
 }
 
+bool C4FindObjectID::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_ID) return false;
+	id = Data[1].getC4ID();
+	return true;
+}
+
 bool C4FindObjectInRect::Check(C4Object *pObj)
 {
 	return rect.Contains(pObj->x, pObj->y);
@@ -564,11 +624,25 @@ bool C4FindObjectInRect::IsImpossible()
 	return !rect.Wdt || !rect.Hgt;
 }
 
+bool C4FindObjectInRect::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_InRect) return false;
+	rect = C4Rect(Data[1].getInt(), Data[2].getInt(), Data[3].getInt(), Data[4].getInt());
+	return true;
+}
+
 bool C4FindObjectAtPoint::Check(C4Object *pObj)
 {
 	return pObj->Shape.Contains(bounds.x - pObj->x, bounds.y - pObj->y);
 }
 
+bool C4FindObjectAtPoint::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_AtPoint) return false;
+	bounds = C4Rect(Data[1].getInt(), Data[2].getInt(), 1, 1);
+	return true;
+}
+
 bool C4FindObjectAtRect::Check(C4Object *pObj)
 {
 	C4Rect rcShapeBounds = pObj->Shape;
@@ -576,16 +650,42 @@ bool C4FindObjectAtRect::Check(C4Object *pObj)
 	return !!rcShapeBounds.Overlap(bounds);
 }
 
+bool C4FindObjectAtRect::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_AtRect) return false;
+	bounds = C4Rect(Data[1].getInt(), Data[2].getInt(), Data[3].getInt(), Data[4].getInt());
+	return true;
+}
+
 bool C4FindObjectOnLine::Check(C4Object *pObj)
 {
 	return pObj->Shape.IntersectsLine(x - pObj->x, y - pObj->y, x2 - pObj->x, y2 - pObj->y);
 }
 
+bool C4FindObjectOnLine::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_OnLine) return false;
+	x = Data[1].getInt(); y = Data[2].getInt(); x2 = Data[3].getInt(); y2 = Data[4].getInt();
+	bounds = C4Rect(x, y, 1, 1);
+	bounds.Add(C4Rect(x2, y2, 1, 1));
+	return true;
+}
+
 bool C4FindObjectDistance::Check(C4Object *pObj)
 {
 	return (pObj->x - x) * (pObj->x - x) + (pObj->y - y) * (pObj->y - y) <= r2;
 }
 
+bool C4FindObjectDistance::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_Distance) return false;
+	x = Data[1].getInt(); y = Data[2].getInt();
+	const int32_t r = Data[3].getInt();
+	r2 = r * r;
+	bounds = C4Rect(x - r, y - r, 2 * r + 1, 2 * r + 1);
+	return true;
+}
+
 bool C4FindObjectOCF::Check(C4Object *pObj)
 {
 	return !!(pObj->OCF & ocf);
@@ -596,6 +696,13 @@ bool C4FindObjectOCF::IsImpossible()
 	return !ocf;
 }
 
+bool C4FindObjectOCF::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_OCF) return false;
+	ocf = Data[1].getInt();
+	return true;
+}
+
 bool C4FindObjectCategory::Check(C4Object *pObj)
 {
 	return !!(pObj->Category & iCategory);
@@ -606,11 +713,27 @@ bool C4FindObjectCategory::IsEnsured()
 	return !iCategory;
 }
 
+bool C4FindObjectCategory::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_Category) return false;
+	iCategory = Data[1].getInt();
+	return true;
+}
+
 bool C4FindObjectAction::Check(C4Object *pObj)
 {
 	return SEqual(pObj->Action.Name, szAction);
 }
 
+bool C4FindObjectAction::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_Action) return false;
+	C4String *pStr = Data[1].getStr();
+	if (!pStr) return false;
+	szAction = pStr->Data.getData();
+	return true;
+}
+
 bool C4FindObjectActionTarget::Check(C4Object *pObj)
 {
 	assert(index >= 0 && index <= 1);
@@ -622,16 +745,36 @@ bool C4FindObjectActionTarget::Check(C4Object *pObj)
 		return false;
 }
 
+bool C4FindObjectActionTarget::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_ActionTarget) return false;
+	pActionTarget = Data[1].getObj();
+	index = Data.GetSize() >= 3 ? BoundBy(Data[2].getInt(), 0, 1) : 0;
+	return true;
+}
+
 bool C4FindObjectContainer::Check(C4Object *pObj)
 {
 	return pObj->Contained == pContainer;
 }
 
+bool C4FindObjectContainer::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_Container) return false;
+	pContainer = Data[1].getObj();
+	return true;
+}
+
 bool C4FindObjectAnyContainer::Check(C4Object *pObj)
 {
 	return !!pObj->Contained;
 }
 
+bool C4FindObjectAnyContainer::Rebind(const C4ValueArray &Data)
+{
+	return Data[0].getInt() == C4FO_AnyContainer;
+}
+
 bool C4FindObjectOwner::Check(C4Object *pObj)
 {
 	return pObj->Owner == iOwner;
@@ -642,6 +785,13 @@ bool C4FindObjectOwner::IsImpossible()
 	return iOwner != NO_OWNER && !ValidPlr(iOwner);
 }
 
+bool C4FindObjectOwner::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_Owner) return false;
+	iOwner = Data[1].getInt();
+	return true;
+}
+
 bool C4FindObjectController::Check(C4Object *pObj)
 {
 	return pObj->Controller == controller;
@@ -652,6 +802,13 @@ bool C4FindObjectController::IsImpossible()
 	return controller != NO_OWNER && !ValidPlr(controller);
 }
 
+bool C4FindObjectController::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_Controller) return false;
+	controller = Data[1].getInt();
+	return true;
+}
+
 // *** C4FindObjectFunc
 
 C4FindObjectFunc::C4FindObjectFunc(const char *szFunc)
@@ -683,6 +840,18 @@ bool C4FindObjectFunc::IsImpossible()
 	return !pFunc;
 }
 
+bool C4FindObjectFunc::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_Func) return false;
+	C4String *pStr = Data[1].getStr();
+	if (!pStr) return false;
+	pFunc = Game.ScriptEngine.GetFirstFunc(pStr->Data.getData());
+	Pars = C4AulParSet{};
+	for (int i = 2; i < Data.GetSize(); i++)
+		SetPar(i - 2, Data[i]);
+	return true;
+}
+
 // *** C4FindObjectLayer
 
 bool C4FindObjectLayer::Check(C4Object *pObj)
@@ -695,6 +864,13 @@ bool C4FindObjectLayer::IsImpossible()
 	return false;
 }
 
+bool C4FindObjectLayer::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4FO_Layer) return false;
+	pLayer = Data[1].getObj();
+	return true;
+}
+
 // *** C4SortObject
 
 C4SortObject *C4SortObject::CreateByValue(const C4Value &DataVal)
@@ -776,6 +952,18 @@ C4SortObject *C4SortObject::CreateByValue(int32_t iType, const C4ValueArray &Dat
 	return nullptr;
 }
 
+bool C4SortObject::RebindByValue(C4SortObject *pSO, const C4Value &DataVal)
+{
+	// Must be an array
+	const C4ValueArray *pArray = C4Value(DataVal).getArray();
+	if (!pArray) return false;
+	const C4ValueArray &Data = *pArray;
+	// Trivial combination is created as its sort
+	if (Data[0].getInt() == C4SO_Multiple && Data.GetSize() == 2)
+		return RebindByValue(pSO, Data[1]);
+	return pSO->Rebind(Data);
+}
+
 void C4SortObject::SortObjects(C4ValueArray *pArray)
 {
 	pArray->Sort(*this);
@@ -840,6 +1028,11 @@ int32_t C4SortObjectReverse::CompareCache(int32_t iObj1, int32_t iObj2, C4Object
 	return pSort->CompareCache(iObj2, iObj1, pObj2, pObj1);
 }
 
+bool C4SortObjectReverse::Rebind(const C4ValueArray &Data)
+{
+	return Data[0].getInt() == C4SO_Reverse && RebindByValue(pSort, Data[1]);
+}
+
 C4SortObjectMultiple::~C4SortObjectMultiple()
 {
 	for (int32_t i = 0; i < iCnt; ++i) delete ppSorts[i];
@@ -877,32 +1070,69 @@ int32_t C4SortObjectMultiple::CompareCache(int32_t iObj1, int32_t iObj2, C4Objec
 	return 0;
 }
 
+bool C4SortObjectMultiple::Rebind(const C4ValueArray &Data)
+{
+	// all sorts must have been created
+	if (Data[0].getInt() != C4SO_Multiple || Data.GetSize() - 1 != iCnt) return false;
+	for (int32_t i = 0; i < iCnt; ++i)
+		if (!RebindByValue(ppSorts[i], Data[i + 1]))
+			return false;
+	return true;
+}
+
 int32_t C4SortObjectDistance::CompareGetValue(C4Object *pFor)
 {
 	int32_t dx = pFor->x - iX, dy = pFor->y - iY;
 	return dx * dx + dy * dy;
 }
 
+bool C4SortObjectDistance::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4SO_Distance) return false;
+	iX = Data[1].getInt(); iY = Data[2].getInt();
+	return true;
+}
+
 int32_t C4SortObjectRandom::CompareGetValue(C4Object *pFor)
 {
 	return Random(1 << 16);
 }
 
+bool C4SortObjectRandom::Rebind(const C4ValueArray &Data)
+{
+	return Data[0].getInt() == C4SO_Random;
+}
+
 int32_t C4SortObjectSpeed::CompareGetValue(C4Object *pFor)
 {
 	return pFor->xdir * pFor->xdir + pFor->ydir * pFor->ydir;
 }
 
+bool C4SortObjectSpeed::Rebind(const C4ValueArray &Data)
+{
+	return Data[0].getInt() == C4SO_Speed;
+}
+
 int32_t C4SortObjectMass::CompareGetValue(C4Object *pFor)
 {
 	return pFor->Mass;
 }
 
+bool C4SortObjectMass::Rebind(const C4ValueArray &Data)
+{
+	return Data[0].getInt() == C4SO_Mass;
+}
+
 int32_t C4SortObjectValue::CompareGetValue(C4Object *pFor)
 {
 	return pFor->GetValue(nullptr, NO_OWNER);
 }
 
+bool C4SortObjectValue::Rebind(const C4ValueArray &Data)
+{
+	return Data[0].getInt() == C4SO_Value;
+}
+
 C4SortObjectFunc::C4SortObjectFunc(const char *szFunc)
 {
 	pFunc = Game.ScriptEngine.GetFirstFunc(szFunc);
@@ -926,3 +1156,171 @@ int32_t C4SortObjectFunc::CompareGetValue(C4Object *pObj)
 	// Call
 	return pCallFunc->Exec(pObj, Pars).getInt();
 }
+
+bool C4SortObjectFunc::Rebind(const C4ValueArray &Data)
+{
+	if (Data[0].getInt() != C4SO_Func) return false;
+	C4String *pStr = Data[1].getStr();
+	if (!pStr) return false;
+	pFunc = Game.ScriptEngine.GetFirstFunc(pStr->Data.getData());
+	Pars = C4AulParSet{};
+	for (int i = 2; i < Data.GetSize(); i++)
+		SetPar(i - 2, Data[i]);
+	return true;
+}
+
+// *** C4FindObjectCache
+
+C4FindObjectCache::C4FindObjectCache()
+{
+	Default();
+}
+
+C4FindObjectCache::~C4FindObjectCache()
+{
+	Clear();
+}
+
+void C4FindObjectCache::Default()
+{
+	Built = Reused = LastBuilt = LastReused = 0;
+}
+
+void C4FindObjectCache::Clear()
+{
+	for (auto &[pCPos, rEntry] : Entries)
+	{
+		assert(!rEntry.fInUse);
+		delete rEntry.pFO;
+	}
+	Entries.clear();
+	Default();
+}
+
+C4FindObjectCache::Criteria::~Criteria()
+{
+	if (pEntry)
+		pEntry->fInUse = false;
+	else
+		delete pFO;
+}
+
+C4FindObjectCache::Criteria C4FindObjectCache::Get(C4AulContext *cthr, const C4Value *pPars, bool fSortAllowed)
+{
+	// Call site known? Nested searches from the same site (e.g. through Find_Func) need their own conditions
+	// Temporary scripts (e.g. from the console) are deleted after they ran, so their call sites are never reused
+	const C4AulBCC *pCPos = cthr->Caller && !cthr->Caller->TemporaryScript ? cthr->Caller->CPos : nullptr;
+	if (pCPos)
+	{
+		Entry &rEntry = Entries[pCPos];
+		if (!rEntry.fInUse)
+		{
+			if (rEntry.pFO && rEntry.fSortAllowed == fSortAllowed && Rebind(rEntry, pPars))
+				++Reused;
+			else
+			{
+				delete rEntry.pFO;
+				rEntry = Entry{};
+				rEntry.fSortAllowed = fSortAllowed;
+				if (!Create(rEntry, pPars))
+				{
+					Entries.erase(pCPos);
+					return Criteria(nullptr, nullptr);
+				}
+			}
+			rEntry.fInUse = true;
+			return Criteria(rEntry.pFO, &rEntry);
+		}
+	}
+	// Build conditions for this search only
+	Entry Temp;
+	Temp.fSortAllowed = fSortAllowed;
+	if (!Create(Temp, pPars)) return Criteria(nullptr, nullptr);
+	return Criteria(Temp.pFO, nullptr);
+}
+
+bool C4FindObjectCache::Create(Entry &rEntry, const C4Value *pPars)
+{
+	++Built;
+	// Read all parameters
+	std::vector<C4FindObject *> FOs;
+	std::vector<C4SortObject *> SOs;
+	for (int32_t i = 0; i < C4AUL_MAX_Par; i++)
+	{
+		const C4Value &Data = pPars[i].GetRefVal();
+		// No data given?
+		if (!Data) break;
+		// Construct
+		C4SortObject *pSO = nullptr;
+		C4FindObject *pFO = C4FindObject::CreateByValue(Data, rEntry.fSortAllowed ? &pSO : nullptr);
+		rEntry.ParConds.push_back(pFO);
+		rEntry.ParSorts.push_back(pSO);
+		if (pFO) FOs.push_back(pFO);
+		if (pSO) SOs.push_back(pSO);
+	}
+	// No criterions?
+	if (FOs.empty())
+	{
+		for (C4SortObject *pSO : SOs) delete pSO;
+		return false;
+	}
+	// create sort criterion
+	C4SortObject *pSO = nullptr;
+	if (SOs.size() == 1)
+		pSO = SOs[0];
+	else if (SOs.size() > 1)
+	{
+		C4SortObject **ppSorts = new C4SortObject *[SOs.size()];
+		std::copy(SOs.begin(), SOs.end(), ppSorts);
+		pSO = new C4SortObjectMultiple(SOs.size(), ppSorts);
+	}
+	// Create search object
+	if (FOs.size() == 1)
+		rEntry.pFO = FOs[0];
+	else
+	{
+		C4FindObject **ppConds = new C4FindObject *[FOs.size()];
+		std::copy(FOs.begin(), FOs.end(), ppConds);
+		rEntry.pFO = rEntry.pAnd = new C4FindObjectAnd(FOs.size(), ppConds);
+	}
+	if (pSO) rEntry.pFO->SetSort(pSO);
+	return true;
+}
+
+bool C4FindObjectCache::Rebind(Entry &rEntry, const C4Value *pPars)
+{
+	// Same parameters must have created conditions or sorts
+	size_t i;
+	for (i = 0; i < C4AUL_MAX_Par; i++)
+	{
+		const C4Value &Data = pPars[i].GetRefVal();
+		if (!Data) break;
+		if (i >= rEntry.ParConds.size()) return false;
+		if (rEntry.ParConds[i])
+		{
+			if (!C4FindObject::RebindByValue(rEntry.ParConds[i], Data)) return false;
+		}
+		else if (rEntry.ParSorts[i])
+		{
+			if (!C4SortObject::RebindByValue(rEntry.ParSorts[i], Data)) return false;
+		}
+		else
+			return false;
+	}
+	if (i != rEntry.ParConds.size()) return false;
+	// Conditions might have become ensured
+	if (rEntry.pAnd) rEntry.pAnd->UpdateConditions();
+	return true;
+}
+
+void C4FindObjectCache::NewFrame()
+{
+	LastBuilt = Built; LastReused = Reused;
+	Built = Reused = 0;
+}
+
+void C4FindObjectCache::DrawStatus(C4FacetEx &cgo)
+{
+	Application.DDraw->TextOut(FormatString("FindObjects: %d conditions built, %d reused", LastBuilt, LastReused).getData(),
+		Game.GraphicsResource.FontRegular, 1.0, cgo.Surface, cgo.X + 20, cgo.Y + cgo.Hgt - 150);
+}
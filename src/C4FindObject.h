@@ -21,6 +21,11 @@
 #include "C4Value.h"
 #include "C4Aul.h"
 
+#include <unordered_map>
+#include <vector>
+
+class C4FacetEx;
+
 // Condition map
 enum C4FindObjectCondID
 {
@@ -75,6 +80,7 @@ public:
 	virtual ~C4FindObject();
 
 	static C4FindObject *CreateByValue(const C4Value &Data, C4SortObject **ppSortObj = nullptr); // createFindObject or SortObject - if ppSortObj==nullptr, SortObject is not allowed
+	static bool RebindByValue(C4FindObject *pFO, const C4Value &Data); // apply new parameters to a condition created by CreateByValue; fails if they do not fit its structure
 
 	int32_t Count(const C4ObjectList &Objs); // Counts objects for which the condition is true
 	C4Object *Find(const C4ObjectList &Objs);   // Returns first object for which the condition is true
@@ -93,6 +99,7 @@ protected:
 	virtual bool UseShapes() { return false; }
 	virtual bool IsImpossible() { return false; }
 	virtual bool IsEnsured() { return false; }
+	virtual bool Rebind(const C4ValueArray &Data) { return false; }
 
 private:
 	void CheckObjectStatus(C4ValueArray *pArray);
@@ -113,6 +120,7 @@ protected:
 	virtual bool Check(C4Object *pObj) override;
 	virtual bool IsImpossible() override { return pCond->IsEnsured(); }
 	virtual bool IsEnsured() override { return pCond->IsImpossible(); }
+	virtual bool Rebind(const C4ValueArray &Data) override;
 };
 
 class C4FindObjectAnd : public C4FindObject
@@ -121,17 +129,21 @@ public:
 	C4FindObjectAnd(int32_t iCnt, C4FindObject **ppConds, bool fFreeArray = true);
 	virtual ~C4FindObjectAnd();
 
+	void UpdateConditions(); // filter conditions and update bounds after their parameters changed
+
 private:
 	int32_t iCnt;
 	C4FindObject **ppConds; bool fFreeArray; bool fUseShapes;
+	int32_t iActiveCnt; C4FindObject **ppActiveConds; // conditions that are not ensured
 	C4Rect Bounds; bool fHasBounds;
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
 	virtual C4Rect *GetBounds() override { return fHasBounds ? &Bounds : nullptr; }
 	virtual bool UseShapes() override { return fUseShapes; }
-	virtual bool IsEnsured() override { return !iCnt; }
+	virtual bool IsEnsured() override { return !iActiveCnt; }
 	virtual bool IsImpossible() override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 };
 
 class C4FindObjectOr : public C4FindObject
@@ -140,16 +152,20 @@ public:
 	C4FindObjectOr(int32_t iCnt, C4FindObject **ppConds);
 	virtual ~C4FindObjectOr();
 
+	void UpdateConditions(); // filter conditions and update bounds after their parameters changed
+
 private:
 	int32_t iCnt;
 	C4FindObject **ppConds;
+	int32_t iActiveCnt; C4FindObject **ppActiveConds; // conditions that are not impossible
 	C4Rect Bounds; bool fHasBounds;
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
 	virtual C4Rect *GetBounds() override { return fHasBounds ? &Bounds : nullptr; }
 	virtual bool IsEnsured() override;
-	virtual bool IsImpossible() override { return !iCnt; }
+	virtual bool IsImpossible() override { return !iActiveCnt; }
+	virtual bool Rebind(const C4ValueArray &Data) override;
 };
 
 // Primitive conditions
@@ -164,6 +180,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 };
 
 class C4FindObjectID : public C4FindObject
@@ -177,6 +194,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 	virtual bool IsImpossible() override;
 };
 
@@ -191,6 +209,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 	virtual C4Rect *GetBounds() override { return &rect; }
 	virtual bool IsImpossible() override;
 };
@@ -206,6 +225,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 	virtual C4Rect *GetBounds() override { return &bounds; }
 	virtual bool UseShapes() override { return true; }
 };
@@ -221,6 +241,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 	virtual C4Rect *GetBounds() override { return &bounds; }
 	virtual bool UseShapes() override { return true; }
 };
@@ -240,6 +261,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 	virtual C4Rect *GetBounds() override { return &bounds; }
 	virtual bool UseShapes() override { return true; }
 };
@@ -256,6 +278,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 	virtual C4Rect *GetBounds() override { return &bounds; }
 };
 
@@ -270,6 +293,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 	virtual bool IsImpossible() override;
 };
 
@@ -284,6 +308,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 	virtual bool IsEnsured() override;
 };
 
@@ -298,6 +323,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 };
 
 class C4FindObjectActionTarget : public C4FindObject
@@ -312,6 +338,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 };
 
 class C4FindObjectContainer : public C4FindObject
@@ -325,6 +352,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 };
 
 class C4FindObjectAnyContainer : public C4FindObject
@@ -334,6 +362,7 @@ public:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 };
 
 class C4FindObjectOwner : public C4FindObject
@@ -347,6 +376,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 	virtual bool IsImpossible() override;
 };
 
@@ -362,6 +392,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 	virtual bool IsImpossible() override;
 };
 
@@ -375,6 +406,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 	virtual bool IsImpossible() override;
 };
 
@@ -389,6 +421,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 	virtual bool IsImpossible() override;
 };
 
@@ -409,8 +442,12 @@ public:
 public:
 	static C4SortObject *CreateByValue(const C4Value &Data);
 	static C4SortObject *CreateByValue(int32_t iType, const C4ValueArray &Data);
+	static bool RebindByValue(C4SortObject *pSO, const C4Value &Data); // apply new parameters to a sort created by CreateByValue; fails if they do not fit its structure
 
 	void SortObjects(C4ValueArray *pArray);
+
+protected:
+	virtual bool Rebind(const C4ValueArray &Data) { return false; }
 };
 
 class C4SortObjectByValue : public C4SortObject
@@ -444,6 +481,7 @@ private:
 
 protected:
 	int32_t Compare(C4Object *pObj1, C4Object *pObj2) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 
 	virtual bool PrepareCache(const C4ValueList *pObjs) override;
 	virtual int32_t CompareCache(int32_t iObj1, int32_t iObj2, C4Object *pObj1, C4Object *pObj2) override;
@@ -463,6 +501,7 @@ private:
 
 protected:
 	int32_t Compare(C4Object *pObj1, C4Object *pObj2) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 
 	virtual bool PrepareCache(const C4ValueList *pObjs) override;
 	virtual int32_t CompareCache(int32_t iObj1, int32_t iObj2, C4Object *pObj1, C4Object *pObj2) override;
@@ -479,6 +518,7 @@ private:
 
 protected:
 	int32_t CompareGetValue(C4Object *pFor) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 };
 
 class C4SortObjectRandom : public C4SortObjectByValue // randomize order
@@ -488,6 +528,7 @@ public:
 
 protected:
 	int32_t CompareGetValue(C4Object *pFor) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 };
 
 class C4SortObjectSpeed : public C4SortObjectByValue // sort by object xdir/ydir
@@ -497,6 +538,7 @@ public:
 
 protected:
 	int32_t CompareGetValue(C4Object *pFor) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 };
 
 class C4SortObjectMass : public C4SortObjectByValue // sort by mass
@@ -506,6 +548,7 @@ public:
 
 protected:
 	int32_t CompareGetValue(C4Object *pFor) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 };
 
 class C4SortObjectValue : public C4SortObjectByValue // sort by value
@@ -515,6 +558,7 @@ public:
 
 protected:
 	int32_t CompareGetValue(C4Object *pFor) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
 };
 
 class C4SortObjectFunc : public C4SortObjectByValue // sort by script function
@@ -529,4 +573,54 @@ private:
 
 protected:
 	int32_t CompareGetValue(C4Object *pFor) override;
+	virtual bool Rebind(const C4ValueArray &Data) override;
+};
+
+// conditions built from the parameters of FindObjects and friends, kept per script call site
+// and reused with new parameters as long as they keep their structure
+class C4FindObjectCache
+{
+public:
+	C4FindObjectCache();
+	~C4FindObjectCache();
+
+protected:
+	struct Entry
+	{
+		C4FindObject *pFO = nullptr; // owns all conditions and sorts
+		C4FindObjectAnd *pAnd = nullptr; // combination of the parameters, if more than one
+		bool fSortAllowed = false;
+		std::vector<C4FindObject *> ParConds; // condition created from each parameter, if any
+		std::vector<C4SortObject *> ParSorts; // ...sort
+		bool fInUse = false;
+	};
+
+	std::unordered_map<const C4AulBCC *, Entry> Entries;
+	int32_t Built, Reused, LastBuilt, LastReused;
+
+public:
+	// conditions for one search, released at the end of the scope
+	class Criteria
+	{
+		C4FindObject *pFO;
+		Entry *pEntry; // nullptr if not cached
+
+	public:
+		Criteria(C4FindObject *pFO, Entry *pEntry) : pFO(pFO), pEntry(pEntry) {}
+		Criteria(const Criteria &) = delete;
+		~Criteria();
+
+		C4FindObject *operator->() const { return pFO; }
+		explicit operator bool() const { return pFO != nullptr; }
+	};
+
+	void Default();
+	void Clear();
+	Criteria Get(C4AulContext *cthr, const C4Value *pPars, bool fSortAllowed); // no conditions if none are valid
+	void NewFrame();
+	void DrawStatus(C4FacetEx &cgo);
+
+protected:
+	bool Create(Entry &rEntry, const C4Value *pPars);
+	bool Rebind(Entry &rEntry, const C4Value *pPars);
 };
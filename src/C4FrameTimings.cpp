@@ -0,0 +1,127 @@
+/*
+ * LegacyClonk
+ *
+ * Copyright (c) 2026, The LegacyClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Always-on timing of the game subsystems for the last frames */
+
+#include <C4Include.h>
+#include <C4FrameTimings.h>
+
+#include <algorithm>
+#include <vector>
+
+C4FrameTimings::C4FrameTimings() : Written(0)
+{
+	Clear();
+}
+
+void C4FrameTimings::Clear()
+{
+	Written = 0;
+	std::fill(std::begin(Current), std::end(Current), 0);
+	FrameStart = Clock::now();
+}
+
+void C4FrameTimings::BeginFrame()
+{
+	// sections of calls that did not execute a frame count for the next frame, the total does not
+	FrameStart = Clock::now();
+}
+
+void C4FrameTimings::Add(C4FrameTimingSection eSection, Clock::time_point tStart)
+{
+	Current[eSection] += static_cast<int32_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - tStart).count());
+}
+
+void C4FrameTimings::EndFrame(int32_t iFrameCounter)
+{
+	Frame &rFrame = History[Written % HistorySize];
+	rFrame.FrameCounter = iFrameCounter;
+	std::copy(std::begin(Current), std::end(Current), rFrame.Times);
+	rFrame.Times[FT_Total] = static_cast<int32_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - FrameStart).count());
+	++Written;
+	std::fill(std::begin(Current), std::end(Current), 0);
+}
+
+const char *C4FrameTimings::GetSectionName(C4FrameTimingSection eSection)
+{
+	static const char *szNames[FT_Count] =
+	{
+		"Network", "Control", "Objects", "Effects", "PXS", "Particles", "MassMover",
+		"Weather", "Landscape", "Players", "Music", "Messages", "Script", "Total"
+	};
+	return Inside<int32_t>(eSection, 0, FT_Count - 1) ? szNames[eSection] : "";
+}
+
+int32_t C4FrameTimings::GetFrames(Frame *pTarget, int32_t iMaxFrames) const
+{
+	const int32_t iCnt = static_cast<int32_t>((std::min)({Written, HistorySize, static_cast<uint32_t>(iMaxFrames)}));
+	for (int32_t i = 0; i < iCnt; ++i)
+		pTarget[i] = History[(Written - iCnt + i) % HistorySize];
+	return iCnt;
+}
+
+StdStrBuf C4FrameTimings::GetSummary() const
+{
+	std::vector<Frame> Frames(HistorySize);
+	const int32_t iCnt = GetFrames(Frames.data(), HistorySize);
+	StdStrBuf Buf;
+	Buf.Format("Frame timings of the last %d frames (p50 / p99 / max in ms):", iCnt);
+	if (!iCnt) return Buf;
+	std::vector<int32_t> Times(iCnt);
+	for (int32_t iSection = 0; iSection < FT_Count; ++iSection)
+	{
+		for (int32_t i = 0; i < iCnt; ++i) Times[i] = Frames[i].Times[iSection];
+		std::sort(Times.begin(), Times.end());
+		const int32_t iP50 = Times[(iCnt - 1) * 50 / 100], iP99 = Times[(iCnt - 1) * 99 / 100], iMax = Times.back();
+		Buf.AppendFormat("\n  %s: %d.%02d / %d.%02d / %d.%02d", GetSectionName(static_cast<C4FrameTimingSection>(iSection)),
+			iP50 / 1000, iP50 % 1000 / 10, iP99 / 1000, iP99 % 1000 / 10, iMax / 1000, iMax % 1000 / 10);
+	}
+	return Buf;
+}
+
+StdStrBuf C4FrameTimings::GetCSV() const
+{
+	std::vector<Frame> Frames(HistorySize);
+	const int32_t iCnt = GetFrames(Frames.data(), HistorySize);
+	StdStrBuf Buf;
+	Buf.Append("Frame");
+	for (int32_t iSection = 0; iSection < FT_Count; ++iSection)
+		Buf.AppendFormat(",%s", GetSectionName(static_cast<C4FrameTimingSection>(iSection)));
+	Buf.AppendChar('\n');
+	for (int32_t i = 0; i < iCnt; ++i)
+	{
+		Buf.AppendFormat("%d", Frames[i].FrameCounter);
+		for (int32_t iTime : Frames[i].Times) Buf.AppendFormat(",%d", iTime);
+		Buf.AppendChar('\n');
+	}
+	return Buf;
+}
+
+StdStrBuf C4FrameTimings::GetJSON() const
+{
+	std::vector<Frame> Frames(HistorySize);
+	const int32_t iCnt = GetFrames(Frames.data(), HistorySize);
+	StdStrBuf Buf;
+	Buf.Append("{\"unit\":\"us\",\"frames\":[");
+	for (int32_t i = 0; i < iCnt; ++i)
+	{
+		Buf.AppendFormat("%s\n{\"Frame\":%d", i ? "," : "", Frames[i].FrameCounter);
+		for (int32_t iSection = 0; iSection < FT_Count; ++iSection)
+			Buf.AppendFormat(",\"%s\":%d", GetSectionName(static_cast<C4FrameTimingSection>(iSection)), Frames[i].Times[iSection]);
+		Buf.AppendChar('}');
+	}
+	Buf.Append("\n]}\n");
+	return Buf;
+}
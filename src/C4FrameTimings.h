@@ -0,0 +1,77 @@
+/*
+ * LegacyClonk
+ *
+ * Copyright (c) 2026, The LegacyClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Always-on timing of the game subsystems for the last frames */
+
+#pragma once
+
+#include <StdBuf.h>
+
+#include <chrono>
+
+enum C4FrameTimingSection
+{
+	FT_Network = 0,
+	FT_Control,
+	FT_Objects,
+	FT_Effects,
+	FT_PXS,
+	FT_Particles,
+	FT_MassMover,
+	FT_Weather,
+	FT_Landscape,
+	FT_Players,
+	FT_Music,
+	FT_Messages,
+	FT_Script,
+	FT_Total, // game execution call that ran the frame
+	FT_Count
+};
+
+class C4FrameTimings
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static const uint32_t HistorySize = 1024; // frames kept; power of two
+
+	struct Frame
+	{
+		int32_t FrameCounter;
+		int32_t Times[FT_Count]; // microseconds
+	};
+
+	C4FrameTimings();
+
+protected:
+	// ring buffer of the last frames; not synchronized, so all access must happen in the main thread
+	Frame History[HistorySize];
+	uint32_t Written;
+	// frame being measured
+	int32_t Current[FT_Count];
+	Clock::time_point FrameStart;
+
+public:
+	void Clear();
+	void BeginFrame();
+	void Add(C4FrameTimingSection eSection, Clock::time_point tStart); // section started at tStart returned
+	void EndFrame(int32_t iFrameCounter);
+
+	static const char *GetSectionName(C4FrameTimingSection eSection);
+	int32_t GetFrames(Frame *pTarget, int32_t iMaxFrames) const; // copy most recent frames, oldest first (main thread only)
+	StdStrBuf GetSummary() const; // p50/p99/max per section
+	StdStrBuf GetCSV() const;
+	StdStrBuf GetJSON() const;
+};
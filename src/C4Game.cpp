@@ -118,6 +118,9 @@ bool C4Game::InitDefs()
 	// build quick access table
 	Defs.BuildTable();
 
+	// share textures between small graphics
+	Defs.PackGraphics();
+
 	// get default particles
 	Particles.SetDefParticles();
 
@@ -139,6 +142,17 @@ bool C4Game::OpenScenario()
 		SCopy(RecordFile.getData(), ScenarioFilename, _MAX_PATH);
 	}
 
+	// Replay seeking: start at the last keyframe before the target frame
+	if (RecordSeekFrame && !TempScenarioFile)
+	{
+		StdStrBuf RecordFile;
+		if (C4Playback::KeyframeToRecord(ScenarioFilename, RecordSeekFrame, &RecordFile))
+		{
+			SCopy(RecordFile.getData(), ScenarioFilename, _MAX_PATH);
+			TempScenarioFile = true;
+		}
+	}
+
 	// Scenario filename check & log
 	if (!ScenarioFilename[0]) { LogFatal(LoadResStr("IDS_PRC_NOC4S")); return false; }
 	LogF(LoadResStr("IDS_PRC_LOADC4S"), ScenarioFilename);
@@ -581,6 +595,7 @@ void C4Game::Clear()
 	C4S.Clear();
 	Weather.Clear();
 	GraphicsSystem.Clear();
+	FindObjectCache.Clear();
 	DeleteObjects(true);
 	Defs.Clear();
 	Landscape.Clear();
@@ -599,14 +614,19 @@ void C4Game::Clear()
 	GameText.Clear();
 	RecordDumpFile.Clear();
 	RecordStream.Clear();
+	RecordSeekFrame = 0;
 
 	PathFinder.Clear();
+	PathFinder.ClearGraph();
 	TransferZones.Clear();
+	TimerStats.Clear();
+	FrameTimings.Clear();
 #ifndef USE_CONSOLE
 	FontLoader.Clear();
 #endif
 
 	ScriptEngine.Clear();
+	ClearScriptFieldIndices();
 	MainSysLangStringTable.Clear();
 	ScenarioLangStringTable.Clear();
 	ScenarioSysLangStringTable.Clear();
@@ -748,14 +768,17 @@ C4ST_NEW(MusicSystemStat, "C4Game::Execute MusicSystem.Execute")
 C4ST_NEW(MessagesStat,    "C4Game::Execute Messages.Execute")
 C4ST_NEW(ScriptStat,      "C4Game::Execute Script.Execute")
 
-#define EXEC_S(Expressions, Stat) \
-	{ C4ST_START(Stat) Expressions C4ST_STOP(Stat) }
+#define EXEC_T(Expressions, Section) \
+	{ const auto tSectionStart = C4FrameTimings::Clock::now(); Expressions FrameTimings.Add(Section, tSectionStart); }
+
+#define EXEC_S(Expressions, Stat, Section) \
+	{ C4ST_START(Stat) EXEC_T(Expressions, Section) C4ST_STOP(Stat) }
 
 #ifdef DEBUGREC
-#define EXEC_S_DR(Expressions, Stat, DebugRecName) { AddDbgRec(RCT_Block, DebugRecName, 6); EXEC_S(Expressions, Stat) }
+#define EXEC_S_DR(Expressions, Stat, Section, DebugRecName) { AddDbgRec(RCT_Block, DebugRecName, 6); EXEC_S(Expressions, Stat, Section) }
 #define EXEC_DR(Expressions, DebugRecName) { AddDbgRec(RCT_Block, DebugRecName, 6); Expressions }
 #else
-#define EXEC_S_DR(Expressions, Stat, DebugRecName) EXEC_S(Expressions, Stat)
+#define EXEC_S_DR(Expressions, Stat, Section, DebugRecName) EXEC_S(Expressions, Stat, Section)
 #define EXEC_DR(Expressions, DebugRecName) Expressions
 #endif
 
@@ -763,13 +786,14 @@ bool C4Game::Execute() // Returns true if the game is over
 {
 	// Let's go
 	GameGo = true;
+	FrameTimings.BeginFrame();
 
 	// Network
-	Network.Execute();
+	EXEC_T(Network.Execute();, FT_Network)
 
 	// Prepare control
 	bool fControl;
-	EXEC_S(fControl = Control.Prepare();, ControlStat)
+	EXEC_S(fControl = Control.Prepare();, ControlStat, FT_Control)
 	if (!fControl) return false; // not ready yet: wait
 
 	// Halt
@@ -779,8 +803,13 @@ bool C4Game::Execute() // Returns true if the game is over
 	Landscape.DoRelights();
 #endif
 
+	// Paths are shared within one frame only
+	PathFinder.NewFrame();
+	TimerStats.NewFrame();
+	FindObjectCache.NewFrame();
+
 	// Execute the control
-	Control.Execute();
+	EXEC_T(Control.Execute();, FT_Control)
 	if (!IsRunning) return false;
 
 	// Ticks
@@ -793,19 +822,19 @@ bool C4Game::Execute() // Returns true if the game is over
 
 	// Game
 
-	EXEC_S(ExecObjects();, ExecObjectsStat)
+	EXEC_S(ExecObjects();, ExecObjectsStat, FT_Objects)
 	if (pGlobalEffects)
-		EXEC_S_DR(pGlobalEffects->Execute(nullptr);, GEStats, "GEEx\0");
-	EXEC_S_DR(PXS.Execute();,                      PXSStat,         "PXSEx")
-	EXEC_S_DR(Particles.GlobalParticles.Exec();,   PartStat,        "ParEx")
-	EXEC_S_DR(MassMover.Execute();,                MassMoverStat,   "MMvEx")
-	EXEC_S_DR(Weather.Execute();,                  WeatherStat,     "WtrEx")
-	EXEC_S_DR(Landscape.Execute();,                LandscapeStat,   "LdsEx")
-	EXEC_S_DR(Players.Execute();,                  PlayersStat,     "PlrEx")
+		EXEC_S_DR(pGlobalEffects->Execute(nullptr);, GEStats, FT_Effects, "GEEx\0");
+	EXEC_S_DR(PXS.Execute();,                      PXSStat,         FT_PXS,       "PXSEx")
+	EXEC_S_DR(Particles.Execute();,                PartStat,        FT_Particles, "ParEx")
+	EXEC_S_DR(MassMover.Execute();,                MassMoverStat,   FT_MassMover, "MMvEx")
+	EXEC_S_DR(Weather.Execute();,                  WeatherStat,     FT_Weather,   "WtrEx")
+	EXEC_S_DR(Landscape.Execute();,                LandscapeStat,   FT_Landscape, "LdsEx")
+	EXEC_S_DR(Players.Execute();,                  PlayersStat,     FT_Players,   "PlrEx")
 	// FIXME: C4Application::Execute should do this, but what about the stats?
-	EXEC_S_DR(Application.MusicSystem->Execute();, MusicSystemStat, "Music")
-	EXEC_S_DR(Messages.Execute();,                 MessagesStat,    "MsgEx")
-	EXEC_S_DR(Script.Execute();,                   ScriptStat,      "Scrpt")
+	EXEC_S_DR(Application.MusicSystem->Execute();, MusicSystemStat, FT_Music,     "Music")
+	EXEC_S_DR(Messages.Execute();,                 MessagesStat,    FT_Messages,  "MsgEx")
+	EXEC_S_DR(Script.Execute();,                   ScriptStat,      FT_Script,    "Scrpt")
 
 	EXEC_DR(MouseControl.Execute();, "Input")
 
@@ -813,6 +842,7 @@ bool C4Game::Execute() // Returns true if the game is over
 	GameOverCheck();, "Misc\0")
 
 	Control.DoSyncCheck();
+	FrameTimings.EndFrame(FrameCounter);
 
 	// Evaluation; Game over dlg
 	if (GameOver)
@@ -986,6 +1016,7 @@ void C4Game::ClearPointers(C4Object *pObj)
 	Console.ClearPointers(pObj);
 	MouseControl.ClearPointers(pObj);
 	TransferZones.ClearPointers(pObj);
+	PathFinder.ClearPointers(pObj);
 	if (pGlobalEffects)
 		pGlobalEffects->ClearPointers(pObj);
 }
@@ -1080,6 +1111,8 @@ C4Object *C4Game::NewObject(C4Def *pDef, C4Object *pCreator,
 	pObj->Init(pDef, pCreator, iOwner, pInfo, iX, iY, iR, xdir, ydir, rdir, iController);
 	// Enumerate object
 	pObj->Number = ++ObjectEnumerationIndex;
+	// Spread timer calls of objects created together
+	if (C4S.Game.DistributeTimers && pDef->Timer > 1) pObj->Timer = pObj->Number % pDef->Timer;
 	// Add to object list
 	if (!Objects.Add(pObj)) { delete pObj; return nullptr; }
 	// ---- From now on, object is ready to be used in scripts!
@@ -1701,6 +1734,7 @@ void C4Game::Default()
 	HaltCount = 0;
 	Evaluated = false;
 	Verbose = false;
+	RecordSeekFrame = 0;
 	TimeGo = false;
 	Time = 0;
 	StartTime = 0;
@@ -2318,6 +2352,9 @@ bool C4Game::InitGame(C4Group &hGroup, C4ScenarioSection *section, bool fLoadSky
 		if (Config.Developer.AutoFileReload && !Application.isFullScreen && !pFileMonitor)
 			pFileMonitor = new C4FileMonitor(FileMonitorCallback);
 
+		// script stack limits
+		C4AulSetMaxCallDepth(C4S.Game.MaxScriptCallDepth);
+
 		CStdLock lock{&Game.PreloadMutex};
 		if (!InitGameFirstPart())
 		{
@@ -2550,6 +2587,7 @@ bool C4Game::InitGameSecondPart(C4Group &hGroup, C4ScenarioSection *section, boo
 
 	// Pathfinder
 	if (!section) PathFinder.Init(&LandscapeFree, &TransferZones);
+	else PathFinder.ClearGraph();
 	SetInitProgress(90);
 
 	// PXS
@@ -3066,6 +3104,9 @@ void C4Game::ParseCommandLine(const char *szCmdLine)
 		// record stream
 		if (SEqual2NoCase(szParameter, "/stream:"))
 			RecordStream.Copy(szParameter + 8);
+		// record seek
+		if (SEqual2NoCase(szParameter, "/seek:"))
+			RecordSeekFrame = std::max(0, atoi(szParameter + 6));
 		// startup start screen
 		if (SEqual2NoCase(szParameter, "/startup:"))
 			C4Startup::SetStartScreen(szParameter + 9);
@@ -40,6 +40,9 @@
 #include <C4PlayerInfo.h>
 #include <C4Control.h>
 #include <C4PathFinder.h>
+#include <C4TimerStats.h>
+#include <C4FindObject.h>
+#include <C4FrameTimings.h>
 #include <C4ComponentHost.h>
 #include <C4ScriptHost.h>
 #include <C4Particles.h>
@@ -123,6 +126,9 @@ public:
 
 	C4PathFinder PathFinder;
 	C4TransferZones TransferZones;
+	C4TimerStats TimerStats;
+	C4FindObjectCache FindObjectCache;
+	C4FrameTimings FrameTimings;
 	C4Group ScenarioFile;
 	C4GroupSet GroupSet;
 	C4Group *pParentGroup;
@@ -158,6 +164,7 @@ public:
 	bool Verbose; // default false; set to true only by command line
 	StdStrBuf RecordDumpFile;
 	StdStrBuf RecordStream;
+	int32_t RecordSeekFrame; // replay: frame to fast-forward to
 	bool TempScenarioFile;
 	bool fPreinited; // set after PreInit has been called; unset by Clear and Default
 	int32_t FrameCounter;
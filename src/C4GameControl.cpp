@@ -129,6 +129,11 @@ void C4GameControl::OnGameSynchronizing()
 		fRecordNeeded = false;
 		StartRecord(false, false);
 	}
+	// otherwise, save record keyframe if due
+	else if (pRecord && pRecord->IsKeyframeDue(Game.FrameCounter))
+		if (!pRecord->SaveKeyframe())
+			Log("Record: Could not save keyframe!");
+	fKeyframeRequested = false;
 }
 
 bool C4GameControl::StartRecord(bool fInitial, bool fStreaming)
@@ -222,6 +227,7 @@ void C4GameControl::Default()
 	SyncRate = C4SyncCheckRate;
 	DoSync = false;
 	fRecordNeeded = false;
+	fKeyframeRequested = false;
 	pExecutingControl = nullptr;
 }
 
@@ -324,6 +330,21 @@ void C4GameControl::Ticks()
 	if (!(Game.FrameCounter % SyncRate))
 		DoSync = true;
 
+	// request sync for next record keyframe
+	// (network games only save keyframes at sync points that happen anyway, as a sync stalls all clients)
+	if (pRecord && fHost && !isNetwork() && Config.General.RecordKeyframes && !fKeyframeRequested && pRecord->IsKeyframeDue(Game.FrameCounter))
+	{
+		fKeyframeRequested = true;
+		DoInput(CID_Synchronize, new C4ControlSynchronize(false, false), CDT_Queue);
+	}
+
+	// replay seeking: fast-forward without drawing
+	if (eMode == CM_Replay && Game.FrameCounter < Game.RecordSeekFrame)
+	{
+		Game.GameGo = true;
+		Game.DoSkipFrame = true;
+	}
+
 	// calc next tick without waiting for timer? (catchup cases)
 	if (eMode == CM_Network)
 		if (Network.CtrlOverflow(ControlTick))
@@ -74,6 +74,7 @@ protected:
 	bool fHost; // (set for local, too)
 	bool fActivated;
 	bool fRecordNeeded;
+	bool fKeyframeRequested; // sync for next record keyframe requested
 	int32_t iClientID;
 
 	C4Record *pRecord;
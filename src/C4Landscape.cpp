@@ -37,10 +37,13 @@
 #include <C4Wrappers.h>
 
 #include <StdBitmap.h>
+#include <StdParallel.h>
 #include <StdPNG.h>
 
+#include <array>
 #include <memory>
 #include <stdexcept>
+#include <vector>
 
 int32_t MVehic = MNone, MTunnel = MNone, MWater = MNone, MSnow = MNone, MEarth = MNone, MGranite = MNone;
 uint8_t MCVehic = 0;
@@ -275,14 +278,14 @@ int32_t C4Landscape::ChunkyRandom(int32_t &iOffset, int32_t iRange)
 	return (iOffset ^ MapSeed) % iRange;
 }
 
-void C4Landscape::DrawChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t mcol, int32_t iChunkType, int32_t cro)
+void C4Landscape::DrawChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t mcol, int32_t iChunkType, int32_t cro, int32_t iBandY, int32_t iBandY2)
 {
 	uint8_t top_rough; uint8_t side_rough;
 	// what to do?
 	switch (iChunkType)
 	{
 	case C4M_Flat:
-		Surface8->Box(tx, ty, tx + wdt, ty + hgt, mcol);
+		Surface8->Box(tx, (std::max)(ty, iBandY), tx + wdt, (std::min)(ty + hgt, iBandY2), mcol);
 		return;
 	case C4M_TopFlat:
 		top_rough = 0; side_rough = 1;
@@ -306,10 +309,10 @@ void C4Landscape::DrawChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, in
 	vtcs[12] = tx + wdt + ChunkyRandom(cro, rx / 2);          vtcs[13] = ty - ChunkyRandom(cro, rx / 2 * top_rough);
 	vtcs[14] = tx + wdt / 2;                                  vtcs[15] = ty - ChunkyRandom(cro, rx * top_rough);
 
-	Surface8->Polygon(8, vtcs, mcol);
+	Surface8->Polygon(8, vtcs, mcol, iBandY, iBandY2);
 }
 
-void C4Landscape::DrawSmoothOChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t mcol, uint8_t flip, int32_t cro)
+void C4Landscape::DrawSmoothOChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t mcol, uint8_t flip, int32_t cro, int32_t iBandY, int32_t iBandY2)
 {
 	int vtcs[8];
 	int32_t rx = (std::max)(wdt / 2, 1);
@@ -328,76 +331,65 @@ void C4Landscape::DrawSmoothOChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t
 		vtcs[6] = tx + wdt / 2; vtcs[7] = ty + hgt / 3;
 	}
 
-	Surface8->Polygon(4, vtcs, mcol);
+	Surface8->Polygon(4, vtcs, mcol, iBandY, iBandY2);
 }
 
-void C4Landscape::ChunkOZoom(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, int32_t iTexture, int32_t iOffX, int32_t iOffY)
+void C4Landscape::ChunkOZoom(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, const uint32_t *dwpTextureUsage, int32_t iOffX, int32_t iOffY, int32_t iBandY, int32_t iBandY2)
 {
-	int32_t iX, iY, iChunkWidth, iChunkHeight, iToX, iToY;
-	int32_t iIFT;
+	struct ChunkOp
+	{
+		int32_t iX, iY;
+		uint8_t byColor;
+		int8_t iSmoothFlip; // -1 for full chunk
+	};
+	int32_t iX, iY, iTexture, iChunkWidth, iChunkHeight;
 	uint8_t byMapPixel, byMapPixelBelow;
 	int iMapWidth, iMapHeight;
-	C4Material *pMaterial = Game.TextureMap.GetEntry(iTexture)->GetMaterial();
-	if (!pMaterial) return;
-	int32_t iChunkType = pMaterial->MapChunkType;
-	uint8_t byColor = MatTex2PixCol(iTexture);
-	// Get map & landscape size
+	// Get materials of used textures
+	C4Material *pMaterials[C4M_MaxTexIndex]{};
+	for (iTexture = 1; iTexture < C4M_MaxTexIndex; iTexture++)
+		if (dwpTextureUsage[iTexture] > 0)
+			pMaterials[iTexture] = Game.TextureMap.GetEntry(iTexture)->GetMaterial();
+	// Get map size
 	sfcMap->GetSurfaceSize(iMapWidth, iMapHeight);
-	// Clip desired map segment to map size
-	iMapX = BoundBy<int32_t>(iMapX, 0, iMapWidth - 1); iMapY = BoundBy<int32_t>(iMapY, 0, iMapHeight - 1);
-	iMapWdt = BoundBy<int32_t>(iMapWdt, 0, iMapWidth - iMapX); iMapHgt = BoundBy<int32_t>(iMapHgt, 0, iMapHeight - iMapY);
 	// get chunk size
 	iChunkWidth = MapZoom; iChunkHeight = MapZoom;
-	Surface32->Lock();
-	if (AnimationSurface) AnimationSurface->Lock();
-	// Scan map lines
+	// Scan map lines once, sorting chunks by texture
+	std::array<std::vector<ChunkOp>, C4M_MaxTexIndex> Chunks;
 	for (iY = iMapY; iY < iMapY + iMapHgt; iY++)
-	{
-		// Landscape target coordinate vertical
-		iToY = iY * iChunkHeight + iOffY;
-		// Scan map line
 		for (iX = iMapX; iX < iMapX + iMapWdt; iX++)
 		{
 			// Map scan line start
 			byMapPixel = sfcMap->GetPix(iX, iY);
-			// Map scan line pixel below
-			byMapPixelBelow = sfcMap->GetPix(iX, iY + 1);
-			// Landscape target coordinate horizontal
-			iToX = iX * iChunkWidth + iOffX;
-			// Here's a chunk of the texture-material to zoom
-			if ((byMapPixel & 127) == iTexture)
+			// Here's a chunk of a texture-material to zoom
+			iTexture = byMapPixel & 127;
+			if (iTexture < C4M_MaxTexIndex && pMaterials[iTexture])
 			{
-				// Determine IFT
-				iIFT = 0; if (byMapPixel >= 128) iIFT = IFT;
-				// Draw chunk
-				DrawChunk(iToX, iToY, iChunkWidth, iChunkHeight, byColor + iIFT, pMaterial->MapChunkType, (iX << 2) + iY);
+				Chunks[iTexture].push_back({iX, iY, static_cast<uint8_t>(MatTex2PixCol(iTexture) + (byMapPixel & IFT)), -1});
 			}
-			// Other chunk, check for slope smoothers
+			// Check for slope smoothers of other smooth texture-material below
+			if (iY >= iMapHeight - 1) continue;
+			byMapPixelBelow = sfcMap->GetPix(iX, iY + 1);
+			iTexture = byMapPixelBelow & 127;
+			if (iTexture == (byMapPixel & 127) || iTexture >= C4M_MaxTexIndex || !pMaterials[iTexture] || pMaterials[iTexture]->MapChunkType != C4M_Smooth) continue;
+			// Same texture-material on left
+			if ((iX > 0) && ((sfcMap->GetPix(iX - 1, iY) & 127) == iTexture))
+				Chunks[iTexture].push_back({iX, iY, static_cast<uint8_t>(MatTex2PixCol(iTexture) + (sfcMap->GetPix(iX - 1, iY) & IFT)), 0});
+			// Same texture-material on right
+			if ((iX < iMapWidth - 1) && ((sfcMap->GetPix(iX + 1, iY) & 127) == iTexture))
+				Chunks[iTexture].push_back({iX, iY, static_cast<uint8_t>(MatTex2PixCol(iTexture) + (sfcMap->GetPix(iX + 1, iY) & IFT)), 1});
+		}
+	// Draw chunks texture by texture, so overlaps are resolved like they used to be
+	for (iTexture = 1; iTexture < C4M_MaxTexIndex; iTexture++)
+		for (const ChunkOp &Chunk : Chunks[iTexture])
+		{
+			// Landscape target coordinates
+			const int32_t iToX = Chunk.iX * iChunkWidth + iOffX, iToY = Chunk.iY * iChunkHeight + iOffY;
+			if (Chunk.iSmoothFlip < 0)
+				DrawChunk(iToX, iToY, iChunkWidth, iChunkHeight, Chunk.byColor, pMaterials[iTexture]->MapChunkType, (Chunk.iX << 2) + Chunk.iY, iBandY, iBandY2);
 			else
-				// Smooth chunk & same texture-material below
-				if ((iChunkType == C4M_Smooth) && (iY < iMapHeight - 1) && ((byMapPixelBelow & 127) == iTexture))
-				{
-					// Same texture-material on left
-					if ((iX > 0) && ((sfcMap->GetPix(iX - 1, iY) & 127) == iTexture))
-					{
-						// Determine IFT
-						iIFT = 0; if (sfcMap->GetPix(iX - 1, iY) >= 128) iIFT = IFT;
-						// Draw smoother
-						DrawSmoothOChunk(iToX, iToY, iChunkWidth, iChunkHeight, byColor + iIFT, 0, (iX << 2) + iY);
-					}
-					// Same texture-material on right
-					if ((iX < iMapWidth - 1) && ((sfcMap->GetPix(iX + 1, iY) & 127) == iTexture))
-					{
-						// Determine IFT
-						iIFT = 0; if (sfcMap->GetPix(iX + 1, iY) >= 128) iIFT = IFT;
-						// Draw smoother
-						DrawSmoothOChunk(iToX, iToY, iChunkWidth, iChunkHeight, byColor + iIFT, 1, (iX << 2) + iY);
-					}
-				}
+				DrawSmoothOChunk(iToX, iToY, iChunkWidth, iChunkHeight, Chunk.byColor, Chunk.iSmoothFlip, (Chunk.iX << 2) + Chunk.iY, iBandY, iBandY2);
 		}
-	}
-	Surface32->Unlock();
-	if (AnimationSurface) AnimationSurface->Unlock();
 }
 
 bool C4Landscape::GetTexUsage(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, uint32_t *dwpTextureUsage)
@@ -421,15 +413,31 @@ bool C4Landscape::GetTexUsage(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, i
 
 bool C4Landscape::TexOZoom(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, uint32_t *dwpTextureUsage, int32_t iToX, int32_t iToY)
 {
-	int32_t iIndex;
+	// Clip desired map segment to map size
+	iMapX = BoundBy<int32_t>(iMapX, 0, sfcMap->Wdt - 1); iMapY = BoundBy<int32_t>(iMapY, 0, sfcMap->Hgt - 1);
+	iMapWdt = BoundBy<int32_t>(iMapWdt, 0, sfcMap->Wdt - iMapX); iMapHgt = BoundBy<int32_t>(iMapHgt, 0, sfcMap->Hgt - iMapY);
+	if (!iMapWdt || !iMapHgt) return true;
 
-	// ChunkOZoom all used textures
-	for (iIndex = 1; iIndex < C4M_MaxTexIndex; iIndex++)
-		if (dwpTextureUsage[iIndex] > 0)
-		{
-			// ChunkOZoom map to landscape
-			ChunkOZoom(sfcMap, iMapX, iMapY, iMapWdt, iMapHgt, iIndex, iToX, iToY);
-		}
+	Surface32->Lock();
+	if (AnimationSurface) AnimationSurface->Lock();
+
+	// ChunkOZoom in horizontal bands of map rows. Each band only draws its own landscape rows,
+	// so the bands are independent. Chunks reach up to two rows below and one row above their
+	// map row, so bands also scan some rows of their neighbours.
+	CStdWorkerPool &Pool = CStdWorkerPool::Default();
+	const int32_t iBandCnt = BoundBy<int32_t>(iMapHgt / 8, 1, Pool.GetThreadCount() * 4);
+	Pool.ForEach(iBandCnt, [&](int iBand)
+	{
+		const int32_t iRow = iMapY + iMapHgt * iBand / iBandCnt, iRow2 = iMapY + iMapHgt * (iBand + 1) / iBandCnt;
+		// the outer bands include the chunky rim
+		const int32_t iBandY = iBand ? iRow * MapZoom + iToY : 0;
+		const int32_t iBandY2 = (iBand < iBandCnt - 1) ? iRow2 * MapZoom + iToY - 1 : INT32_MAX;
+		const int32_t iScanRow = (std::max)(iMapY, iRow - 3), iScanRow2 = (std::min)(iMapY + iMapHgt, iRow2 + 2);
+		ChunkOZoom(sfcMap, iMapX, iScanRow, iMapWdt, iScanRow2 - iScanRow, dwpTextureUsage, iToX, iToY, iBandY, iBandY2);
+	});
+
+	Surface32->Unlock();
+	if (AnimationSurface) AnimationSurface->Unlock();
 
 	// Done
 	return true;
@@ -786,6 +794,8 @@ bool C4Landscape::_SetPix(int32_t x, int32_t y, uint8_t npix)
 	{
 		if (Pix2Dens[opix]) PixCnt[(y / 15) + (x / 17) * PixCntPitch]--;
 	}
+	// solidity changed: update pathfinder
+	if (DensitySolid(Pix2Dens[npix]) != DensitySolid(Pix2Dens[opix])) Game.PathFinder.Invalidate(x, y);
 	// count material
 	assert(!npix || MatValid(Pix2Mat[npix]));
 	int32_t omat = Pix2Mat[opix], nmat = Pix2Mat[npix];
@@ -2777,6 +2787,8 @@ void C4Landscape::FinishChange(C4Rect BoundingBox, const bool updateMatAndPixCnt
 	}
 	if (updateMatAndPixCnt) UpdatePixCnt(BoundingBox);
 	C4SolidMask::CheckConsistency();
+	// update pathfinder
+	Game.PathFinder.Invalidate(BoundingBox);
 }
 
 void C4Landscape::UpdatePixCnt(const C4Rect &Rect, bool fCheck)
@@ -30,7 +30,42 @@
 #include <C4Texture.h>
 #endif
 
+#include <StdParallel.h>
+
 #include <cassert>
+#include <deque>
+#include <vector>
+
+bool AlgoScript(C4MCOverlay *pOvrl, int32_t iX, int32_t iY);
+
+// state of rendering a map row by C4MCOverlay::RenderRow
+
+struct C4MCRowContext
+{
+	struct Span { int32_t iX, iX2; }; // pixels iX to iX2 - 1
+	struct Enable { C4MCCallbackArray *pArray; int32_t iX, iY; }; // delayed EnablePixel
+
+	int32_t iWdt, iY; // row size and position
+	uint8_t *pPix; // row pixels
+	C4MCOverlay **ppSetOverlay; // overlays that set the row pixels
+	std::deque<std::vector<Span>> Spans; // pixels evaluated per tree depth
+	std::deque<std::vector<uint8_t>> Set; // set-flags of operator chain per tree depth
+	std::vector<Enable> Enabled; // callbacks to enable after rendering
+
+	C4MCRowContext(int32_t iWdt) : iWdt(iWdt), iY(0), pPix(nullptr), ppSetOverlay(nullptr) {}
+
+	std::vector<Span> &GetSpans(int32_t iDepth)
+	{
+		while (Spans.size() <= static_cast<size_t>(iDepth)) Spans.emplace_back();
+		return Spans[iDepth];
+	}
+
+	uint8_t *GetSet(int32_t iDepth)
+	{
+		while (Set.size() <= static_cast<size_t>(iDepth)) Set.emplace_back(iWdt);
+		return Set[iDepth].data();
+	}
+};
 
 // C4MCCallbackArray
 
@@ -556,6 +591,87 @@ bool C4MCOverlay::RenderPix(int32_t iX, int32_t iY, uint8_t &rPix, C4MCTokenType
 	return DoSet;
 }
 
+void C4MCOverlay::RenderRow(C4MCRowContext &rCtx, int32_t iDepth, C4MCTokenType eLastOp, bool fDraw)
+{
+	const std::vector<C4MCRowContext::Span> &Spans = rCtx.Spans[iDepth];
+	uint8_t *const pDoSet = rCtx.GetSet(iDepth); // holds last set-flags of op chain
+	const int32_t iY = rCtx.iY;
+	// algo match? The mask never matches outside fixed bounds
+	// and doesn't matter if the result is determined by the last op already
+	const bool fRowInBounds = LooseBounds || (iY >= Y && iY < Y + Hgt);
+	for (const C4MCRowContext::Span &Span : Spans)
+		for (int32_t iX = Span.iX; iX < Span.iX2; iX++)
+		{
+			const bool fLastSet = !!pDoSet[iX];
+			if (eLastOp == MCT_AND && !fLastSet) continue;
+			if (eLastOp == MCT_OR && fLastSet) continue;
+			const bool SetThis = fRowInBounds && (LooseBounds || (iX >= X && iX < X + Wdt)) && CheckMask(iX, iY);
+			// exec last op
+			pDoSet[iX] = (eLastOp == MCT_XOR) ? SetThis != fLastSet : SetThis;
+		}
+
+	// set pix to local value and exec children, if no operator is following
+	if (!(fDraw && Op == MCT_NONE) && !Group) return;
+	std::vector<C4MCRowContext::Span> &Active = rCtx.GetSpans(iDepth + 1);
+	if (Group)
+		Active = Spans;
+	else
+	{
+		Active.clear();
+		for (const C4MCRowContext::Span &Span : Spans)
+			for (int32_t iX = Span.iX; iX < Span.iX2; iX++)
+				if (pDoSet[iX])
+				{
+					if (!Active.empty() && Active.back().iX2 == iX)
+						Active.back().iX2++;
+					else
+						Active.push_back({iX, iX + 1});
+				}
+	}
+	if (Active.empty()) return;
+	// groups don't set a pixel value, if they're associated with an operator
+	fDraw &= !Group || (Op == MCT_NONE);
+	if (fDraw && !Mask)
+		for (const C4MCRowContext::Span &Span : Active)
+			for (int32_t iX = Span.iX; iX < Span.iX2; iX++)
+				if (pDoSet[iX])
+				{
+					rCtx.pPix[iX] = MatClr;
+					rCtx.ppSetOverlay[iX] = this;
+				}
+	// evaluate children overlays, if this was painted, too
+	uint8_t *const pLastSetC = rCtx.GetSet(iDepth + 1);
+	for (const C4MCRowContext::Span &Span : Active)
+		std::fill(pLastSetC + Span.iX, pLastSetC + Span.iX2, 0);
+	eLastOp = MCT_NONE;
+	for (C4MCNode *pChild = Child0; pChild; pChild = pChild->Next)
+		if (C4MCOverlay *pOvrl = pChild->Overlay())
+		{
+			pOvrl->RenderRow(rCtx, iDepth + 1, eLastOp, fDraw);
+			if (Group && (pOvrl->Op == MCT_NONE))
+				for (const C4MCRowContext::Span &Span : Active)
+					for (int32_t iX = Span.iX; iX < Span.iX2; iX++)
+						pDoSet[iX] |= pLastSetC[iX];
+			eLastOp = pOvrl->Op;
+		}
+	// add evaluation-callback
+	if (pEvaluateFunc && fDraw)
+		for (const C4MCRowContext::Span &Span : Active)
+			for (int32_t iX = Span.iX; iX < Span.iX2; iX++)
+				if (pDoSet[iX])
+					rCtx.Enabled.push_back({pEvaluateFunc, iX, iY});
+}
+
+bool C4MCOverlay::UsesScriptAlgo()
+{
+	if (Algorithm && Algorithm->Function == &AlgoScript) return true;
+	for (C4MCNode *pChild = Child0; pChild; pChild = pChild->Next)
+		if (C4MCOverlay *pOvrl = pChild->Overlay())
+			if (pOvrl->UsesScriptAlgo())
+				return true;
+	return false;
+}
+
 bool C4MCOverlay::PeekPix(int32_t iX, int32_t iY)
 {
 	// start with this one
@@ -651,6 +767,15 @@ bool C4MCMap::RenderTo(uint8_t *pToBuf, int32_t iPitch)
 {
 	// set current render target
 	if (MapCreator) MapCreator->pCurrentMap = this;
+#ifndef DEBUGREC
+	// script algorithms may have side effects and must be called in pixel order
+	if (!UsesScriptAlgo())
+	{
+		RenderRows(pToBuf, iPitch);
+		if (MapCreator) MapCreator->pCurrentMap = nullptr;
+		return true;
+	}
+#endif
 	// draw pixel by pixel
 	for (int32_t iY = 0; iY < Hgt; iY++)
 	{
@@ -677,6 +802,42 @@ bool C4MCMap::RenderTo(uint8_t *pToBuf, int32_t iPitch)
 	return true;
 }
 
+void C4MCMap::RenderRows(uint8_t *pToBuf, int32_t iPitch)
+{
+	if (Wdt <= 0 || Hgt <= 0) return;
+	// render bands of rows in parallel
+	// callbacks are collected and enabled afterwards, because the callback maps are shared
+	CStdWorkerPool &Pool = CStdWorkerPool::Default();
+	const int32_t iBandCnt = BoundBy<int32_t>(Hgt / 4, 1, Pool.GetThreadCount() * 4);
+	std::vector<std::vector<C4MCRowContext::Enable>> Enabled(iBandCnt);
+	Pool.ForEach(iBandCnt, [&](int iBand)
+	{
+		C4MCRowContext Ctx(Wdt);
+		std::vector<C4MCOverlay *> SetOverlays(Wdt);
+		for (int32_t iY = Hgt * iBand / iBandCnt; iY < Hgt * (iBand + 1) / iBandCnt; iY++)
+		{
+			// default to sky
+			Ctx.iY = iY;
+			Ctx.pPix = pToBuf + iY * iPitch;
+			Ctx.ppSetOverlay = SetOverlays.data();
+			std::fill_n(Ctx.pPix, Wdt, 0);
+			std::fill(SetOverlays.begin(), SetOverlays.end(), nullptr);
+			// render whole row
+			Ctx.GetSpans(0).assign(1, {0, Wdt});
+			std::fill_n(Ctx.GetSet(0), Wdt, 0);
+			RenderRow(Ctx, 0, MCT_NONE, true);
+			// add draw-callback for rendered overlays
+			for (int32_t iX = 0; iX < Wdt; iX++)
+				if (SetOverlays[iX] && SetOverlays[iX]->pDrawFunc)
+					Ctx.Enabled.push_back({SetOverlays[iX]->pDrawFunc, iX, iY});
+		}
+		Enabled[iBand] = std::move(Ctx.Enabled);
+	});
+	for (const auto &BandEnabled : Enabled)
+		for (const C4MCRowContext::Enable &Enable : BandEnabled)
+			Enable.pArray->EnablePixel(Enable.iX, Enable.iY);
+}
+
 void C4MCMap::SetSize(int32_t iWdt, int32_t iHgt)
 {
 	// store new size
@@ -69,6 +69,7 @@ class C4MCNode;
 class C4MCOverlay;
 class C4MCPoint;
 class C4MCMap;
+struct C4MCRowContext;
 class C4MapCreatorS2;
 class C4MCParserErr;
 class C4MCParser;
@@ -284,7 +285,9 @@ public:
 
 	bool CheckMask(int32_t iX, int32_t iY); // check whether algorithms succeeds at iX/iY
 	bool RenderPix(int32_t iX, int32_t iY, uint8_t &rPix, C4MCTokenType eLastOp = MCT_NONE, bool fLastSet = false, bool fDraw = true, C4MCOverlay **ppPixelSetOverlay = nullptr); // render this pixel
+	void RenderRow(C4MCRowContext &rCtx, int32_t iDepth, C4MCTokenType eLastOp, bool fDraw); // render row at the spans of given depth; like RenderPix
 	bool PeekPix(int32_t iX, int32_t iY); // check mask; regard operator chain
+	bool UsesScriptAlgo(); // whether this overlay or any child overlay uses a script algorithm
 	bool InBounds(int32_t iX, int32_t iY) { return iX >= X && iY >= Y && iX < X + Wdt && iY < Y + Hgt; } // return whether point iX/iY is inside bounds
 
 public:
@@ -336,6 +339,9 @@ public:
 	bool RenderTo(uint8_t *pToBuf, int32_t iPitch); // render to buffer
 	void SetSize(int32_t iWdt, int32_t iHgt);
 
+protected:
+	void RenderRows(uint8_t *pToBuf, int32_t iPitch); // render to buffer row by row on all threads
+
 public:
 	C4MCNodeType Type() override { return MCN_Map; } // get node type
 
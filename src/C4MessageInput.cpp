@@ -425,6 +425,8 @@ bool C4MessageInput::ProcessCommand(const char *szCommand)
 		LogF("/fast [x] - %s", LoadResStr("IDS_TEXT_SETTOFASTMODESKIPPINGXFRA"));
 		LogF("/slow - %s", LoadResStr("IDS_TEXT_SETTONORMALSPEEDMODE"));
 		LogF("/chart - %s", LoadResStr("IDS_TEXT_DISPLAYNETWORKSTATISTICS"));
+		LogF("/timers - %s", LoadResStr("IDS_TEXT_SHOWTIMERCALLSPIKES"));
+		LogF("/frametimes [csv/json file] - %s", LoadResStr("IDS_TEXT_SHOWSUBSYSTEMFRAMETIMES"));
 		LogF("/nodebug - %s", LoadResStr("IDS_TEXT_PREVENTDEBUGMODEINTHISROU"));
 		LogF("/set comment [comment] - %s", LoadResStr("IDS_TEXT_SETANEWNETWORKCOMMENT"));
 		LogF("/set password [password] - %s", LoadResStr("IDS_TEXT_SETANEWNETWORKPASSWORD"));
@@ -670,6 +672,32 @@ bool C4MessageInput::ProcessCommand(const char *szCommand)
 	if (Game.IsRunning) if (SEqual(szCmdName, "chart"))
 		return Game.ToggleChart();
 
+	// profile timer calls
+	if (Game.IsRunning) if (SEqual(szCmdName, "timers"))
+	{
+		Game.TimerStats.ToggleProfiling();
+		return true;
+	}
+
+	// subsystem timings of the last frames
+	if (Game.IsRunning) if (SEqual(szCmdName, "frametimes"))
+	{
+		const bool fCSV = SEqual2(pCmdPar, "csv "), fJSON = SEqual2(pCmdPar, "json ");
+		if (!fCSV && !fJSON)
+		{
+			Log(Game.FrameTimings.GetSummary().getData());
+			return true;
+		}
+		const char *szFile = pCmdPar + (fCSV ? 4 : 5);
+		if (!(fCSV ? Game.FrameTimings.GetCSV() : Game.FrameTimings.GetJSON()).SaveToFile(szFile))
+		{
+			LogF("Could not write frame timings to %s.", szFile);
+			return false;
+		}
+		LogF("Frame timings written to %s.", szFile);
+		return true;
+	}
+
 	// custom command
 	if (Game.IsRunning && GetCommand(szCmdName))
 	{
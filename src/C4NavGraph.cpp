@@ -0,0 +1,653 @@
+/*
+ * LegacyClonk
+ *
+ * Copyright (c) 2026, The LegacyClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Coarse navigation graph of the landscape for hierarchical path searches */
+
+/* Notes
+
+   The landscape is divided into cells which are connected by edges along
+   which an object can move from one cell center to the other.
+
+   In GM_Free, cells are connected to their neighbours if the straight line
+   between them is free, so any chain of connected cells is a valid ray path.
+
+   In GM_Walk, only cells with solid ground below (surfaces) or a solid wall
+   next to them are used. Surfaces are connected to neighbouring surfaces
+   with at most one cell of height difference, walls to walls above and
+   below them, and the top of a wall to the surface of the ledge. From a
+   surface, objects can jump up to JumpWidth x JumpHeight cells onto other
+   surfaces or walls they face, and they can walk off ledges or let go of
+   walls to fall onto a surface up to MaxFall cells below. Jumps and falls
+   are one-way. Liquids count as free space, so swimming objects follow the
+   ground and walls like walking ones.
+
+   Cells are grouped into clusters; the cells of a cluster that are
+   connected within it form a region. Searches first look for a chain of
+   regions, which also quickly rules out unreachable targets, and then
+   search cells only within the clusters of that chain.
+
+   Pixel changes only mark the clusters around them dirty; those are
+   rebuilt before the next search. All costs are integers, so results are
+   the same on all clients.
+*/
+
+#include <C4Include.h>
+#include <C4NavGraph.h>
+
+#include <C4Shape.h>
+#include <C4TransferZone.h>
+
+#include <numeric>
+#include <queue>
+#include <unordered_map>
+
+namespace
+{
+	const int32_t StraightCost = 10, DiagonalCost = 14; // cost of a step between cells
+	const int32_t ClimbCost = 15; // climbing is slower than walking
+	const int32_t JumpCost = 20; // added to the distance, so walking is preferred if it's about as short
+
+	const int32_t Directions[8][2] =
+	{
+		{ -1, -1 }, { 0, -1 }, { 1, -1 },
+		{ -1,  0 },            { 1,  0 },
+		{ -1,  1 }, { 0,  1 }, { 1,  1 },
+	};
+
+	// estimated cost between cells; exact for free cells without obstacles
+	int32_t CellDistance(int32_t iDX, int32_t iDY)
+	{
+		iDX = Abs(iDX); iDY = Abs(iDY);
+		return StraightCost * (std::max)(iDX, iDY) + (DiagonalCost - StraightCost) * (std::min)(iDX, iDY);
+	}
+
+	// open list entry ordered by estimated total cost, then by node for identical results everywhere
+	using OpenNode = std::pair<int32_t, int32_t>;
+	using OpenList = std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>>;
+}
+
+C4NavGraph::C4NavGraph()
+{
+	Default();
+}
+
+C4NavGraph::~C4NavGraph()
+{
+	Clear();
+}
+
+void C4NavGraph::Default()
+{
+	Mode = GM_Free;
+	PointFree = nullptr;
+	Width = Height = 0;
+	ClustersX = ClustersY = 0;
+	AnyDirty = false;
+	CurrentStamp = 0;
+}
+
+void C4NavGraph::Clear()
+{
+	Cells.clear();
+	CellRegions.clear();
+	Clusters.clear();
+	SearchStamp.clear();
+	SearchCost.clear(); SearchFrom.clear(); SearchZone.clear();
+	Default();
+}
+
+void C4NavGraph::Init(GraphMode eMode, bool(*fnPointFree)(int32_t, int32_t), int32_t iLandscapeWdt, int32_t iLandscapeHgt)
+{
+	Clear();
+	if (iLandscapeWdt <= 0 || iLandscapeHgt <= 0) return;
+	Mode = eMode;
+	PointFree = fnPointFree;
+	Width = (iLandscapeWdt + CellSize - 1) / CellSize;
+	Height = (iLandscapeHgt + CellSize - 1) / CellSize;
+	ClustersX = (Width + ClusterSize - 1) / ClusterSize;
+	ClustersY = (Height + ClusterSize - 1) / ClusterSize;
+	const size_t iCellCnt = static_cast<size_t>(Width) * Height;
+	Cells.assign(iCellCnt, 0);
+	CellRegions.assign(iCellCnt, -1);
+	SearchStamp.assign(iCellCnt, 0);
+	SearchCost.resize(iCellCnt); SearchFrom.resize(iCellCnt); SearchZone.resize(iCellCnt);
+	// everything is built on the first search
+	Clusters.assign(ClustersX * ClustersY, Cluster{true, {}, {}, {}});
+	AnyDirty = true;
+}
+
+void C4NavGraph::Invalidate(int32_t iX, int32_t iY)
+{
+	if (!IsInitialized()) return;
+	Invalidate(C4Rect(iX, iY, 1, 1));
+}
+
+void C4NavGraph::Invalidate(const C4Rect &rRect)
+{
+	if (!IsInitialized() || rRect.Wdt <= 0 || rRect.Hgt <= 0) return;
+	const int32_t iCellX1 = rRect.x / CellSize, iCellY1 = rRect.y / CellSize;
+	const int32_t iCellX2 = (rRect.x + rRect.Wdt - 1) / CellSize, iCellY2 = (rRect.y + rRect.Hgt - 1) / CellSize;
+	// edges to all neighbour cells may pass the changed pixels
+	if (Mode == GM_Free)
+		InvalidateCells(iCellX1 - 1, iCellY1 - 1, iCellX2 + 1, iCellY2 + 1);
+	// ...and so may jumps from below and falls from above
+	else
+		InvalidateCells(iCellX1 - JumpWidth - 1, iCellY1 - MaxFall - 1, iCellX2 + JumpWidth + 1, iCellY2 + JumpHeight + 1);
+}
+
+void C4NavGraph::InvalidateCells(int32_t iCellX1, int32_t iCellY1, int32_t iCellX2, int32_t iCellY2)
+{
+	iCellX1 = BoundBy<int32_t>(iCellX1, 0, Width - 1); iCellX2 = BoundBy<int32_t>(iCellX2, 0, Width - 1);
+	iCellY1 = BoundBy<int32_t>(iCellY1, 0, Height - 1); iCellY2 = BoundBy<int32_t>(iCellY2, 0, Height - 1);
+	for (int32_t y = iCellY1 / ClusterSize; y <= iCellY2 / ClusterSize; ++y)
+		for (int32_t x = iCellX1 / ClusterSize; x <= iCellX2 / ClusterSize; ++x)
+			Clusters[y * ClustersX + x].Dirty = true;
+	AnyDirty = true;
+}
+
+bool C4NavGraph::IsFree(int32_t iX, int32_t iY) const
+{
+	return !!(GetCell(iX, iY) & CellFree);
+}
+
+bool C4NavGraph::LineFree(int32_t iX1, int32_t iY1, int32_t iX2, int32_t iY2) const
+{
+	const int32_t iDX = Abs(iX2 - iX1), iDY = -Abs(iY2 - iY1);
+	const int32_t iIncX = iX1 < iX2 ? 1 : -1, iIncY = iY1 < iY2 ? 1 : -1;
+	int32_t iErr = iDX + iDY;
+	for (;;)
+	{
+		if (!PointFree(iX1, iY1)) return false;
+		if (iX1 == iX2 && iY1 == iY2) return true;
+		const int32_t iErr2 = 2 * iErr;
+		if (iErr2 >= iDY) { iErr += iDY; iX1 += iIncX; }
+		if (iErr2 <= iDX) { iErr += iDX; iY1 += iIncY; }
+	}
+}
+
+const C4NavGraph::Edge *C4NavGraph::EdgesBegin(int32_t iCell) const
+{
+	const Cluster &rCluster = Clusters[ClusterOf(iCell)];
+	return rCluster.Edges.data() + rCluster.EdgeStart[LocalIndex(iCell)];
+}
+
+const C4NavGraph::Edge *C4NavGraph::EdgesEnd(int32_t iCell) const
+{
+	const Cluster &rCluster = Clusters[ClusterOf(iCell)];
+	return rCluster.Edges.data() + rCluster.EdgeStart[LocalIndex(iCell) + 1];
+}
+
+const C4NavGraph::Edge *C4NavGraph::FindEdge(int32_t iFromCell, int32_t iToCell) const
+{
+	// the cheapest one, as used by the search
+	const Edge *pBest = nullptr;
+	for (const Edge *pEdge = EdgesBegin(iFromCell); pEdge != EdgesEnd(iFromCell); ++pEdge)
+		if (pEdge->Cell == iToCell && (!pBest || pEdge->Cost < pBest->Cost))
+			pBest = pEdge;
+	return pBest;
+}
+
+void C4NavGraph::Update()
+{
+	if (!AnyDirty) return;
+	// cells first, because edges and regions look at neighbouring clusters
+	for (int32_t i = 0; i < static_cast<int32_t>(Clusters.size()); ++i)
+		if (Clusters[i].Dirty) BuildCells(i);
+	for (int32_t i = 0; i < static_cast<int32_t>(Clusters.size()); ++i)
+		if (Clusters[i].Dirty) BuildEdges(i);
+	for (int32_t i = 0; i < static_cast<int32_t>(Clusters.size()); ++i)
+		if (Clusters[i].Dirty)
+		{
+			BuildRegions(i);
+			Clusters[i].Dirty = false;
+		}
+	AnyDirty = false;
+}
+
+void C4NavGraph::BuildCells(int32_t iCluster)
+{
+	const int32_t iX1 = (iCluster % ClustersX) * ClusterSize, iY1 = (iCluster / ClustersX) * ClusterSize;
+	const int32_t iX2 = (std::min)(iX1 + ClusterSize, Width), iY2 = (std::min)(iY1 + ClusterSize, Height);
+	for (int32_t y = iY1; y < iY2; ++y)
+		for (int32_t x = iX1; x < iX2; ++x)
+		{
+			const int32_t iCell = CellIndex(x, y), iCX = CenterX(iCell), iCY = CenterY(iCell);
+			uint8_t &rCell = Cells[iCell];
+			rCell = 0;
+			if (!PointFree(iCX, iCY)) continue;
+			rCell = CellFree;
+			if (Mode != GM_Walk) continue;
+			// solid within the lower half of the cell or the upper half of the one below
+			if (!PointFree(iCX, iCY + CellSize / 2) || !PointFree(iCX, iCY + CellSize)) rCell |= CellStand;
+			if (!PointFree(iCX - CellSize / 2, iCY) || !PointFree(iCX - CellSize, iCY)) rCell |= CellWallLeft;
+			if (!PointFree(iCX + CellSize / 2, iCY) || !PointFree(iCX + CellSize, iCY)) rCell |= CellWallRight;
+		}
+}
+
+void C4NavGraph::BuildEdges(int32_t iCluster)
+{
+	const int32_t iX1 = (iCluster % ClustersX) * ClusterSize, iY1 = (iCluster / ClustersX) * ClusterSize;
+	Cluster &rCluster = Clusters[iCluster];
+	rCluster.EdgeStart.assign(ClusterSize * ClusterSize + 1, 0);
+	rCluster.Edges.clear();
+	// in order of LocalIndex
+	for (int32_t y = iY1; y < iY1 + ClusterSize; ++y)
+		for (int32_t x = iX1; x < iX1 + ClusterSize; ++x)
+		{
+			rCluster.EdgeStart[(y - iY1) * ClusterSize + x - iX1] = static_cast<int32_t>(rCluster.Edges.size());
+			if (!IsFree(x, y)) continue;
+			if (Mode == GM_Free)
+				AddFreeEdges(CellIndex(x, y), rCluster.Edges);
+			else
+				AddWalkEdges(CellIndex(x, y), rCluster.Edges);
+		}
+	rCluster.EdgeStart.back() = static_cast<int32_t>(rCluster.Edges.size());
+}
+
+void C4NavGraph::AddFreeEdges(int32_t iCell, std::vector<Edge> &rEdges) const
+{
+	const int32_t iCellX = iCell % Width, iCellY = iCell / Width;
+	for (const auto &rDir : Directions)
+	{
+		const int32_t iNX = iCellX + rDir[0], iNY = iCellY + rDir[1];
+		if (!IsFree(iNX, iNY)) continue;
+		const int32_t iNext = CellIndex(iNX, iNY);
+		if (CellLineFree(iCell, iNext))
+			rEdges.push_back({iNext, rDir[0] && rDir[1] ? DiagonalCost : StraightCost, EK_Line});
+	}
+}
+
+void C4NavGraph::AddWalkEdges(int32_t iCell, std::vector<Edge> &rEdges) const
+{
+	const int32_t x = iCell % Width, y = iCell / Width;
+	const uint8_t byCell = Cells[iCell];
+	if (!(byCell & CellSupport)) return;
+	const auto Add = [&](int32_t iNX, int32_t iNY, int32_t iCost, EdgeKind eKind)
+	{
+		rEdges.push_back({CellIndex(iNX, iNY), iCost, eKind});
+	};
+
+	// walk along the ground, up and down slopes of one cell
+	if (byCell & CellStand)
+		for (int32_t iDX = -1; iDX <= 1; iDX += 2)
+			for (int32_t iDY = -1; iDY <= 1; ++iDY)
+				if ((GetCell(x + iDX, y + iDY) & CellStand) && CellLineFree(iCell, CellIndex(x + iDX, y + iDY)))
+					Add(x + iDX, y + iDY, iDY ? DiagonalCost : StraightCost, EK_Walk);
+
+	// climb walls up and down, and get onto them from the ground and back
+	for (int32_t iDY = -1; iDY <= 1; iDY += 2)
+	{
+		const uint8_t byNext = GetCell(x, y + iDY);
+		if ((byNext & CellSupport) && ((byCell | byNext) & (CellWallLeft | CellWallRight)) && CellLineFree(iCell, CellIndex(x, y + iDY)))
+			Add(x, y + iDY, ClimbCost, EK_Climb);
+	}
+
+	// climb over the top of a wall onto the ledge
+	for (int32_t iDX = -1; iDX <= 1; iDX += 2)
+		if (byCell & (iDX < 0 ? CellWallLeft : CellWallRight))
+			if ((GetCell(x + iDX, y - 1) & CellStand) && IsFree(x, y - 1)
+				&& CellLineFree(iCell, CellIndex(x, y - 1)) && CellLineFree(CellIndex(x, y - 1), CellIndex(x + iDX, y - 1)))
+				Add(x + iDX, y - 1, ClimbCost + StraightCost, EK_Climb);
+
+	// walk off the ground or let go of a wall sideways and fall onto a surface below
+	for (int32_t iDX = -1; iDX <= 1; iDX += 2)
+	{
+		if (byCell & (iDX < 0 ? CellWallLeft : CellWallRight)) continue;
+		const uint8_t bySide = GetCell(x + iDX, y);
+		if (!(bySide & CellFree) || (bySide & CellStand)) continue;
+		const int32_t iSide = CellIndex(x + iDX, y);
+		if (!CellLineFree(iCell, iSide)) continue;
+		for (int32_t iDY = 1; iDY <= MaxFall; ++iDY)
+		{
+			const uint8_t byBelow = GetCell(x + iDX, y + iDY);
+			if (!(byBelow & CellFree)) break;
+			if (!(byBelow & CellStand)) continue;
+			if (CellLineFree(iSide, CellIndex(x + iDX, y + iDY)))
+				Add(x + iDX, y + iDY, CellDistance(iDX, iDY), EK_Fall);
+			break;
+		}
+	}
+
+	// jump up, across gaps or down onto surfaces, or onto walls facing the jump
+	if ((byCell & CellStand) && IsFree(x, y - 1))
+		for (int32_t iDY = -JumpHeight; iDY <= JumpHeight; ++iDY)
+			for (int32_t iDX = -JumpWidth; iDX <= JumpWidth; ++iDX)
+			{
+				if (Abs(iDX) <= (iDY ? 0 : 1)) continue;
+				const uint8_t byTarget = GetCell(x + iDX, y + iDY);
+				if (!(byTarget & (CellStand | (iDX < 0 ? CellWallLeft : CellWallRight)))) continue;
+				// straight up above the target, over to it and down: stricter than the actual arc
+				const int32_t iTarget = CellIndex(x + iDX, y + iDY);
+				const int32_t iFromX = CenterX(iCell), iFromY = CenterY(iCell), iToX = CenterX(iTarget), iToY = CenterY(iTarget);
+				const int32_t iApexY = (std::min)(iFromY, iToY) - CellSize / 2;
+				if (LineFree(iFromX, iFromY, iFromX, iApexY) && LineFree(iFromX, iApexY, iToX, iApexY) && LineFree(iToX, iApexY, iToX, iToY))
+					Add(x + iDX, y + iDY, CellDistance(iDX, iDY) + JumpCost, EK_Jump);
+			}
+}
+
+void C4NavGraph::BuildRegions(int32_t iCluster)
+{
+	const int32_t iX1 = (iCluster % ClustersX) * ClusterSize, iY1 = (iCluster / ClustersX) * ClusterSize;
+	const int32_t iX2 = (std::min)(iX1 + ClusterSize, Width), iY2 = (std::min)(iY1 + ClusterSize, Height);
+	const uint8_t byNode = Mode == GM_Free ? CellFree : CellSupport;
+	std::vector<Region> &rRegions = Clusters[iCluster].Regions;
+	rRegions.clear();
+	// join cells connected within the cluster, ignoring the direction of edges
+	std::vector<int32_t> Parent(ClusterSize * ClusterSize);
+	std::iota(Parent.begin(), Parent.end(), 0);
+	const auto Root = [&](int32_t i)
+	{
+		while (Parent[i] != i) i = Parent[i] = Parent[Parent[i]];
+		return i;
+	};
+	for (int32_t y = iY1; y < iY2; ++y)
+		for (int32_t x = iX1; x < iX2; ++x)
+		{
+			const int32_t iCell = CellIndex(x, y);
+			for (const Edge *pEdge = EdgesBegin(iCell); pEdge != EdgesEnd(iCell); ++pEdge)
+				if (ClusterOf(pEdge->Cell) == iCluster)
+				{
+					const int32_t iRoot1 = Root(LocalIndex(iCell)), iRoot2 = Root(LocalIndex(pEdge->Cell));
+					// lower index as root, so region numbers don't depend on edge order
+					if (iRoot1 < iRoot2) Parent[iRoot2] = iRoot1; else Parent[iRoot1] = iRoot2;
+				}
+		}
+	// one region per set of node cells
+	std::vector<int32_t> RootRegions(ClusterSize * ClusterSize, -1);
+	for (int32_t y = iY1; y < iY2; ++y)
+		for (int32_t x = iX1; x < iX2; ++x)
+		{
+			const int32_t iCell = CellIndex(x, y);
+			CellRegions[iCell] = -1;
+			if (!(Cells[iCell] & byNode)) continue;
+			int32_t &rRootRegion = RootRegions[Root(LocalIndex(iCell))];
+			if (rRootRegion < 0)
+			{
+				rRootRegion = static_cast<int32_t>(rRegions.size());
+				rRegions.emplace_back();
+			}
+			CellRegions[iCell] = iCluster * MaxRegions + rRootRegion;
+		}
+	// portals and representatives
+	std::vector<int32_t> SumX(rRegions.size(), 0), SumY(rRegions.size(), 0), Count(rRegions.size(), 0);
+	for (int32_t y = iY1; y < iY2; ++y)
+		for (int32_t x = iX1; x < iX2; ++x)
+		{
+			const int32_t iCell = CellIndex(x, y);
+			if (CellRegions[iCell] < 0) continue;
+			const int32_t iIndex = CellRegions[iCell] % MaxRegions;
+			SumX[iIndex] += x; SumY[iIndex] += y; ++Count[iIndex];
+			std::vector<int32_t> &rPortals = rRegions[iIndex].Portals;
+			for (const Edge *pEdge = EdgesBegin(iCell); pEdge != EdgesEnd(iCell); ++pEdge)
+				if (ClusterOf(pEdge->Cell) != iCluster && std::find(rPortals.begin(), rPortals.end(), pEdge->Cell) == rPortals.end())
+					rPortals.push_back(pEdge->Cell);
+		}
+	// representative: the region cell closest to its center
+	std::vector<int32_t> BestDist(rRegions.size(), INT32_MAX);
+	for (int32_t y = iY1; y < iY2; ++y)
+		for (int32_t x = iX1; x < iX2; ++x)
+		{
+			const int32_t iCell = CellIndex(x, y);
+			if (CellRegions[iCell] < 0) continue;
+			const int32_t iIndex = CellRegions[iCell] % MaxRegions;
+			const int32_t iDist = CellDistance(x - SumX[iIndex] / Count[iIndex], y - SumY[iIndex] / Count[iIndex]);
+			if (iDist < BestDist[iIndex]) { BestDist[iIndex] = iDist; rRegions[iIndex].Cell = iCell; }
+		}
+}
+
+int32_t C4NavGraph::AttachCell(int32_t iX, int32_t iY) const
+{
+	const int32_t iCellX = BoundBy<int32_t>(iX / CellSize, 0, Width - 1), iCellY = BoundBy<int32_t>(iY / CellSize, 0, Height - 1);
+	// walking objects are centered above the ground, so surfaces a bit lower count, too
+	const uint8_t byNode = Mode == GM_Free ? CellFree : CellSupport;
+	const int32_t iBelow = Mode == GM_Free ? 1 : 3;
+	// the nearest cell around
+	int32_t iBest = -1, iBestDist = INT32_MAX;
+	for (int32_t y = (std::max)(iCellY - 1, 0); y <= (std::min)(iCellY + iBelow, Height - 1); ++y)
+		for (int32_t x = (std::max)(iCellX - 1, 0); x <= (std::min)(iCellX + 1, Width - 1); ++x)
+		{
+			const int32_t iCell = CellIndex(x, y);
+			if (!(Cells[iCell] & byNode)) continue;
+			const int32_t iDist = Distance(iX, iY, CenterX(iCell), CenterY(iCell));
+			if (iDist >= iBestDist || !LineFree(iX, iY, CenterX(iCell), CenterY(iCell))) continue;
+			iBest = iCell; iBestDist = iDist;
+		}
+	return iBest;
+}
+
+bool C4NavGraph::FindRegions(int32_t iFromCell, int32_t iToCell, const std::vector<ZoneLink> &rZones, std::vector<bool> &rCorridor)
+{
+	struct Node
+	{
+		int32_t Cost, From;
+		bool Closed;
+	};
+	const int32_t iFromRegion = CellRegions[iFromCell], iToRegion = CellRegions[iToCell];
+	if (iFromRegion < 0 || iToRegion < 0) return false;
+	const int32_t iToX = CenterX(iToCell), iToY = CenterY(iToCell);
+	const auto Estimate = [&](int32_t iRegion)
+	{
+		const int32_t iCell = GetRegion(iRegion).Cell;
+		return Distance(CenterX(iCell), CenterY(iCell), iToX, iToY) * StraightCost / CellSize;
+	};
+	std::unordered_map<int32_t, Node> Nodes;
+	OpenList Open;
+	Nodes[iFromRegion] = {0, -1, false};
+	Open.emplace(Estimate(iFromRegion), iFromRegion);
+	int32_t iExpanded = 0;
+	while (!Open.empty())
+	{
+		const int32_t iRegion = Open.top().second;
+		Open.pop();
+		Node &rNode = Nodes[iRegion];
+		if (rNode.Closed) continue;
+		rNode.Closed = true;
+		// found: mark clusters along the way
+		if (iRegion == iToRegion)
+		{
+			for (int32_t i = iRegion; i >= 0; i = Nodes[i].From)
+				rCorridor[i / MaxRegions] = true;
+			return true;
+		}
+		if (++iExpanded > MaxSearchNodes) return false;
+		const Region &rRegion = GetRegion(iRegion);
+		const int32_t iCost = rNode.Cost;
+		const auto Visit = [&](int32_t iNext, int32_t iStepCost)
+		{
+			auto it = Nodes.find(iNext);
+			if (it != Nodes.end() && (it->second.Closed || it->second.Cost <= iCost + iStepCost)) return;
+			Nodes[iNext] = {iCost + iStepCost, iRegion, false};
+			Open.emplace(iCost + iStepCost + Estimate(iNext), iNext);
+		};
+		const int32_t iCell = rRegion.Cell;
+		for (int32_t iPortal : rRegion.Portals)
+		{
+			const int32_t iNextCell = GetRegion(CellRegions[iPortal]).Cell;
+			Visit(CellRegions[iPortal], CellDistance(iNextCell % Width - iCell % Width, iNextCell / Width - iCell / Width));
+		}
+		for (const ZoneLink &rZone : rZones)
+			if (std::find(rZone.Regions.begin(), rZone.Regions.end(), iRegion) != rZone.Regions.end())
+				Visit(CellRegions[rZone.ExitCell], Distance(CenterX(iCell), CenterY(iCell), rZone.ExitX, rZone.ExitY) * StraightCost / CellSize);
+	}
+	return false;
+}
+
+bool C4NavGraph::FindCells(int32_t iFromCell, int32_t iToCell, const std::vector<ZoneLink> &rZones, const std::vector<bool> *pCorridor, std::vector<int32_t> &rCells, std::vector<int32_t> &rCellZones)
+{
+	// new search: invalidate all previous entries
+	if (!++CurrentStamp)
+	{
+		std::fill(SearchStamp.begin(), SearchStamp.end(), 0);
+		CurrentStamp = 1;
+	}
+	const int32_t iToCellX = iToCell % Width, iToCellY = iToCell / Width;
+	const auto Estimate = [&](int32_t iCell) { return CellDistance(iCell % Width - iToCellX, iCell / Width - iToCellY); };
+	OpenList Open;
+	SearchStamp[iFromCell] = CurrentStamp;
+	SearchCost[iFromCell] = 0; SearchFrom[iFromCell] = -1; SearchZone[iFromCell] = -1;
+	Open.emplace(Estimate(iFromCell), iFromCell);
+	int32_t iExpanded = 0;
+	while (!Open.empty())
+	{
+		const auto [iEstimate, iCell] = Open.top();
+		Open.pop();
+		// skip outdated entries
+		if (iEstimate != SearchCost[iCell] + Estimate(iCell)) continue;
+		if (iCell == iToCell)
+		{
+			rCells.clear(); rCellZones.clear();
+			for (int32_t i = iCell; i >= 0; i = SearchFrom[i])
+			{
+				rCells.push_back(i);
+				rCellZones.push_back(SearchZone[i]);
+			}
+			std::reverse(rCells.begin(), rCells.end());
+			std::reverse(rCellZones.begin(), rCellZones.end());
+			return true;
+		}
+		if (++iExpanded > MaxSearchNodes) return false;
+		const int32_t iCost = SearchCost[iCell];
+		const auto Visit = [&](int32_t iNext, int32_t iStepCost, int32_t iZone)
+		{
+			if (SearchStamp[iNext] == CurrentStamp && SearchCost[iNext] <= iCost + iStepCost) return;
+			SearchStamp[iNext] = CurrentStamp;
+			SearchCost[iNext] = iCost + iStepCost; SearchFrom[iNext] = iCell; SearchZone[iNext] = iZone;
+			Open.emplace(iCost + iStepCost + Estimate(iNext), iNext);
+		};
+		const int32_t iCellX = iCell % Width, iCellY = iCell / Width;
+		for (const Edge *pEdge = EdgesBegin(iCell); pEdge != EdgesEnd(iCell); ++pEdge)
+		{
+			if (pCorridor && !(*pCorridor)[ClusterOf(pEdge->Cell)]) continue;
+			Visit(pEdge->Cell, pEdge->Cost, -1);
+		}
+		for (int32_t i = 0; i < static_cast<int32_t>(rZones.size()); ++i)
+		{
+			const ZoneLink &rZone = rZones[i];
+			if (Inside(iCellX, rZone.CellX1, rZone.CellX2) && Inside(iCellY, rZone.CellY1, rZone.CellY2) && rZone.ExitCell != iCell)
+				Visit(rZone.ExitCell, Distance(CenterX(iCell), CenterY(iCell), rZone.ExitX, rZone.ExitY) * StraightCost / CellSize, i);
+		}
+	}
+	return false;
+}
+
+C4NavGraph::FindResult C4NavGraph::Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, C4TransferZones *pZones, std::vector<int32_t> &rPoints, std::vector<C4TransferZone *> &rPointZones)
+{
+	rPoints.clear(); rPointZones.clear();
+	if (!IsInitialized()) return FR_NoAttach;
+	Update();
+	// start and target must be directly connected to a cell
+	const int32_t iFromCell = AttachCell(iFromX, iFromY), iToCell = AttachCell(iToX, iToY);
+	if (iFromCell < 0 || iToCell < 0) return FR_NoAttach;
+
+	// transfer zones lead from any cell touching them to their exit towards the target
+	std::vector<ZoneLink> Zones;
+	if (pZones)
+		for (C4TransferZone *pZone = pZones->First; pZone; pZone = pZone->Next)
+		{
+			if (!pZone->Object) continue;
+			ZoneLink Link;
+			Link.Zone = pZone;
+			Link.CellX1 = BoundBy<int32_t>((pZone->X - 1) / CellSize, 0, Width - 1);
+			Link.CellY1 = BoundBy<int32_t>((pZone->Y - 1) / CellSize, 0, Height - 1);
+			Link.CellX2 = BoundBy<int32_t>((pZone->X + pZone->Wdt) / CellSize, 0, Width - 1);
+			Link.CellY2 = BoundBy<int32_t>((pZone->Y + pZone->Hgt) / CellSize, 0, Height - 1);
+			if (pZone->At(iToX, iToY))
+			{
+				Link.ExitX = iToX; Link.ExitY = iToY;
+				Link.ExitCell = iToCell;
+			}
+			else
+			{
+				if (!pZone->GetEntryPoint(Link.ExitX, Link.ExitY, iToX, iToY)) continue;
+				if ((Link.ExitCell = AttachCell(Link.ExitX, Link.ExitY)) < 0) continue;
+			}
+			for (int32_t y = Link.CellY1; y <= Link.CellY2; ++y)
+				for (int32_t x = Link.CellX1; x <= Link.CellX2; ++x)
+				{
+					const int32_t iRegion = CellRegions[CellIndex(x, y)];
+					if (iRegion >= 0 && std::find(Link.Regions.begin(), Link.Regions.end(), iRegion) == Link.Regions.end())
+						Link.Regions.push_back(iRegion);
+				}
+			Zones.push_back(std::move(Link));
+		}
+
+	// coarse search through regions; this also rules out unreachable targets
+	std::vector<bool> Corridor(Clusters.size(), false);
+	if (!FindRegions(iFromCell, iToCell, Zones, Corridor)) return FR_NoPath;
+	// detailed search through the clusters found
+	std::vector<int32_t> PathCells, PathZones;
+	if (!FindCells(iFromCell, iToCell, Zones, &Corridor, PathCells, PathZones))
+		if (!FindCells(iFromCell, iToCell, Zones, nullptr, PathCells, PathZones))
+			return FR_NoPath;
+
+	// walking objects only need the cells where their movement changes
+	std::vector<bool> Skip(PathCells.size(), false);
+	if (Mode == GM_Walk)
+		for (size_t i = 1; i + 1 < PathCells.size(); ++i)
+		{
+			if (PathZones[i] >= 0 || PathZones[i + 1] >= 0) continue;
+			const Edge *pIn = FindEdge(PathCells[i - 1], PathCells[i]), *pOut = FindEdge(PathCells[i], PathCells[i + 1]);
+			if (!pIn || !pOut || pIn->Kind != pOut->Kind || (pIn->Kind != EK_Walk && pIn->Kind != EK_Climb)) continue;
+			const auto Step = [this](int32_t iCell1, int32_t iCell2) { return std::make_pair(Sign(iCell2 % Width - iCell1 % Width), Sign(iCell2 / Width - iCell1 / Width)); };
+			Skip[i] = Step(PathCells[i - 1], PathCells[i]) == Step(PathCells[i], PathCells[i + 1]);
+		}
+
+	// convert to positions: start, cell centers or zone exits, target
+	std::vector<int32_t> Points{iFromX, iFromY};
+	std::vector<C4TransferZone *> PointZones{nullptr};
+	for (size_t i = 0; i < PathCells.size(); ++i)
+	{
+		if (Skip[i]) continue;
+		if (PathZones[i] >= 0)
+		{
+			const ZoneLink &rZone = Zones[PathZones[i]];
+			Points.push_back(rZone.ExitX); Points.push_back(rZone.ExitY);
+			PointZones.push_back(rZone.Zone);
+		}
+		else
+		{
+			Points.push_back(CenterX(PathCells[i])); Points.push_back(CenterY(PathCells[i]));
+			PointZones.push_back(nullptr);
+		}
+	}
+	if (Points[Points.size() - 2] != iToX || Points.back() != iToY)
+	{
+		Points.push_back(iToX); Points.push_back(iToY);
+		PointZones.push_back(nullptr);
+	}
+
+	if (Mode == GM_Walk)
+	{
+		rPoints = std::move(Points);
+		rPointZones = std::move(PointZones);
+		return FR_Found;
+	}
+
+	// drop points that can be skipped by a free line; zone transfers are kept
+	const size_t iCnt = PointZones.size();
+	rPoints.push_back(iFromX); rPoints.push_back(iFromY);
+	rPointZones.push_back(nullptr);
+	for (size_t i = 0; i + 1 < iCnt;)
+	{
+		size_t j = i + 1;
+		if (!PointZones[j])
+			while (j + 1 < iCnt && !PointZones[j + 1] && LineFree(Points[2 * i], Points[2 * i + 1], Points[2 * j + 2], Points[2 * j + 3]))
+				++j;
+		rPoints.push_back(Points[2 * j]); rPoints.push_back(Points[2 * j + 1]);
+		rPointZones.push_back(PointZones[j]);
+		i = j;
+	}
+	return FR_Found;
+}
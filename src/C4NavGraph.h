@@ -0,0 +1,155 @@
+/*
+ * LegacyClonk
+ *
+ * Copyright (c) 2026, The LegacyClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Coarse navigation graph of the landscape for hierarchical path searches */
+
+#pragma once
+
+#include <vector>
+
+class C4Rect;
+class C4TransferZone;
+class C4TransferZones;
+
+class C4NavGraph
+{
+public:
+	static const int32_t CellSize = 8; // landscape pixels per cell
+	static const int32_t ClusterSize = 16; // cells per cluster side
+	static const int32_t MaxRegions = ClusterSize * ClusterSize; // upper bound of regions per cluster
+	static const int32_t MaxSearchNodes = 40000; // node expansions per search
+
+	// movement of walking objects, in cells
+	static const int32_t JumpWidth = 3, JumpHeight = 4;
+	static const int32_t MaxFall = 40;
+
+	enum GraphMode
+	{
+		GM_Free, // free lines through the air, for flying and swimming objects
+		GM_Walk, // walkable surfaces, climbable walls, jumps and falls, for clonks
+	};
+
+	enum FindResult
+	{
+		FR_Found,
+		FR_NoPath, // start and target are not connected
+		FR_NoAttach, // start or target is in a gap too narrow for the graph or out of reach of a surface
+	};
+
+public:
+	C4NavGraph();
+	~C4NavGraph();
+
+protected:
+	// cell flags
+	enum
+	{
+		CellFree      = 1 << 0, // cell center is free
+		CellStand     = 1 << 1, // solid ground right below the center
+		CellWallLeft  = 1 << 2, // solid wall next to the center
+		CellWallRight = 1 << 3,
+		CellSupport   = CellStand | CellWallLeft | CellWallRight,
+	};
+
+	enum EdgeKind
+	{
+		EK_Line, // free line (GM_Free)
+		EK_Walk,
+		EK_Climb,
+		EK_Jump,
+		EK_Fall,
+	};
+
+	struct Edge
+	{
+		int32_t Cell, Cost;
+		EdgeKind Kind;
+	};
+
+	// cells of one cluster that are connected within the cluster
+	// (in either direction: jumps and falls are one-way, so not every cell of a region can reach all others)
+	struct Region
+	{
+		int32_t Cell; // representative cell near the region center
+		std::vector<int32_t> Portals; // cells of neighbouring clusters directly reachable from this region
+	};
+
+	struct Cluster
+	{
+		bool Dirty;
+		std::vector<Region> Regions;
+		std::vector<int32_t> EdgeStart; // first edge by cell within the cluster, plus end
+		std::vector<Edge> Edges; // edges starting in the cluster
+	};
+
+	// a transfer zone as used by one search
+	struct ZoneLink
+	{
+		C4TransferZone *Zone;
+		int32_t CellX1, CellY1, CellX2, CellY2; // cells touching the zone
+		int32_t ExitX, ExitY; // pixel position where the zone is left towards the target
+		int32_t ExitCell;
+		std::vector<int32_t> Regions; // regions touching the zone
+	};
+
+	GraphMode Mode;
+	bool(*PointFree)(int32_t, int32_t);
+	int32_t Width, Height; // size in cells
+	int32_t ClustersX, ClustersY;
+	std::vector<uint8_t> Cells;
+	std::vector<int32_t> CellRegions; // region id (cluster * MaxRegions + index) by cell; -1 for cells without region
+	std::vector<Cluster> Clusters;
+	bool AnyDirty;
+
+	// search buffers by cell, valid where SearchStamp matches the current search
+	std::vector<uint32_t> SearchStamp;
+	std::vector<int32_t> SearchCost, SearchFrom, SearchZone;
+	uint32_t CurrentStamp;
+
+public:
+	void Default();
+	void Clear();
+	void Init(GraphMode eMode, bool(*fnPointFree)(int32_t, int32_t), int32_t iLandscapeWdt, int32_t iLandscapeHgt);
+	bool IsInitialized() const { return !Cells.empty(); }
+	void Invalidate(int32_t iX, int32_t iY); // landscape pixel changed solidity
+	void Invalidate(const C4Rect &rRect);
+	// rPoints receives x/y pairs from start to target; rPointZones the zone used to reach each point
+	FindResult Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, C4TransferZones *pZones, std::vector<int32_t> &rPoints, std::vector<C4TransferZone *> &rPointZones);
+
+protected:
+	int32_t CellIndex(int32_t iX, int32_t iY) const { return iY * Width + iX; }
+	int32_t CenterX(int32_t iCell) const { return (iCell % Width) * CellSize + CellSize / 2; }
+	int32_t CenterY(int32_t iCell) const { return (iCell / Width) * CellSize + CellSize / 2; }
+	int32_t ClusterOf(int32_t iCell) const { return (iCell / Width) / ClusterSize * ClustersX + (iCell % Width) / ClusterSize; }
+	int32_t LocalIndex(int32_t iCell) const { return (iCell / Width) % ClusterSize * ClusterSize + (iCell % Width) % ClusterSize; }
+	const Region &GetRegion(int32_t iRegion) const { return Clusters[iRegion / MaxRegions].Regions[iRegion % MaxRegions]; }
+	bool IsFree(int32_t iX, int32_t iY) const; // cell position
+	uint8_t GetCell(int32_t iX, int32_t iY) const { return Inside<int32_t>(iX, 0, Width - 1) && Inside<int32_t>(iY, 0, Height - 1) ? Cells[CellIndex(iX, iY)] : 0; }
+	bool LineFree(int32_t iX1, int32_t iY1, int32_t iX2, int32_t iY2) const;
+	bool CellLineFree(int32_t iCell1, int32_t iCell2) const { return LineFree(CenterX(iCell1), CenterY(iCell1), CenterX(iCell2), CenterY(iCell2)); }
+	const Edge *EdgesBegin(int32_t iCell) const;
+	const Edge *EdgesEnd(int32_t iCell) const;
+	const Edge *FindEdge(int32_t iFromCell, int32_t iToCell) const;
+	void InvalidateCells(int32_t iCellX1, int32_t iCellY1, int32_t iCellX2, int32_t iCellY2);
+	void Update(); // rebuild dirty clusters
+	void BuildCells(int32_t iCluster);
+	void BuildEdges(int32_t iCluster);
+	void AddFreeEdges(int32_t iCell, std::vector<Edge> &rEdges) const;
+	void AddWalkEdges(int32_t iCell, std::vector<Edge> &rEdges) const;
+	void BuildRegions(int32_t iCluster);
+	int32_t AttachCell(int32_t iX, int32_t iY) const; // find cell directly reachable from pixel position
+	bool FindRegions(int32_t iFromCell, int32_t iToCell, const std::vector<ZoneLink> &rZones, std::vector<bool> &rCorridor);
+	bool FindCells(int32_t iFromCell, int32_t iToCell, const std::vector<ZoneLink> &rZones, const std::vector<bool> *pCorridor, std::vector<int32_t> &rCells, std::vector<int32_t> &rCellZones);
+};
@@ -2080,6 +2080,13 @@ bool C4NetIOSimpleUDP::Close()
 	if (fMultiCast)
 		CloseBroadcast();
 
+	// drop queued datagrams
+	{
+		CStdLock QueueLock(&SendQueueCSec);
+		SendQueue.clear();
+		SendQueueData.clear();
+	}
+
 	// close sockets
 	if (sock != INVALID_SOCKET)
 	{
@@ -2141,7 +2148,20 @@ bool C4NetIOSimpleUDP::Execute(int iMaxTime)
 	if (eWR == WR_Cancelled || eWR == WR_Timeout) return true;
 	assert(eWR == WR_Readable);
 
+	// answers generated by the callbacks are sent together
+	SendBatch Batch(*this);
+
 	// read packets from socket
+#ifdef HAVE_RECVMMSG
+	const bool fSuccess = ReadSocketBatched();
+#else
+	const bool fSuccess = ReadSocket();
+#endif
+	return Batch.End() && fSuccess;
+}
+
+bool C4NetIOSimpleUDP::ReadSocket()
+{
 	for (;;)
 	{
 		// how much can be read?
@@ -2165,6 +2185,7 @@ bool C4NetIOSimpleUDP::Execute(int iMaxTime)
 		// read data (note: it is _not_ garantueed that iMaxMsgSize bytes are available)
 		addr_t SrcAddr; socklen_t iSrcAddrLen{sizeof(sockaddr_in6)};
 		int iMsgSize = ::recvfrom(sock, getMBufPtr<char>(Pkt), iMaxMsgSize, 0, &SrcAddr, &iSrcAddrLen);
+		++iRecvCalls;
 		// error?
 		if (iMsgSize == SOCKET_ERROR)
 			if (HaveConnResetError())
@@ -2194,6 +2215,7 @@ bool C4NetIOSimpleUDP::Execute(int iMaxTime)
 		// fill in packet information
 		Pkt.SetSize(iMsgSize);
 		Pkt.SetAddr(SrcAddr);
+		++iRecvDatagrams;
 		// callback
 		if (pCB) pCB->OnPacket(Pkt, this);
 	}
@@ -2202,26 +2224,192 @@ bool C4NetIOSimpleUDP::Execute(int iMaxTime)
 	return true;
 }
 
+#ifdef HAVE_RECVMMSG
+
+bool C4NetIOSimpleUDP::ReadSocketBatched()
+{
+	// allocate receive buffers once
+	if (RecvBuffers[0].isNull())
+		for (auto &Buf : RecvBuffers)
+			Buf.New(MaxDatagramSize);
+
+	addr_t SrcAddrs[RecvBatchSize];
+	iovec IOVecs[RecvBatchSize];
+	mmsghdr Msgs[RecvBatchSize];
+
+	for (;;)
+	{
+		for (size_t i = 0; i < RecvBatchSize; ++i)
+		{
+			IOVecs[i].iov_base = getMBufPtr<char>(RecvBuffers[i]);
+			IOVecs[i].iov_len = RecvBuffers[i].getSize();
+			std::memset(&Msgs[i], 0, sizeof(Msgs[i]));
+			Msgs[i].msg_hdr.msg_name = static_cast<sockaddr *>(&SrcAddrs[i]);
+			Msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in6);
+			Msgs[i].msg_hdr.msg_iov = &IOVecs[i];
+			Msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		// read as many datagrams as are available (the socket is non-blocking)
+		const int iMsgCnt = ::recvmmsg(sock, Msgs, RecvBatchSize, 0, nullptr);
+		++iRecvCalls;
+		if (iMsgCnt == SOCKET_ERROR)
+		{
+			// nothing left to read
+			if (HaveWouldBlockError())
+				break;
+			// ICMP notification, see ReadSocket. recvmmsg doesn't tell the
+			// address in this case, so there is nobody to notify.
+			if (HaveConnResetError())
+				continue;
+			SetError("could not receive data from socket", true);
+			return false;
+		}
+		iRecvDatagrams += iMsgCnt;
+
+		for (int i = 0; i < iMsgCnt; ++i)
+		{
+			const socklen_t iSrcAddrLen{Msgs[i].msg_hdr.msg_namelen};
+			// invalid address?
+			if ((iSrcAddrLen != sizeof(sockaddr_in) && iSrcAddrLen != sizeof(sockaddr_in6)) || SrcAddrs[i].GetFamily() == addr_t::UnknownFamily)
+			{
+				SetError("recvmmsg returned an invalid address");
+				return false;
+			}
+			// empty or truncated datagrams are dropped
+			if (!Msgs[i].msg_len || (Msgs[i].msg_hdr.msg_flags & MSG_TRUNC))
+				continue;
+			// callback with a reference into the receive buffer
+			if (pCB) pCB->OnPacket(C4NetIOPacket(getBufPtr<char>(RecvBuffers[i]), Msgs[i].msg_len, false, SrcAddrs[i]), this);
+		}
+
+		// batch not filled? socket is drained
+		if (static_cast<size_t>(iMsgCnt) < RecvBatchSize)
+			break;
+	}
+
+	// ok
+	return true;
+}
+
+#endif // HAVE_RECVMMSG
+
 bool C4NetIOSimpleUDP::Send(const C4NetIOPacket &rPacket)
 {
 	if (!fInit) { SetError("not yet initialized"); return false; }
 
-	// send it
-	C4NetIO::addr_t addr = rPacket.getAddr();
-	if (::sendto(sock, getBufPtr<char>(rPacket), rPacket.getSize(), 0,
+	{
+		CStdLock QueueLock(&SendQueueCSec);
+		// batch open in this thread? queue it
+		if (SendBatchDepths.count(std::this_thread::get_id()))
+		{
+			const size_t iOffset = SendQueueData.size();
+			SendQueueData.insert(SendQueueData.end(), getBufPtr<uint8_t>(rPacket), getBufPtr<uint8_t>(rPacket) + rPacket.getSize());
+			SendQueue.push_back({iOffset, rPacket.getSize(), rPacket.getAddr()});
+		}
+		// send it
+		else if (!SendDatagram(rPacket.getData(), rPacket.getSize(), rPacket.getAddr()))
+			return false;
+	}
+
+	// ok
+	ResetError();
+	return true;
+}
+
+bool C4NetIOSimpleUDP::SendDatagram(const void *pData, size_t iSize, const addr_t &addr)
+{
+	++iSendCalls; ++iSentDatagrams;
+	if (::sendto(sock, static_cast<const char *>(pData), iSize, 0,
 		&addr, addr.GetAddrLen())
-		!= int(rPacket.getSize()) &&
+		!= int(iSize) &&
 		!HaveWouldBlockError())
 	{
 		SetError("socket sendto failed", true);
 		return false;
 	}
-
-	// ok
-	ResetError();
 	return true;
 }
 
+void C4NetIOSimpleUDP::BeginSendBatch() // (mt-safe)
+{
+	CStdLock QueueLock(&SendQueueCSec);
+	++SendBatchDepths[std::this_thread::get_id()];
+}
+
+bool C4NetIOSimpleUDP::EndSendBatch() // (mt-safe)
+{
+	CStdLock QueueLock(&SendQueueCSec);
+	const auto it = SendBatchDepths.find(std::this_thread::get_id());
+	assert(it != SendBatchDepths.end());
+	if (it == SendBatchDepths.end()) return true;
+	if (--it->second) return true;
+	SendBatchDepths.erase(it);
+	// other threads' datagrams can go along
+	return FlushSendQueue();
+}
+
+bool C4NetIOSimpleUDP::FlushSendQueue()
+{
+	// note: SendQueueCSec is held by the caller
+	if (SendQueue.empty()) return true;
+	bool fSuccess = true;
+	if (fInit)
+	{
+#ifdef HAVE_SENDMMSG
+		std::vector<iovec> IOVecs(SendQueue.size());
+		std::vector<mmsghdr> Msgs(SendQueue.size());
+		for (size_t i = 0; i < SendQueue.size(); ++i)
+		{
+			QueuedDatagram &Datagram = SendQueue[i];
+			IOVecs[i].iov_base = SendQueueData.data() + Datagram.Offset;
+			IOVecs[i].iov_len = Datagram.Size;
+			Msgs[i].msg_hdr.msg_name = static_cast<sockaddr *>(&Datagram.Addr);
+			Msgs[i].msg_hdr.msg_namelen = Datagram.Addr.GetAddrLen();
+			Msgs[i].msg_hdr.msg_iov = &IOVecs[i];
+			Msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+		for (size_t iSent = 0; iSent < Msgs.size(); )
+		{
+			const int iCnt = ::sendmmsg(sock, Msgs.data() + iSent, Msgs.size() - iSent, 0);
+			++iSendCalls;
+			if (iCnt == SOCKET_ERROR)
+			{
+				// buffer full: drop the rest, just like sendto would
+				if (!HaveWouldBlockError())
+				{
+					SetError("socket sendmmsg failed", true);
+					fSuccess = false;
+				}
+				break;
+			}
+			iSentDatagrams += iCnt;
+			iSent += iCnt;
+		}
+#else
+		for (const auto &Datagram : SendQueue)
+			fSuccess &= SendDatagram(SendQueueData.data() + Datagram.Offset, Datagram.Size, Datagram.Addr);
+#endif
+	}
+	// keep the capacity for the next batch
+	SendQueue.clear();
+	SendQueueData.clear();
+	return fSuccess;
+}
+
+void C4NetIOSimpleUDP::GetBatchStatistic(BatchStatistic &stat) const // (mt-safe)
+{
+	stat.SendCalls = iSendCalls;
+	stat.SentDatagrams = iSentDatagrams;
+	stat.RecvCalls = iRecvCalls;
+	stat.RecvDatagrams = iRecvDatagrams;
+}
+
+void C4NetIOSimpleUDP::ClearBatchStatistic() // (mt-safe)
+{
+	iSendCalls = iSentDatagrams = iRecvCalls = iRecvDatagrams = 0;
+}
+
 bool C4NetIOSimpleUDP::Broadcast(const C4NetIOPacket &rPacket)
 {
 	// just set broadcast address and send
@@ -2348,7 +2536,7 @@ void C4NetIOSimpleUDP::SetReUseAddress(bool fAllow)
 #define C4NETIOUDP_OPT_RECV_CHECK_IMMEDIATE
 
 // Protocol version
-const unsigned int C4NetIOUDP::iVersion = 2;
+const unsigned int C4NetIOUDP::iVersion = 3;
 
 // Standard timeout length
 const unsigned int C4NetIOUDP::iStdTimeout = 1000; // (ms)
@@ -2474,6 +2662,7 @@ struct C4NetIOUDP::DataPacketHdr : public PacketHdr
 struct C4NetIOUDP::CheckPacketHdr : public PacketHdr
 {
 	uint32_t AckNr, MCAckNr; // numbers of the last packets received
+	uint32_t FrgmAckNr; // number of the first fragment missing
 	uint32_t AskCount, MCAskCount;
 };
 
@@ -2736,16 +2925,29 @@ bool C4NetIOUDP::Execute(int iMaxTime) // (mt-safe)
 	if (iMaxTime == TO_INF || iMaxTime > iMaxBlock) iMaxTime = iMaxBlock;
 
 	// execute subclass
-	if (!C4NetIOSimpleUDP::Execute(iMaxBlock))
+	if (!C4NetIOSimpleUDP::Execute(iMaxTime))
 		return false;
 
-	// connection check needed?
-	if (iNextCheck <= timeGetTime())
-		DoCheck();
-	// client timeout?
-	for (Peer *pPeer = pPeerList; pPeer; pPeer = pPeer->Next)
-		if (!pPeer->Closed())
-			pPeer->CheckTimeout();
+	{
+		// acknowledgements, retransmissions and check packets are sent together
+		SendBatch Batch(*this);
+		// acknowledge data received, resend lost fragments
+		for (Peer *pPeer = pPeerList; pPeer; pPeer = pPeer->Next)
+			if (pPeer->Open())
+			{
+				pPeer->SendPendingAck();
+				pPeer->CheckWindow();
+			}
+		// connection check needed?
+		if (iNextCheck <= timeGetTime())
+			DoCheck();
+		// client timeout?
+		for (Peer *pPeer = pPeerList; pPeer; pPeer = pPeer->Next)
+			if (!pPeer->Closed())
+				pPeer->CheckTimeout();
+		if (!Batch.End())
+			return false;
+	}
 
 	// do a delayed loopback test once the incoming buffer is empty
 	if (fDelayedLoopbackTest)
@@ -2790,6 +2992,7 @@ bool C4NetIOUDP::Send(const C4NetIOPacket &rPacket) // (mt-safe)
 bool C4NetIOUDP::Broadcast(const C4NetIOPacket &rPacket) // (mt-safe)
 {
 	CStdShareLock PeerListLock(&PeerListCSec);
+	SendBatch Batch(*this);
 	// search: any client reachable via multicast?
 	Peer *pPeer;
 	for (pPeer = pPeerList; pPeer; pPeer = pPeer->Next)
@@ -2801,17 +3004,25 @@ bool C4NetIOUDP::Broadcast(const C4NetIOPacket &rPacket) // (mt-safe)
 		CStdLock OutLock(&OutCSec);
 		// send it via multicast: encapsulate packet
 		Packet *pPkt = new Packet(rPacket.Duplicate(), iOPacketCounter);
-		iOPacketCounter += pPkt->FragmentCnt();
+		const unsigned int iFragmentCnt = pPkt->FragmentCnt();
 		// add to list
-		OPackets.AddPacket(pPkt);
-		// send it
-		fSuccess &= BroadcastDirect(*pPkt);
+		if (OPackets.AddPacket(pPkt))
+		{
+			iOPacketCounter += iFragmentCnt;
+			// send it
+			fSuccess &= BroadcastDirect(*pPkt);
+		}
+		else
+		{
+			delete pPkt;
+			fSuccess = false;
+		}
 	}
 	// send to all clients connected via du, too
 	for (pPeer = pPeerList; pPeer; pPeer = pPeer->Next)
 		if (pPeer->Open() && !pPeer->MultiCast() && pPeer->doBroadcast())
 			pPeer->Send(rPacket);
-	return true;
+	return Batch.End();
 }
 
 bool C4NetIOUDP::SetBroadcast(const addr_t &addr, bool fSet) // (mt-safe)
@@ -2836,8 +3047,12 @@ int C4NetIOUDP::GetTimeout() // (mt-safe)
 	CStdShareLock PeerListLock(&PeerListCSec);
 	for (Peer *pPeer = pPeerList; pPeer; pPeer = pPeer->Next)
 		if (!pPeer->Closed())
+		{
 			if (pPeer->GetTimeout())
 				iTiming = (std::max)(std::min<int>(iTiming, int(pPeer->GetTimeout() - timeGetTime())), 0);
+			if (pPeer->GetRetransmitTime())
+				iTiming = (std::max)(std::min<int>(iTiming, int(pPeer->GetRetransmitTime() - timeGetTime())), 0);
+		}
 	// return timing value
 	return iTiming;
 }
@@ -2985,12 +3200,18 @@ C4NetIOUDP::Packet::~Packet()
 
 // implementation
 
-const size_t C4NetIOUDP::Packet::MaxSize = 512;
+// largest UDP payload that fits the minimum IPv6 MTU (1280 - 40 - 8), so fragments never need IP fragmentation
+const size_t C4NetIOUDP::Packet::MaxSize = 1232;
 const size_t C4NetIOUDP::Packet::MaxDataSize = MaxSize - sizeof(DataPacketHdr);
 
+C4NetIOUDP::Packet::nr_t C4NetIOUDP::Packet::FragmentCnt(size_t iSize)
+{
+	return iSize ? (iSize - 1) / MaxDataSize + 1 : 1;
+}
+
 C4NetIOUDP::Packet::nr_t C4NetIOUDP::Packet::FragmentCnt() const
 {
-	return Data.getSize() ? (Data.getSize() - 1) / MaxDataSize + 1 : 1;
+	return FragmentCnt(Data.getSize());
 }
 
 C4NetIOPacket C4NetIOUDP::Packet::GetFragment(nr_t iFNr, bool fBroadcastFlag) const
@@ -3199,6 +3420,10 @@ void C4NetIOUDP::PacketList::Clear()
 
 const unsigned int C4NetIOUDP::Peer::iConnectRetries = 5;
 const unsigned int C4NetIOUDP::Peer::iReCheckInterval = 1000; // (ms)
+const unsigned int C4NetIOUDP::Peer::iMinWindow = 16;
+const unsigned int C4NetIOUDP::Peer::iInitialWindow = 16;
+const unsigned int C4NetIOUDP::Peer::iMaxWindow = 4096; // (fragments)
+const unsigned int C4NetIOUDP::Peer::iMinRetransmitTimeout = 50; // (ms)
 
 // construction / destruction
 
@@ -3206,12 +3431,17 @@ C4NetIOUDP::Peer::Peer(const addr_t &naddr, C4NetIOUDP *pnParent)
 	: pParent(pnParent), addr(naddr),
 	eStatus(CS_None),
 	fMultiCast(false), fDoBroadcast(false),
-	iOPacketCounter(0),
+	iOPacketCounter(0), iOSentCounter(0), iOAckFrgmCounter(0),
 	iIPacketCounter(0), iRIPacketCounter(0),
 	iIMCPacketCounter(0), iRIMCPacketCounter(0),
 	OPackets(iMaxOPacketBacklog),
 	iMCAckPacketCounter(0),
 	iNextReCheck(0),
+	iWindow(iInitialWindow), iWindowGrowth(0), iSSThresh(iMaxWindow),
+	iNextWindowDecrease(0), iLastAckTime(0), iLastRetransmitTime(0),
+	iRTT(0), iRTTVar(0),
+	fRTTProbe(false), iRTTProbeNr(0), iRTTProbeTime(0),
+	fAckPending(false),
 	iIRate(0), iORate(0), iLoss(0)
 {
 }
@@ -3232,24 +3462,163 @@ bool C4NetIOUDP::Peer::Connect(bool fFailCallback) // (mt-safe)
 bool C4NetIOUDP::Peer::Send(const C4NetIOPacket &rPacket) // (mt-safe)
 {
 	CStdLock OutLock(&OutCSec);
-	// encapsulate packet
-	Packet *pnPacket = new Packet(rPacket.Duplicate(), iOPacketCounter);
-	iOPacketCounter += pnPacket->FragmentCnt();
-	pnPacket->GetData().SetAddr(addr);
-	// add it to outgoing packet stack
-	if (!OPackets.AddPacket(pnPacket))
+	// peer doesn't keep up? Give up like on lost packets, instead of queueing without limit
+	if (OQueue.size() >= iMaxOPacketBacklog)
+	{
+		Close("send queue overflow");
 		return false;
+	}
+	// queue packet, it gets its number once the congestion window allows sending it
+	OQueue.emplace_back(rPacket.Duplicate());
 	// This should be ensured by calling function anyway.
 	// It is not secure to send packets before the connection
 	// is etablished completly.
 	if (eStatus != CS_Works) return true;
 	// send it
-	if (!SendDirect(*pnPacket))
+	return SendQueued();
+}
+
+bool C4NetIOUDP::Peer::SendQueued() // (OutCSec must be held)
+{
+	SendBatch Batch(*pParent);
+	for (;;)
 	{
-		Close("failed to send packet");
-		return false;
+		// all numbered fragments sent? take the next packet
+		if (iOSentCounter == iOPacketCounter)
+		{
+			if (OQueue.empty()) break;
+			// don't start a packet that would not fit into the window
+			// (unless nothing is in flight, so large packets still get through)
+			const unsigned int iInFlight = iOSentCounter - iOAckFrgmCounter;
+			if (iInFlight && iInFlight + (std::min)(Packet::FragmentCnt(OQueue.front().getSize()), iWindow) > iWindow)
+				break;
+			// encapsulate packet
+			Packet *pnPacket = new Packet(std::move(OQueue.front()), iOPacketCounter);
+			OQueue.pop_front();
+			const unsigned int iFragmentCnt = pnPacket->FragmentCnt();
+			pnPacket->GetData().SetAddr(addr);
+			// add it to outgoing packet stack; numbers are only used up by packets in it
+			if (!OPackets.AddPacket(pnPacket))
+			{
+				delete pnPacket;
+				Close("failed to add packet to outgoing queue");
+				return false;
+			}
+			iOPacketCounter += iFragmentCnt;
+		}
+		// window full?
+		if (iOSentCounter - iOAckFrgmCounter >= iWindow)
+			break;
+		// send next fragment
+		const Packet *pPkt = OPackets.GetPacketFrgm(iOSentCounter);
+		if (!pPkt) { Close("packet lost from outgoing queue"); return false; }
+		if (!SendDirect(*pPkt, iOSentCounter))
+		{
+			Close("failed to send packet");
+			return false;
+		}
+		// measure round trip time
+		if (!fRTTProbe)
+		{
+			fRTTProbe = true;
+			iRTTProbeNr = iOSentCounter;
+			iRTTProbeTime = timeGetTime();
+		}
+		++iOSentCounter;
 	}
-	return true;
+	return Batch.End();
+}
+
+void C4NetIOUDP::Peer::OnAck(unsigned int iAckNr, unsigned int iAskCnt) // (OutCSec must be held)
+{
+	const unsigned int iNow = timeGetTime();
+	// new acknowledgement?
+	if (iAckNr > iOAckFrgmCounter && iAckNr <= iOSentCounter)
+	{
+		const unsigned int iAcked = iAckNr - iOAckFrgmCounter;
+		iOAckFrgmCounter = iAckNr;
+		iLastAckTime = iNow;
+		// round trip time sample (smoothed like TCP does)
+		if (fRTTProbe && iAckNr > iRTTProbeNr)
+		{
+			const unsigned int iSample = iNow - iRTTProbeTime;
+			if (!iRTT)
+			{
+				iRTT = (std::max)(iSample, 1u);
+				iRTTVar = iSample / 2;
+			}
+			else
+			{
+				iRTTVar = (3 * iRTTVar + (iSample > iRTT ? iSample - iRTT : iRTT - iSample)) / 4;
+				iRTT = (std::max)((7 * iRTT + iSample) / 8, 1u);
+			}
+			fRTTProbe = false;
+		}
+		// grow window: exponentially during slow start, then by one fragment per window
+		if (iWindow < iSSThresh)
+			iWindow += iAcked;
+		else
+		{
+			iWindowGrowth += iAcked;
+			while (iWindowGrowth >= iWindow)
+			{
+				iWindowGrowth -= iWindow;
+				++iWindow;
+			}
+		}
+		iWindow = (std::min)(iWindow, iMaxWindow);
+	}
+	// no progress for a while? the first missing fragment might have been lost again
+	// (the peer asks for it only once per iReCheckInterval)
+	else if (iAckNr == iOAckFrgmCounter && iOSentCounter != iOAckFrgmCounter && iNow > iLastAckTime + GetRetransmitTimeout())
+		Retransmit();
+	// peer asks for lost fragments?
+	if (iAskCnt)
+		OnLoss();
+}
+
+unsigned int C4NetIOUDP::Peer::GetRetransmitTimeout() const
+{
+	return iRTT ? (std::max)(iRTT + 4 * iRTTVar, iMinRetransmitTimeout) : iReCheckInterval;
+}
+
+unsigned int C4NetIOUDP::Peer::GetRetransmitTime() const
+{
+	// nothing in flight?
+	if (eStatus != CS_Works || iOSentCounter == iOAckFrgmCounter) return 0;
+	return (std::max)(iLastAckTime, iLastRetransmitTime) + GetRetransmitTimeout();
+}
+
+void C4NetIOUDP::Peer::Retransmit() // (OutCSec must be held)
+{
+	const unsigned int iNow = timeGetTime();
+	if (iNow < iLastRetransmitTime + GetRetransmitTimeout()) return;
+	iLastRetransmitTime = iNow;
+	// resend first unacknowledged fragment
+	const Packet *pPkt = OPackets.GetPacketFrgm(iOAckFrgmCounter);
+	if (pPkt) SendDirect(*pPkt, iOAckFrgmCounter);
+	OnLoss();
+}
+
+void C4NetIOUDP::Peer::OnLoss() // (OutCSec must be held)
+{
+	// the retransmitted probe would distort the round trip time
+	fRTTProbe = false;
+	// decrease window at most once per round trip
+	const unsigned int iNow = timeGetTime();
+	if (iNow < iNextWindowDecrease) return;
+	iSSThresh = (std::max)(iWindow / 2, iMinWindow);
+	iWindow = iSSThresh;
+	iWindowGrowth = 0;
+	iNextWindowDecrease = iNow + GetRetransmitTimeout();
+}
+
+void C4NetIOUDP::Peer::CheckWindow()
+{
+	CStdLock OutLock(&OutCSec);
+	// fragments in flight, but no acknowledgement for a while? resend
+	if (iOSentCounter != iOAckFrgmCounter && timeGetTime() > iLastAckTime + GetRetransmitTimeout())
+		Retransmit();
 }
 
 bool C4NetIOUDP::Peer::Check(bool fForceCheck)
@@ -3316,7 +3685,7 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 				// Notify peer that he has two addresses to reach this connection.
 				AddAddrPacket Pkt;
 				Pkt.StatusByte = IPID_AddAddr;
-				Pkt.Nr = iOPacketCounter;
+				Pkt.Nr = iOSentCounter;
 				Pkt.Addr = PeerAddr;
 				Pkt.NewAddr = pPkt->Addr;
 				SendDirect(C4NetIOPacket(&Pkt, sizeof(Pkt), false, addr));
@@ -3359,7 +3728,7 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 		bool fullyConnected = false;
 
 		nPack.StatusByte = IPID_ConnOK; // (always du, no mc experiments here)
-		nPack.Nr = fBroadcasted ? pParent->iOPacketCounter : iOPacketCounter;
+		nPack.Nr = fBroadcasted ? pParent->iOPacketCounter : iOSentCounter;
 		nPack.Addr = addr;
 		if (fBroadcasted)
 			nPack.MCMode = ConnOKPacket::MCM_MCOK; // multicast send ok
@@ -3428,6 +3797,8 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 		// add the fragment
 		if (pPkt->AddFragment(rPacket, addr))
 		{
+			// acknowledge it (see C4NetIOUDP::Execute)
+			if (!fBroadcasted) fAckPending = true;
 			// add the packet to list
 			if (fAddPacket) if (!pPacketList->AddPacket(pPkt)) { delete pPkt; break; }
 			// check for complete packets
@@ -3449,6 +3820,7 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 		// clear all acknowledged packets
 		CStdLock OutLock(&OutCSec);
 		OPackets.ClearPackets(pPkt->AckNr);
+		if (!fBroadcasted) OnAck(pPkt->FrgmAckNr, pPkt->AskCount);
 		if (pPkt->MCAckNr > iMCAckPacketCounter)
 		{
 			iMCAckPacketCounter = pPkt->MCAckNr;
@@ -3465,6 +3837,8 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 			bool fMCPacket = i >= pPkt->AskCount;
 			CStdLock OutLock(fMCPacket ? &pParent->OutCSec : &OutCSec);
 			Packet *pPkt2Send = (fMCPacket ? pParent->OPackets : OPackets).GetPacketFrgm(pAskList[i]);
+			// acknowledged meanwhile? (check packets may arrive out of order)
+			if (!pPkt2Send && !fMCPacket && static_cast<unsigned int>(pAskList[i]) < iOAckFrgmCounter) continue;
 			if (!pPkt2Send) { Close("starvation"); break; }
 			// send the fragment
 			if (fMCPacket)
@@ -3472,6 +3846,12 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 			else
 				SendDirect(*pPkt2Send, pAskList[i]);
 		}
+		// window might have grown
+		if (eStatus == CS_Works)
+		{
+			CStdLock OutLock(&OutCSec);
+			SendQueued();
+		}
 	}
 	break;
 
@@ -3527,11 +3907,21 @@ bool C4NetIOUDP::Peer::DoConn(bool fMC) // (mt-safe)
 	eStatus = CS_Conn;
 	// set timeout
 	SetTimeout(iStdTimeout, iConnectRetries);
+	// fragments sent but not acknowledged yet are lost on (re)connect; a partially sent
+	// packet starts over, so its fragments that are numbered but not sent yet aren't skipped
+	unsigned int iStartNr = iOPacketCounter;
+	if (!fMC)
+	{
+		CStdLock OutLock(&OutCSec);
+		const Packet *pPkt = iOSentCounter != iOPacketCounter ? OPackets.GetPacketFrgm(iOSentCounter) : nullptr;
+		iStartNr = iOSentCounter = iOAckFrgmCounter = pPkt ? pPkt->GetNr() : iOPacketCounter;
+		fRTTProbe = false;
+	}
 	// send packet (include current outgoing packet counter and mc addr)
 	ConnPacket Pkt;
 	Pkt.StatusByte = IPID_Conn | (fMC ? 0x80 : 0x00);
 	Pkt.ProtocolVer = pParent->iVersion;
-	Pkt.Nr = fMC ? pParent->iOPacketCounter : iOPacketCounter;
+	Pkt.Nr = fMC ? pParent->iOPacketCounter : iStartNr;
 	Pkt.Addr = addr;
 	if (pParent->fMultiCast)
 		Pkt.MCAddr = pParent->C4NetIOSimpleUDP::getMCAddr();
@@ -3552,28 +3942,41 @@ bool C4NetIOUDP::Peer::DoCheck(int iAskCnt, int iMCAskCnt, unsigned int *pAskLis
 	CheckPacketHdr *pChkPkt = getMBufPtr<CheckPacketHdr>(Packet);
 	// set up header
 	pChkPkt->StatusByte = IPID_Check; // (note: always du here, see C4NetIOUDP::DoCheck)
-	pChkPkt->Nr = iOPacketCounter;
+	pChkPkt->Nr = iOSentCounter;
 	pChkPkt->AckNr = iIPacketCounter;
 	pChkPkt->MCAckNr = iIMCPacketCounter;
+	// fragments received in order (used for congestion control)
+	pChkPkt->FrgmAckNr = iIPacketCounter;
+	while (pChkPkt->FrgmAckNr < iRIPacketCounter && IPackets.FragmentPresent(pChkPkt->FrgmAckNr))
+		++pChkPkt->FrgmAckNr;
 	// copy ask list
 	pChkPkt->AskCount = iAskCnt;
 	pChkPkt->MCAskCount = iMCAskCnt;
 	if (pAskList)
 		Packet.Write(pAskList, iAskListSize, sizeof(CheckPacketHdr));
 	// send packet
+	fAckPending = false;
 	return SendDirect(C4NetIOPacket(Packet, addr));
 }
 
+bool C4NetIOUDP::Peer::SendPendingAck()
+{
+	if (!fAckPending) return true;
+	// ask for fragments missing so far right away, so holes don't stall the sender's window
+	return Check(true);
+}
+
 bool C4NetIOUDP::Peer::SendDirect(const Packet &rPacket, unsigned int iNr)
 {
 	// send one fragment only?
 	if (iNr + 1)
 		return SendDirect(rPacket.GetFragment(iNr - rPacket.GetNr()));
 	// otherwise: send all fragments
+	SendBatch Batch(*pParent);
 	bool fSuccess = true;
 	for (unsigned int i = 0; i < rPacket.FragmentCnt(); i++)
 		fSuccess &= SendDirect(rPacket.GetFragment(i));
-	return fSuccess;
+	return Batch.End() && fSuccess;
 }
 
 bool C4NetIOUDP::Peer::SendDirect(C4NetIOPacket &&rPacket) // (mt-safe)
@@ -3593,6 +3996,12 @@ void C4NetIOUDP::Peer::OnConn()
 	SetTimeout(TO_INF);
 	// set status
 	eStatus = CS_Works;
+	iLastAckTime = timeGetTime();
+	// send packets queued while connecting
+	{
+		CStdLock OutLock(&OutCSec);
+		if (!SendQueued()) return;
+	}
 	// do callback
 	C4NetIO::CBClass *pCB = pParent->pCB;
 	if (pCB && !pCB->OnConn(addr, addr, &PeerAddr, pParent))
@@ -3695,10 +4104,11 @@ bool C4NetIOUDP::BroadcastDirect(const Packet &rPacket, unsigned int iNr) // (mt
 	if (iNr + 1)
 		return SendDirect(rPacket.GetFragment(iNr - rPacket.GetNr(), true));
 	// send all fragments
+	SendBatch Batch(*this);
 	bool fSuccess = true;
 	for (unsigned int iFrgm = 0; iFrgm < rPacket.FragmentCnt(); iFrgm++)
 		fSuccess &= SendDirect(rPacket.GetFragment(iFrgm, true));
-	return fSuccess;
+	return Batch.End() && fSuccess;
 }
 
 bool C4NetIOUDP::SendDirect(C4NetIOPacket &&rPacket) // (mt-safe)
@@ -3868,6 +4278,7 @@ void C4NetIOUDP::DoCheck() // (mt-safe)
 			CheckPacketHdr Pkt;
 			Pkt.StatusByte = IPID_Check | 0x80;
 			Pkt.Nr = iOPacketCounter;
+			Pkt.AckNr = Pkt.MCAckNr = Pkt.FrgmAckNr = 0;
 			Pkt.AskCount = Pkt.MCAskCount = 0;
 			// send it
 			SendDirect(C4NetIOPacket(&Pkt, sizeof(Pkt)));
@@ -3984,7 +4395,7 @@ void C4NetIOUDP::DebugLogPkt(bool fOut, const C4NetIOPacket &Pkt)
 		case IPID_Check:
 		{
 			UPACK(CheckPacketHdr);
-			O.AppendFormat(" (ack: %d, mcack: %d, ask: %d mcask: %d, ", P.AckNr, P.MCAckNr, P.AskCount, P.MCAskCount);
+			O.AppendFormat(" (ack: %d, mcack: %d, frgmack: %d, ask: %d mcask: %d, ", P.AckNr, P.MCAckNr, P.FrgmAckNr, P.AskCount, P.MCAskCount);
 			if (Pkt.getSize() < sizeof(CheckPacketHdr) + sizeof(unsigned int) * (P.AskCount + P.MCAskCount))
 				O.AppendFormat("too small)");
 			else
@@ -25,7 +25,11 @@
 #include "StdCompiler.h"
 #include "StdScheduler.h"
 
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #ifdef _WIN32
@@ -549,12 +553,70 @@ public:
 
 	virtual void ClearStatistic() override { assert(false); }
 
+	// send batching: datagrams a thread sends while it has a batch open are queued and
+	// flushed with as few syscalls as possible when its outermost batch is closed (mt-safe)
+	void BeginSendBatch();
+	bool EndSendBatch();
+
+	class SendBatch
+	{
+	public:
+		SendBatch(C4NetIOSimpleUDP &netIO) : netIO(netIO) { netIO.BeginSendBatch(); }
+		~SendBatch() { End(); } // failures are still set as error of the network IO
+
+		SendBatch(const SendBatch &) = delete;
+		SendBatch &operator=(const SendBatch &) = delete;
+
+		// close batch early to get the result of the flush
+		bool End()
+		{
+			if (fEnded) return true;
+			fEnded = true;
+			return netIO.EndSendBatch();
+		}
+
+	private:
+		C4NetIOSimpleUDP &netIO;
+		bool fEnded{false};
+	};
+
+	// datagrams per syscall
+	struct BatchStatistic
+	{
+		unsigned int SendCalls, SentDatagrams;
+		unsigned int RecvCalls, RecvDatagrams;
+	};
+
+	void GetBatchStatistic(BatchStatistic &stat) const; // (mt-safe)
+	void ClearBatchStatistic(); // (mt-safe)
+
 private:
 	// status
 	bool fInit;
 	bool fMultiCast;
 	uint16_t iPort;
 
+	// queued outgoing datagrams
+	struct QueuedDatagram
+	{
+		size_t Offset, Size;
+		addr_t Addr;
+	};
+
+	CStdCSec SendQueueCSec;
+	std::unordered_map<std::thread::id, int> SendBatchDepths; // open batches per thread
+	std::vector<uint8_t> SendQueueData;
+	std::vector<QueuedDatagram> SendQueue;
+
+	// preallocated receive buffers for batched reads
+	static const size_t RecvBatchSize = 16;
+	static const size_t MaxDatagramSize = 65536;
+	C4NetIOPacket RecvBuffers[RecvBatchSize];
+
+	// statistics
+	std::atomic<unsigned int> iSendCalls{0}, iSentDatagrams{0};
+	std::atomic<unsigned int> iRecvCalls{0}, iRecvDatagrams{0};
+
 	// the socket and the associated event
 	SOCKET sock{INVALID_SOCKET};
 #ifdef STDSCHEDULER_USE_EVENTS
@@ -586,6 +648,11 @@ private:
 	enum WaitResult { WR_Timeout, WR_Readable, WR_Cancelled, WR_Error = -1, };
 	WaitResult WaitForSocket(int iTimeout);
 
+	bool ReadSocket();
+	bool ReadSocketBatched();
+	bool SendDatagram(const void *pData, size_t iSize, const addr_t &addr);
+	bool FlushSendQueue();
+
 	// *** callbacks
 public:
 	virtual void SetCallback(CBClass *pnCallback) override { pCB = pnCallback; }
@@ -597,6 +664,7 @@ private:
 // udp network i/o
 // - Connection are emulated
 // - Delivery garantueed
+// - Congestion control per peer (AIMD window, in fragments)
 // - Broadcast will automatically be activated on one side if it's active on the other side.
 //   If the peer can't be reached through broadcasting, packets will be sent directly.
 class C4NetIOUDP : public C4NetIOSimpleUDP, protected CStdCSecExCallback
@@ -650,7 +718,7 @@ protected:
 	struct DataPacketHdr; struct CheckPacketHdr; struct ClosePacket;
 
 	// constants
-	static const unsigned int iVersion; // = 2;
+	static const unsigned int iVersion; // = 3;
 
 	static const unsigned int iStdTimeout, // = 1000, // (ms)
 		iCheckInterval; // = 1000 // (ms)
@@ -667,7 +735,7 @@ protected:
 
 	public:
 		// constants / structures
-		static const size_t MaxSize; // = 1024;
+		static const size_t MaxSize; // = 1232;
 		static const size_t MaxDataSize; // = MaxSize - sizeof(Header);
 
 		// types used for packing
@@ -692,6 +760,7 @@ protected:
 		bool                 Empty()   const { return Data.isNull(); }
 
 		// fragmention
+		static nr_t   FragmentCnt(size_t iSize);
 		nr_t          FragmentCnt() const;
 		C4NetIOPacket GetFragment(nr_t iFNr, bool fBroadcastFlag = false) const;
 		bool          Complete() const;
@@ -746,6 +815,10 @@ protected:
 		// constants
 		static const unsigned int iConnectRetries; // = 5
 		static const unsigned int iReCheckInterval; // = 1000 (ms)
+		static const unsigned int iMinWindow, // = 16
+			iInitialWindow, // = 16
+			iMaxWindow; // = 4096 (fragments)
+		static const unsigned int iMinRetransmitTimeout; // = 50 (ms)
 
 		// parent class
 		C4NetIOUDP *const pParent;
@@ -773,8 +846,11 @@ protected:
 		PacketList OPackets;
 		PacketList IPackets, IMCPackets;
 
+		// outgoing packets not numbered yet
+		std::deque<C4NetIOPacket> OQueue;
+
 		// packet counters
-		unsigned int iOPacketCounter;
+		unsigned int iOPacketCounter, iOSentCounter, iOAckFrgmCounter;
 		unsigned int iIPacketCounter, iRIPacketCounter;
 		unsigned int iIMCPacketCounter, iRIMCPacketCounter;
 
@@ -791,6 +867,17 @@ protected:
 		unsigned int iTimeout;
 		unsigned int iRetries;
 
+		// congestion control: window (fragments), slow start threshold
+		unsigned int iWindow, iWindowGrowth, iSSThresh;
+		unsigned int iNextWindowDecrease, iLastAckTime, iLastRetransmitTime;
+		// smoothed round trip time (ms) and its variance
+		unsigned int iRTT, iRTTVar;
+		bool fRTTProbe;
+		unsigned int iRTTProbeNr, iRTTProbeTime;
+
+		// incoming data not acknowledged yet
+		bool fAckPending;
+
 		// statistics
 		int iIRate, iORate, iLoss;
 		CStdCSec StatCSec;
@@ -807,6 +894,10 @@ protected:
 		bool Send(const C4NetIOPacket &rPacket);
 		// check for lost packets
 		bool Check(bool fForceCheck = true);
+		// acknowledge received data
+		bool SendPendingAck();
+		// resend lost fragments if acknowledgements stall
+		void CheckWindow();
 
 		// called if something from this peer was received
 		void OnRecv(const C4NetIOPacket &Packet);
@@ -825,6 +916,7 @@ protected:
 
 		// timeout checking
 		int GetTimeout() { return iTimeout; }
+		unsigned int GetRetransmitTime() const;
 		void CheckTimeout();
 
 		// selected for broadcast?
@@ -848,6 +940,13 @@ protected:
 		// sending
 		bool SendDirect(const Packet &rPacket, unsigned int iNr = ~0);
 		bool SendDirect(C4NetIOPacket &&rPacket);
+		bool SendQueued();
+
+		// congestion control
+		void OnAck(unsigned int iAckNr, unsigned int iAskCnt);
+		void OnLoss();
+		unsigned int GetRetransmitTimeout() const;
+		void Retransmit();
 
 		// events
 		void OnConn();
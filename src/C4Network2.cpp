@@ -1127,6 +1127,14 @@ void C4Network2::DrawStatus(C4FacetEx &cgo)
 	else
 		Stat.Append("|Protocols: none");
 
+	// udp datagrams per syscall
+	if (NetIO.hasUDP())
+	{
+		const auto &BatchStat = NetIO.getUDPBatchStat();
+		Stat.AppendFormat("|UDP batching: %u datagrams in %u sends, %u datagrams in %u receives",
+			BatchStat.SentDatagrams, BatchStat.SendCalls, BatchStat.RecvDatagrams, BatchStat.RecvCalls);
+	}
+
 	// some control statistics
 	Stat.AppendFormat("|Control: %s, Tick %d, Behind %d, Rate %d, PreSend %d, ACT: %d",
 		Status.getCtrlMode() == CNM_Decentral ? "Decentral" : Status.getCtrlMode() == CNM_Central ? "Central" : "Async",
@@ -2924,7 +2932,8 @@ bool C4Network2::FinishStreaming()
 {
 	if (!fStreaming) return false;
 
-	// Stream
+	// Stream (wait for the record writer first)
+	if (pStreamedRecord) pStreamedRecord->Flush();
 	StreamIn(true);
 
 	// Reset record pointer
@@ -55,7 +55,8 @@ C4Network2IO::C4Network2IO()
 	pAutoAcceptList(nullptr),
 	iLastPing(0), iLastExecute(0), iLastStatistic(0),
 	iTCPIRate(0), iTCPORate(0), iTCPBCRate(0),
-	iUDPIRate(0), iUDPORate(0), iUDPBCRate(0)
+	iUDPIRate(0), iUDPORate(0), iUDPBCRate(0),
+	UDPBatchStat{}
 {
 }
 
@@ -73,6 +74,7 @@ bool C4Network2IO::Init(int16_t iPortTCP, int16_t iPortUDP, int16_t iPortDiscove
 	iLastPing = iLastStatistic = timeGetTime();
 	iTCPIRate = iTCPORate = iTCPBCRate = 0;
 	iUDPIRate = iUDPORate = iUDPBCRate = 0;
+	UDPBatchStat = {};
 
 	// init event callback
 	C4InteractiveThread &Thread = Application.InteractiveThread;
@@ -1215,6 +1217,14 @@ void C4Network2IO::GenerateStatistics(int iInterval)
 	inTCPBCRate = inTCPBCRate * 1000 / iInterval;
 	inUDPBCRate = inUDPBCRate * 1000 / iInterval;
 
+	// get udp batching statistics
+	if (pNetIO_UDP)
+	{
+		auto *const pSimpleUDP = static_cast<C4NetIOSimpleUDP *>(pNetIO_UDP);
+		pSimpleUDP->GetBatchStatistic(UDPBatchStat);
+		pSimpleUDP->ClearBatchStatistic();
+	}
+
 	// clear
 	if (pNetIO_TCP) pNetIO_TCP->ClearStatistic();
 	if (pNetIO_UDP) pNetIO_UDP->ClearStatistic();
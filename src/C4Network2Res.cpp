@@ -86,12 +86,16 @@ void C4Network2ResCore::Set(C4Network2ResType enType, int32_t iResID, const char
 	fLoadable = false;
 	iFileSize = iFileCRC = ~0; iContentsCRC = inContentsCRC;
 	iChunkSize = C4NetResChunkSize;
+	ChunkCRCs.clear();
 	FileName.Copy(strFileName);
 	Author.Copy(strAuthor);
 }
 
 void C4Network2ResCore::SetLoadable(uint32_t iSize, uint32_t iCRC)
 {
+	// chunk checksums belong to the old file
+	if (iSize != iFileSize || iCRC != iFileCRC)
+		ChunkCRCs.clear();
 	fLoadable = true;
 	iFileSize = iSize;
 	iFileCRC = iCRC;
@@ -106,6 +110,7 @@ void C4Network2ResCore::Clear()
 	Author.Clear();
 	iFileSize = iFileCRC = iContentsCRC = ~0;
 	fHasFileSHA = false;
+	ChunkCRCs.clear();
 }
 
 // C4PacketBase virtuals
@@ -122,6 +127,9 @@ void C4Network2ResCore::CompileFunc(StdCompiler *pComp)
 		pComp->Value(mkNamingAdapt(iFileCRC,   "FileCRC",   0U));
 		pComp->Value(mkNamingAdapt(iChunkSize, "ChunkSize", C4NetResChunkSize));
 		if (!iChunkSize) pComp->excCorrupt("zero chunk size");
+		if (getChunkCnt() > static_cast<uint32_t>(C4NetResMaxChunkCnt)) pComp->excCorrupt("too many chunks");
+		pComp->Value(mkNamingAdapt(mkSTLContainerAdapt(ChunkCRCs), "ChunkCRCs", std::vector<uint32_t>()));
+		if (!ChunkCRCs.empty() && !hasChunkCRCs()) pComp->excCorrupt("chunk checksum count mismatch");
 	}
 	pComp->Value(mkNamingAdapt(iContentsCRC,     "ContentsCRC", 0U));
 	pComp->Value(mkNamingCountAdapt(fHasFileSHA, "FileSHA"));
@@ -146,17 +154,12 @@ bool C4Network2ResLoad::CheckTimeout()
 // *** C4Network2ResChunkData
 
 C4Network2ResChunkData::C4Network2ResChunkData()
-	: iChunkCnt(0), iPresentChunkCnt(0),
-	pChunkRanges(nullptr), iChunkRangeCnt(0) {}
+	: iChunkCnt(0), iPresentChunkCnt(0) {}
 
 C4Network2ResChunkData::C4Network2ResChunkData(const C4Network2ResChunkData &Data2)
 	: C4PacketBase(Data2),
-	iChunkCnt(Data2.getChunkCnt()), iPresentChunkCnt(0),
-	pChunkRanges(nullptr), iChunkRangeCnt(0)
-{
-	// add ranges
-	Merge(Data2);
-}
+	iChunkCnt(Data2.iChunkCnt), iPresentChunkCnt(Data2.iPresentChunkCnt),
+	Present(Data2.Present) {}
 
 C4Network2ResChunkData::~C4Network2ResChunkData()
 {
@@ -165,29 +168,25 @@ C4Network2ResChunkData::~C4Network2ResChunkData()
 
 C4Network2ResChunkData &C4Network2ResChunkData::operator=(const C4Network2ResChunkData &Data2)
 {
-	// clear, merge
-	SetIncomplete(Data2.getChunkCnt());
-	Merge(Data2);
+	iChunkCnt = Data2.iChunkCnt;
+	iPresentChunkCnt = Data2.iPresentChunkCnt;
+	Present = Data2.Present;
 	return *this;
 }
 
 void C4Network2ResChunkData::SetIncomplete(int32_t inChunkCnt)
 {
 	Clear();
-	// just set total chunk count
+	// set total chunk count, no chunk present
 	iChunkCnt = inChunkCnt;
+	Present.assign((iChunkCnt + 31) / 32, 0);
 }
 
 void C4Network2ResChunkData::SetComplete(int32_t inChunkCnt)
 {
-	Clear();
-	// set total chunk count
-	iPresentChunkCnt = iChunkCnt = inChunkCnt;
-	// create one range
-	ChunkRange *pRange = new ChunkRange;
-	pRange->Start = 0; pRange->Length = iChunkCnt;
-	pRange->Next = nullptr;
-	pChunkRanges = pRange;
+	SetIncomplete(inChunkCnt);
+	// set all chunks
+	AddChunkRange(0, iChunkCnt);
 }
 
 void C4Network2ResChunkData::AddChunk(int32_t iChunk)
@@ -198,143 +197,119 @@ void C4Network2ResChunkData::AddChunk(int32_t iChunk)
 void C4Network2ResChunkData::AddChunkRange(int32_t iStart, int32_t iLength)
 {
 	// security
-	if (iStart < 0 || iStart + iLength > iChunkCnt || iLength <= 0) return;
-	// find position
-	ChunkRange *pRange, *pPrev;
-	for (pRange = pChunkRanges, pPrev = nullptr; pRange; pPrev = pRange, pRange = pRange->Next)
-		if (pRange->Start >= iStart)
-			break;
-	// create new
-	ChunkRange *pNew = new ChunkRange;
-	pNew->Start = iStart; pNew->Length = iLength;
-	// add to list
-	pNew->Next = pRange;
-	(pPrev ? pPrev->Next : pChunkRanges) = pNew;
-	// counts
-	iPresentChunkCnt += iLength; iChunkRangeCnt++;
-	// check merges
-	if (pPrev && MergeRanges(pPrev))
-		while (MergeRanges(pPrev));
-	else
-		while (MergeRanges(pNew));
+	if (iStart < 0 || iLength <= 0 || iLength > iChunkCnt - iStart) return;
+	// set bits
+	for (int32_t i = iStart; i < iStart + iLength; i++)
+		if (!isPresent(i))
+		{
+			Present[i / 32] |= 1u << (i % 32);
+			iPresentChunkCnt++;
+		}
 }
 
-void C4Network2ResChunkData::Merge(const C4Network2ResChunkData &Data2)
+void C4Network2ResChunkData::RemoveChunk(int32_t iChunk)
 {
-	// must have same basis chunk count
-	assert(iChunkCnt == Data2.getChunkCnt());
-	// add ranges
-	for (ChunkRange *pRange = Data2.pChunkRanges; pRange; pRange = pRange->Next)
-		AddChunkRange(pRange->Start, pRange->Length);
+	// security
+	if (iChunk < 0 || iChunk >= iChunkCnt) return;
+	// clear bit
+	if (isPresent(iChunk))
+	{
+		Present[iChunk / 32] &= ~(1u << (iChunk % 32));
+		iPresentChunkCnt--;
+	}
 }
 
-void C4Network2ResChunkData::Clear()
+void C4Network2ResChunkData::Merge(const C4Network2ResChunkData &Data2)
 {
-	iChunkCnt = iPresentChunkCnt = iChunkRangeCnt = 0;
-	// remove all ranges
-	while (pChunkRanges)
+	// must have same basis chunk count
+	assert(iChunkCnt == Data2.getChunkCnt());
+	// add chunks
+	for (size_t i = 0; i < Present.size(); i++)
 	{
-		ChunkRange *pDelete = pChunkRanges;
-		pChunkRanges = pDelete->Next;
-		delete pDelete;
+		uint32_t iNew = Data2.Present[i] & ~Present[i];
+		Present[i] |= iNew;
+		for (; iNew; iNew &= iNew - 1)
+			iPresentChunkCnt++;
 	}
 }
 
-int32_t C4Network2ResChunkData::GetChunkToRetrieve(const C4Network2ResChunkData &Available, int32_t iLoadingCnt, int32_t *pLoading) const
-{
-	// (this version is highly calculation-intensitive, yet the most satisfactory
-	//  solution I could find)
-
-	// find everything that should not be retrieved
-	C4Network2ResChunkData ChData; Available.GetNegative(ChData);
-	ChData.Merge(*this);
-	for (int32_t i = 0; i < iLoadingCnt; i++)
-		ChData.AddChunk(pLoading[i]);
-	// nothing to retrieve?
-	if (ChData.isComplete()) return -1;
-	// invert to get everything that should be retrieved
-	C4Network2ResChunkData ChData2; ChData.GetNegative(ChData2);
-	// select chunk (random)
-	int32_t iRetrieveChunk = SafeRandom(ChData2.getPresentChunkCnt());
-	// return
-	return ChData2.getPresentChunk(iRetrieveChunk);
-}
-
-bool C4Network2ResChunkData::MergeRanges(ChunkRange *pRange)
-{
-	// no next entry?
-	if (!pRange || !pRange->Next) return false;
-	// do merge?
-	ChunkRange *pNext = pRange->Next;
-	if (pRange->Start + pRange->Length < pNext->Start) return false;
-	// get overlap
-	int32_t iOverlap = (std::min)((pRange->Start + pRange->Length) - pNext->Start, pNext->Length);
-	// set new chunk range
-	pRange->Length += pNext->Length - iOverlap;
-	// remove range
-	pRange->Next = pNext->Next;
-	delete pNext;
-	// counts
-	iChunkRangeCnt--; iPresentChunkCnt -= iOverlap;
-	// ok
-	return true;
+void C4Network2ResChunkData::Clear()
+{
+	iChunkCnt = iPresentChunkCnt = 0;
+	Present.clear();
 }
 
-void C4Network2ResChunkData::GetNegative(C4Network2ResChunkData &Target) const
+int32_t C4Network2ResChunkData::GetChunkToRetrieve(const C4Network2ResChunkData &Available, const C4Network2ResChunkData &Loading, const int32_t *pSourceCnt) const
 {
-	// clear target
-	Target.SetIncomplete(iChunkCnt);
-	// add all ranges that are missing
-	int32_t iFreeStart = 0;
-	for (ChunkRange *pRange = pChunkRanges; pRange; pRange = pRange->Next)
+	assert(Available.getChunkCnt() == iChunkCnt && Loading.getChunkCnt() == iChunkCnt);
+	// select the chunk the fewest clients have (so all sources get busy and rare chunks
+	// spread early), choose randomly among equally rare ones
+	int32_t iRetrieveChunk = -1, iMinSourceCnt = 0, iCandidateCnt = 0;
+	for (size_t i = 0; i < Present.size(); i++)
 	{
-		// add range
-		Target.AddChunkRange(iFreeStart, pRange->Start - iFreeStart);
-		// safe new start
-		iFreeStart = pRange->Start + pRange->Length;
+		// chunks that should be retrieved
+		uint32_t iWanted = Available.Present[i] & ~Present[i] & ~Loading.Present[i];
+		for (int32_t j = 0; iWanted; j++, iWanted >>= 1)
+			if (iWanted & 1)
+			{
+				int32_t iChunk = i * 32 + j;
+				int32_t iSourceCnt = pSourceCnt ? pSourceCnt[iChunk] : 0;
+				if (iRetrieveChunk < 0 || iSourceCnt < iMinSourceCnt)
+				{
+					iRetrieveChunk = iChunk; iMinSourceCnt = iSourceCnt; iCandidateCnt = 1;
+				}
+				else if (iSourceCnt == iMinSourceCnt && !SafeRandom(++iCandidateCnt))
+					iRetrieveChunk = iChunk;
+			}
 	}
-	// add last range
-	Target.AddChunkRange(iFreeStart, iChunkCnt - iFreeStart);
+	return iRetrieveChunk;
 }
 
-int32_t C4Network2ResChunkData::getPresentChunk(int32_t iNr) const
+int32_t C4Network2ResChunkData::getNextChunk(int32_t iStart, bool fPresent) const
 {
-	for (ChunkRange *pRange = pChunkRanges; pRange; pRange = pRange->Next)
-		if (iNr < pRange->Length)
-			return iNr + pRange->Start;
-		else
-			iNr -= pRange->Length;
-	return -1;
+	while (iStart < iChunkCnt && isPresent(iStart) != fPresent)
+		iStart++;
+	return iStart;
 }
 
 void C4Network2ResChunkData::CompileFunc(StdCompiler *pComp)
 {
 	bool fCompiler = pComp->isCompiler();
-	if (fCompiler) Clear();
-	// Data
-	pComp->Value(mkNamingAdapt(mkIntPackAdapt(iChunkCnt),      "ChunkCnt",      0));
-	pComp->Value(mkNamingAdapt(mkIntPackAdapt(iChunkRangeCnt), "ChunkRangeCnt", 0));
+	// Data (present chunks are packed as ranges)
+	int32_t iCnt = iChunkCnt, iRangeCnt = 0;
+	if (!fCompiler)
+		for (int32_t iStart = getNextChunk(0, true); iStart < iChunkCnt; iStart = getNextChunk(getNextChunk(iStart, false), true))
+			iRangeCnt++;
+	pComp->Value(mkNamingAdapt(mkIntPackAdapt(iCnt),      "ChunkCnt",      0));
+	pComp->Value(mkNamingAdapt(mkIntPackAdapt(iRangeCnt), "ChunkRangeCnt", 0));
+	if (fCompiler)
+	{
+		if (iCnt < 0 || iCnt > C4NetResMaxChunkCnt || iRangeCnt < 0 || iRangeCnt > iCnt)
+			pComp->excCorrupt("ResChunk count invalid!");
+		SetIncomplete(iCnt);
+	}
 	// Ranges
 	if (!pComp->Name("Ranges"))
 		pComp->excCorrupt("ResChunk ranges expected!");
-	ChunkRange *pRange = nullptr;
-	for (int32_t i = 0; i < iChunkRangeCnt; i++)
+	int32_t iStart = 0, iLength = 0;
+	for (int32_t i = 0; i < iRangeCnt; i++)
 	{
-		// Create new range / go to next range
-		if (fCompiler)
-			pRange = (pRange ? pRange->Next : pChunkRanges) = new ChunkRange;
-		else
-			pRange = pRange ? pRange->Next : pChunkRanges;
+		// Get next range
+		if (!fCompiler)
+		{
+			iStart = getNextChunk(iStart + iLength, true);
+			iLength = getNextChunk(iStart, false) - iStart;
+		}
 		// Separate
 		if (i) pComp->Separator();
 		// Compile range
-		pComp->Value(mkIntPackAdapt(pRange->Start));
+		pComp->Value(mkIntPackAdapt(iStart));
 		pComp->Separator(StdCompiler::SEP_PART2);
-		pComp->Value(mkIntPackAdapt(pRange->Length));
+		pComp->Value(mkIntPackAdapt(iLength));
+		// Set chunks
+		if (fCompiler)
+			AddChunkRange(iStart, iLength);
 	}
-	// Terminate list
-	if (fCompiler)
-		(pRange ? pRange->Next : pChunkRanges) = nullptr;
 	pComp->NameEnd();
 }
 
@@ -489,6 +464,7 @@ bool C4Network2Res::SetLoad(const C4Network2ResCore &nCore) // by main thread
 	// save core, set chunks
 	Core = nCore;
 	Chunks.SetIncomplete(Core.getChunkCnt());
+	LoadingChunks.SetIncomplete(Core.getChunkCnt());
 	// create temporary file
 	if (!pParent->FindTempResFileName(Core.getFileName(), szFile))
 		return false;
@@ -676,6 +652,9 @@ bool C4Network2Res::GetStandalone(char *pTo, int32_t iMaxL, bool fSetOfficial, b
 	fStandaloneFailed = false;
 	// mark resource as loadable and safe file information
 	Core.SetLoadable(iSize, iCRC32);
+	// checksums of the single chunks, so loaders can reject bad chunks on arrival
+	if (!Core.hasChunkCRCs() && !CalculateChunkCRCs())
+		if (!fSilent) Log("GetStandalone: could not calculate chunk checksums!");
 	// set up chunk data
 	Chunks.SetComplete(Core.getChunkCnt());
 	// ok
@@ -700,6 +679,27 @@ bool C4Network2Res::CalculateSHA()
 	return true;
 }
 
+bool C4Network2Res::CalculateChunkCRCs()
+{
+	CStdLock FileLock(&FileCSec);
+	// open the standalone
+	CStdFile File;
+	if (!File.Open(szStandalone))
+		return false;
+	// checksum every chunk
+	std::vector<uint32_t> CRCs(Core.getChunkCnt());
+	std::vector<uint8_t> Buf(Core.getChunkSize());
+	for (uint32_t &iCRC : CRCs)
+	{
+		size_t iSize = 0;
+		if (!File.Read(Buf.data(), Buf.size(), &iSize) && !iSize)
+			return false;
+		iCRC = crc32(0, Buf.data(), iSize);
+	}
+	Core.SetChunkCRCs(std::move(CRCs));
+	return true;
+}
+
 C4Network2Res::Ref C4Network2Res::Derive()
 {
 	// Called before the file is changed. Rescues all files and creates a
@@ -876,21 +876,20 @@ void C4Network2Res::OnStatus(const C4Network2ResChunkData &rChunkData, C4Network
 	if (rChunkData.getChunkCnt() != Chunks.getChunkCnt())
 		return;
 	// add chunk data
-	ClientChunks *pChunks;
-	for (pChunks = pCChunks; pChunks; pChunks = pChunks->Next)
-		if (pChunks->ClientID == pBy->getClientID())
-			break;
+	ClientChunks *pChunks = getCChunks(pBy->getClientID());
 	// not found? add
 	if (!pChunks)
 	{
 		pChunks = new ClientChunks();
+		pChunks->ClientID = pBy->getClientID();
+		pChunks->LoadWindow = C4NetResInitialLoadPerPeerPerFile;
 		pChunks->Next = pCChunks;
 		pCChunks = pChunks;
 	}
-	pChunks->ClientID = pBy->getClientID();
 	pChunks->Chunks = rChunkData;
+	UpdateChunkSourceCnt();
 	// load?
-	if (fLoading) StartLoad(pChunks->ClientID, pChunks->Chunks);
+	if (fLoading) StartNewLoads();
 }
 
 void C4Network2Res::OnChunk(const C4Network2ResChunk &rChunk)
@@ -905,16 +904,18 @@ void C4Network2Res::OnChunk(const C4Network2ResChunk &rChunk)
 	// log
 	Application.InteractiveThread.ThreadLogSF("Network: Res: %s chunk %d to ressource %s (%s)%s", fSuccess ? "added" : "could not add", rChunk.getChunkNr(), Core.getFileName(), szFile, fSuccess ? "" : "!");
 #endif
-	if (fSuccess)
+	// status changed
+	if (fSuccess) fDirty = true;
+	// remove load waits (a failed chunk will be requested again)
+	for (C4Network2ResLoad *pLoad = pLoads, *pNext; pLoad; pLoad = pNext)
 	{
-		// status changed
-		fDirty = true;
-		// remove load waits
-		for (C4Network2ResLoad *pLoad = pLoads, *pNext, *pPrev = nullptr; pLoad; pPrev = pLoad, pLoad = pNext)
+		pNext = pLoad->Next();
+		if (pLoad->getChunk() == rChunk.getChunkNr())
 		{
-			pNext = pLoad->Next();
-			if (pLoad->getChunk() == rChunk.getChunkNr())
-				RemoveLoad(pLoad);
+			// adapt load window: grow while the source delivers, drop to one load if it sent garbage
+			if (ClientChunks *pFrom = getCChunks(pLoad->getByClient()))
+				pFrom->LoadWindow = fSuccess ? std::min(pFrom->LoadWindow + 1, C4NetResMaxLoadPerPeerPerFile) : 1;
+			RemoveLoad(pLoad);
 		}
 	}
 	// complete?
@@ -938,6 +939,9 @@ bool C4Network2Res::DoLoad()
 			pNext = pLoad->Next();
 			if (pLoad->CheckTimeout())
 			{
+				// source seems to be overloaded
+				if (ClientChunks *pFrom = getCChunks(pLoad->getByClient()))
+					pFrom->LoadWindow = std::max(pFrom->LoadWindow / 2, 1);
 				RemoveLoad(pLoad);
 				iLoadsRemoved++;
 			}
@@ -1024,50 +1028,34 @@ void C4Network2Res::StartNewLoads()
 				break;
 			}
 	}
-	// start new load until maximum count reached
-	while (iLoadCnt + 1 <= C4NetResMaxLoad)
+	// start new loads round-robin until all load windows are full
+	while (iLoadCnt < C4NetResMaxLoad)
 	{
 		int32_t ioLoadCnt = iLoadCnt;
-		// search someone
 		for (i = 0; i < iCChunkCnt; i++)
 			if (pC[i])
-			{
 				// try to start load
-				if (!StartLoad(pC[i]->ClientID, pC[i]->Chunks))
-				{
-					pC[i] = nullptr; continue;
-				}
-				// success?
-				if (iLoadCnt > ioLoadCnt) break;
-			}
-		// not found?
-		if (i >= iCChunkCnt)
+				if (!StartLoad(pC[i]))
+					pC[i] = nullptr;
+		// nothing started?
+		if (iLoadCnt == ioLoadCnt)
 			break;
 	}
 	// clear up
 	delete[] pC;
 }
 
-bool C4Network2Res::StartLoad(int32_t iFromClient, const C4Network2ResChunkData &Available)
+bool C4Network2Res::StartLoad(ClientChunks *pFrom)
 {
 	assert(pParent && pParent->getIOClass());
+	const int32_t iFromClient = pFrom->ClientID;
 	// all slots used? ignore
-	if (iLoadCnt + 1 >= C4NetResMaxLoad) return true;
-	int32_t loadsAtClient = 0;
-	// are there already enough loads by this client? ignore
-	for (C4Network2ResLoad *pPos = pLoads; pPos; pPos = pPos->Next())
-	{
-		if (pPos->getByClient() == iFromClient)
-		{
-			if (++loadsAtClient >= C4NetResMaxLoadPerPeerPerFile)
-				return true;
-		}
-	}
+	if (iLoadCnt >= C4NetResMaxLoad) return true;
+	// load window of this client full? ignore
+	if (pFrom->LoadCnt >= pFrom->LoadWindow) return true;
 	// find chunk to retrieve
-	int32_t iLoads[C4NetResMaxLoad]; int32_t i = 0;
-	for (C4Network2ResLoad *pLoad = pLoads; pLoad; pLoad = pLoad->Next())
-		iLoads[i++] = pLoad->getChunk();
-	int32_t iRetrieveChunk = Chunks.GetChunkToRetrieve(Available, i, iLoads);
+	const bool fHaveSourceCnt = ChunkSourceCnt.size() == static_cast<size_t>(Chunks.getChunkCnt());
+	int32_t iRetrieveChunk = Chunks.GetChunkToRetrieve(pFrom->Chunks, LoadingChunks, fHaveSourceCnt ? ChunkSourceCnt.data() : nullptr);
 	// nothing? ignore
 	if (iRetrieveChunk < 0 || static_cast<uint32_t>(iRetrieveChunk) >= Core.getChunkCnt())
 		return true;
@@ -1090,6 +1078,8 @@ bool C4Network2Res::StartLoad(int32_t iFromClient, const C4Network2ResChunkData
 	// add to list
 	pnLoad->pNext = pLoads;
 	pLoads = pnLoad;
+	LoadingChunks.AddChunk(iRetrieveChunk);
+	pFrom->LoadCnt++;
 	iLoadCnt++;
 	// ok
 	return true;
@@ -1112,6 +1102,8 @@ void C4Network2Res::ClearLoad()
 	fLoading = false;
 	while (pCChunks) RemoveCChunks(pCChunks);
 	while (pLoads) RemoveLoad(pLoads);
+	ChunkSourceCnt.clear();
+	LoadingChunks.Clear();
 	iDiscoverStartTime = iLoadCnt = 0;
 }
 
@@ -1128,6 +1120,10 @@ void C4Network2Res::RemoveLoad(C4Network2ResLoad *pLoad)
 		if (pPrev)
 			pPrev->pNext = pLoad->Next();
 	}
+	// free slot
+	LoadingChunks.RemoveChunk(pLoad->getChunk());
+	if (ClientChunks *pFrom = getCChunks(pLoad->getByClient()))
+		pFrom->LoadCnt--;
 	// delete
 	delete pLoad;
 	iLoadCnt--;
@@ -1146,10 +1142,33 @@ void C4Network2Res::RemoveCChunks(ClientChunks *pChunks)
 		if (pPrev)
 			pPrev->Next = pChunks->Next;
 	}
+	// the client is no source anymore
+	if (ChunkSourceCnt.size() == static_cast<size_t>(pChunks->Chunks.getChunkCnt()))
+		for (int32_t i = 0; i < pChunks->Chunks.getChunkCnt(); i++)
+			if (pChunks->Chunks.isPresent(i))
+				ChunkSourceCnt[i]--;
 	// delete
 	delete pChunks;
 }
 
+C4Network2Res::ClientChunks *C4Network2Res::getCChunks(int32_t iClientID) const
+{
+	for (ClientChunks *pChunks = pCChunks; pChunks; pChunks = pChunks->Next)
+		if (pChunks->ClientID == iClientID)
+			return pChunks;
+	return nullptr;
+}
+
+void C4Network2Res::UpdateChunkSourceCnt()
+{
+	// count clients per chunk (for rarest-first selection)
+	ChunkSourceCnt.assign(Chunks.getChunkCnt(), 0);
+	for (ClientChunks *pChunks = pCChunks; pChunks; pChunks = pChunks->Next)
+		for (int32_t i = 0; i < Chunks.getChunkCnt(); i++)
+			if (pChunks->Chunks.isPresent(i))
+				ChunkSourceCnt[i]++;
+}
+
 bool C4Network2Res::OptimizeStandalone(bool fSilent)
 {
 	CStdLock FileLock(&FileCSec);
@@ -1258,13 +1277,19 @@ bool C4Network2ResChunk::AddTo(C4Network2Res *pRes, C4Network2IO *pIO) const
 	}
 	// calculate offset and size
 	int32_t iOffset = iChunk * Core.getChunkSize();
-	if (iOffset + Data.getSize() > Core.getFileSize())
+	if (iChunk >= Core.getChunkCnt() || iOffset + Data.getSize() > Core.getFileSize())
 	{
 #ifdef C4NET2RES_DEBUG_LOG
 		Application.InteractiveThread.ThreadLogSF(FormatString("C4Network2ResChunk(%d)::AddTo(%s [%d]): Adding %d bytes at offset %d exceeds expected file size of %d!", (int)iResID, (const char *)Core.getFileName(), (int)pRes->getResID(), (int)Data.getSize(), (int)iOffset, (int)Core.getFileSize()).getData());
 #endif
 		return false;
 	}
+	// verify contents
+	if (Core.hasChunkCRCs() && crc32(0, static_cast<const Bytef *>(Data.getData()), Data.getSize()) != Core.getChunkCRC(iChunk))
+	{
+		Application.InteractiveThread.ThreadLogSF("Network: Resource: chunk %d of %s is corrupt, requesting it again", static_cast<int>(iChunk), Core.getFileName());
+		return false;
+	}
 	// open file
 	int32_t f = pRes->OpenFileWrite();
 	if (f == -1)
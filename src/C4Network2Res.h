@@ -22,14 +22,17 @@
 #include <StdSync.h>
 
 #include <atomic>
+#include <vector>
 
 const uint32_t C4NetResChunkSize = 100U * 1024U;
+const int32_t C4NetResMaxChunkCnt = 1 << 20; // maximum number of chunks accepted from the network
 
 const int32_t C4NetResDiscoverTimeout = 10, // (s)
               C4NetResDiscoverInterval = 1, // (s)
               C4NetResStatusInterval = 1, // (s)
-              C4NetResMaxLoadPerPeerPerFile = 3,
-              C4NetResMaxLoad = 20,
+              C4NetResInitialLoadPerPeerPerFile = 4,
+              C4NetResMaxLoadPerPeerPerFile = 32,
+              C4NetResMaxLoad = 64,
               C4NetResLoadTimeout = 60, // (s)
               C4NetResDeleteTime = 60, // (s)
               C4NetResMaxBigicon = 20; // maximum size, in KB, of bigicon
@@ -78,6 +81,7 @@ protected:
 	uint8_t fHasFileSHA;
 	uint8_t FileSHA[StdSha1::DigestLength];
 	uint32_t iChunkSize;
+	std::vector<uint32_t> ChunkCRCs;
 
 public:
 	C4Network2ResType getType()        const { return eType; }
@@ -92,12 +96,15 @@ public:
 	const char       *getFileName()    const { return FileName.getData(); }
 	uint32_t          getChunkSize()   const { return iChunkSize; }
 	uint32_t          getChunkCnt()    const { return iFileSize && iChunkSize ? (iFileSize - 1) / iChunkSize + 1 : 0; }
+	bool              hasChunkCRCs()   const { return ChunkCRCs.size() == getChunkCnt(); }
+	uint32_t          getChunkCRC(uint32_t iChunk) const { return ChunkCRCs[iChunk]; }
 
 	void Set(C4Network2ResType eType, int32_t iResID, const char *strFileName, uint32_t iContentsCRC, const char *szAutor);
 	void SetID(int32_t inID) { iID = inID; }
 	void SetDerived(int32_t inDerID) { iDerID = inDerID; }
 	void SetLoadable(uint32_t iSize, uint32_t iCRC);
 	void SetFileSHA(uint8_t *pSHA) { memcpy(FileSHA, pSHA, StdSha1::DigestLength); fHasFileSHA = true; }
+	void SetChunkCRCs(std::vector<uint32_t> &&nChunkCRCs) { ChunkCRCs = std::move(nChunkCRCs); }
 	void Clear();
 
 	virtual void CompileFunc(StdCompiler *pComp) override;
@@ -141,33 +148,32 @@ public:
 protected:
 	int32_t iChunkCnt, iPresentChunkCnt;
 
-	// present chunk ranges
-	struct ChunkRange { int32_t Start, Length; ChunkRange *Next; };
-	ChunkRange *pChunkRanges;
-	int32_t iChunkRangeCnt;
+	// present chunks (one bit per chunk)
+	std::vector<uint32_t> Present;
 
 public:
 	int32_t getChunkCnt()        const { return iChunkCnt; }
 	int32_t getPresentChunkCnt() const { return iPresentChunkCnt; }
 	int32_t getPresentPercent()  const { return iPresentChunkCnt * 100 / iChunkCnt; }
 	bool    isComplete()         const { return iPresentChunkCnt == iChunkCnt; }
+	bool    isPresent(int32_t iChunk) const { return !!(Present[iChunk / 32] & (1u << (iChunk % 32))); }
 
 	void SetIncomplete(int32_t iChunkCnt);
 	void SetComplete(int32_t iChunkCnt);
 
 	void AddChunk(int32_t iChunk);
 	void AddChunkRange(int32_t iStart, int32_t iLength);
+	void RemoveChunk(int32_t iChunk);
 	void Merge(const C4Network2ResChunkData &Data2);
 
 	void Clear();
 
-	int32_t GetChunkToRetrieve(const C4Network2ResChunkData &Available, int32_t iLoadingCnt, int32_t *pLoading) const;
+	// rarest chunk that is available, but neither present nor being loaded (pSourceCnt: sources per chunk)
+	int32_t GetChunkToRetrieve(const C4Network2ResChunkData &Available, const C4Network2ResChunkData &Loading, const int32_t *pSourceCnt) const;
 
 protected:
 	// helpers
-	bool MergeRanges(ChunkRange *pRange);
-	void GetNegative(C4Network2ResChunkData &Target) const;
-	int32_t getPresentChunk(int32_t iNr) const;
+	int32_t getNextChunk(int32_t iStart, bool fPresent) const;
 
 public:
 	virtual void CompileFunc(StdCompiler *pComp) override;
@@ -224,10 +230,12 @@ protected:
 
 	// loading
 	bool fLoading;
-	struct ClientChunks { C4Network2ResChunkData Chunks; int32_t ClientID; ClientChunks *Next; }
+	struct ClientChunks { C4Network2ResChunkData Chunks; int32_t ClientID; int32_t LoadCnt, LoadWindow; ClientChunks *Next; }
 	*pCChunks;
+	std::vector<int32_t> ChunkSourceCnt; // number of clients having each chunk
 	time_t iDiscoverStartTime;
 	C4Network2ResLoad *pLoads;
+	C4Network2ResChunkData LoadingChunks;
 	int32_t iLoadCnt;
 
 	// list (C4Network2ResList)
@@ -288,12 +296,16 @@ protected:
 	int32_t OpenFileRead(); int32_t OpenFileWrite();
 
 	void StartNewLoads();
-	bool StartLoad(int32_t iFromClient, const C4Network2ResChunkData &Chunks);
+	bool StartLoad(ClientChunks *pFrom);
 	void EndLoad();
 	void ClearLoad();
 
 	void RemoveLoad(C4Network2ResLoad *pLoad);
 	void RemoveCChunks(ClientChunks *pChunks);
+	ClientChunks *getCChunks(int32_t iClientID) const;
+	void UpdateChunkSourceCnt();
+
+	bool CalculateChunkCRCs();
 
 	bool OptimizeStandalone(bool fSilent);
 };
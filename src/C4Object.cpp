@@ -1051,9 +1051,6 @@ void C4Object::Execute()
 	// Movement
 	ExecMovement();
 	if (!Status) return;
-	// particles
-	if (BackParticles) BackParticles.Exec(this);
-	if (FrontParticles) FrontParticles.Exec(this);
 	// effects
 	if (pEffects)
 	{
@@ -1070,7 +1067,12 @@ void C4Object::Execute()
 	{
 		Timer = 0;
 		// TimerCall
-		if (Def->TimerCall) Def->TimerCall->Exec(this);
+		if (Def->TimerCall)
+		{
+			const auto tStart = C4TimerStats::Clock::now();
+			Def->TimerCall->Exec(this);
+			Game.TimerStats.Stop(tStart, Def->id, Def->STimerCall);
+		}
 	}
 	// Menu
 	if (Menu) Menu->Execute();
@@ -2772,8 +2774,10 @@ void C4Object::CompileFunc(StdCompiler *pComp)
 
 	if (PhysicalTemporary)
 	{
+		pComp->setConditional(+1);
 		pComp->FollowName("Physical");
 		pComp->Value(TemporaryPhysical);
+		pComp->setConditional(-1);
 	}
 
 	// Commands
@@ -27,6 +27,25 @@
 #include <C4Components.h>
 #include <C4Wrappers.h>
 
+#include <StdParallel.h>
+
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// non-sync random for exec procs, which may run on worker threads
+	int32_t ParticleRandom(int32_t iRange)
+	{
+		thread_local uint32_t dwSeed = static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+		dwSeed = dwSeed * 214013 + 2531011;
+		return static_cast<int32_t>((dwSeed >> 16) % iRange);
+	}
+}
+
 void C4ParticleDefCore::CompileFunc(StdCompiler *pComp)
 {
 	pComp->Value(mkNamingAdapt(toC4CStrBuf(Name),                "Name",         ""));
@@ -247,23 +266,31 @@ void C4ParticleChunk::Clear()
 	Data[0].pPrev = Data[C4Px_BufSize - 1].pNext = nullptr;
 }
 
-void C4ParticleList::Exec(C4Object *pObj)
+int32_t C4ParticleList::Exec(C4Object *pObj, C4ParticleList &rDead)
 {
 	// execute all particles
+	// only this list and rDead are modified, so disjoint lists may be executed concurrently
+	int32_t iCnt = 0;
 	C4Particle *pPrtNext = pFirst, *pPrt;
 	while (pPrt = pPrtNext)
 	{
 		// get next now, because destruction could corrupt the list
 		pPrtNext = pPrt->pNext;
-		// execute it
-		if (!pPrt->pDef->ExecProc(pPrt, pObj))
-		{
-			// sorry, life is over for you :P
-			--pPrt->pDef->Count;
-			pPrt->MoveList(*this, Game.Particles.FreeParticles);
-		}
+		++iCnt;
+		// execute it; call the default procs directly, so they can be inlined
+		C4ParticleExecProc ExecProc = pPrt->pDef->ExecProc;
+		bool fAlive;
+		if (ExecProc == &fxStdExec)
+			fAlive = fxStdExec(pPrt, pObj);
+		else if (ExecProc == &fxSmokeExec)
+			fAlive = fxSmokeExec(pPrt, pObj);
+		else
+			fAlive = ExecProc(pPrt, pObj);
+		// counts and the free list are shared; the caller releases dead particles
+		if (!fAlive) pPrt->MoveList(*this, rDead);
 	}
 	// done
+	return iCnt;
 }
 
 void C4ParticleList::Draw(C4FacetEx &cgo, C4Object *pObj)
@@ -318,6 +345,7 @@ C4ParticleSystem::C4ParticleSystem()
 	pFSpark = nullptr;
 	pFire1 = nullptr;
 	pFire2 = nullptr;
+	ExecCount = ExecTime = 0;
 }
 
 C4ParticleSystem::~C4ParticleSystem()
@@ -326,6 +354,42 @@ C4ParticleSystem::~C4ParticleSystem()
 	Clear();
 }
 
+void C4ParticleSystem::Execute()
+{
+	const auto tStart = std::chrono::steady_clock::now();
+	// gather all lists to be executed
+	std::vector<std::pair<C4ParticleList *, C4Object *>> Lists;
+	if (GlobalParticles) Lists.emplace_back(&GlobalParticles, nullptr);
+	for (C4ObjectLink *clnk = Game.Objects.First; clnk; clnk = clnk->Next)
+	{
+		C4Object *cObj = clnk->Obj;
+		if (!cObj->Status) continue;
+		if (cObj->BackParticles) Lists.emplace_back(&cObj->BackParticles, cObj);
+		if (cObj->FrontParticles) Lists.emplace_back(&cObj->FrontParticles, cObj);
+	}
+	// exec procs only read game state, so the lists can be processed in parallel
+	std::vector<C4ParticleList> Dead(Lists.size());
+	std::vector<int32_t> Counts(Lists.size());
+	CStdWorkerPool::Default().ForEach(static_cast<int>(Lists.size()), [&](int i)
+	{
+		Counts[i] = Lists[i].first->Exec(Lists[i].second, Dead[i]);
+	});
+	// sorry, life is over for you :P
+	ExecCount = 0;
+	for (size_t i = 0; i < Lists.size(); ++i)
+	{
+		Dead[i].Clear();
+		ExecCount += Counts[i];
+	}
+	ExecTime = static_cast<int32_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tStart).count());
+}
+
+void C4ParticleSystem::DrawStatus(C4FacetEx &cgo)
+{
+	Application.DDraw->TextOut(FormatString("Particles: %d (%d.%02d ms)", ExecCount, ExecTime / 1000, ExecTime % 1000 / 10).getData(),
+		Game.GraphicsResource.FontRegular, 1.0, cgo.Surface, cgo.X + 20, cgo.Y + cgo.Hgt - 50);
+}
+
 C4ParticleChunk *C4ParticleSystem::AddChunk()
 {
 	// add another chunk
@@ -558,7 +622,7 @@ bool fxSmokeExec(C4Particle *pPrt, C4Object *pTarget)
 	{
 		pPrt->xdir = 0.025f * Game.Weather.GetWind(int32_t(pPrt->x), int32_t(pPrt->y));
 		if (pPrt->xdir < -2.0f) pPrt->xdir = -2.0f; else if (pPrt->xdir > 2.0f) pPrt->xdir = 2.0f;
-		pPrt->xdir += 0.1f * SafeRandom(41) - 2.0f;
+		pPrt->xdir += 0.1f * ParticleRandom(41) - 2.0f;
 	}
 	// float
 	if (GBackSolid(int32_t(pPrt->x), int32_t(pPrt->y - pPrt->a)))
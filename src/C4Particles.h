@@ -157,7 +157,7 @@ public:
 
 	C4ParticleList() { pFirst = nullptr; }
 
-	void Exec(C4Object *pObj = nullptr); // execute all particles
+	int32_t Exec(C4Object *pObj, C4ParticleList &rDead); // execute all particles; move dead ones to rDead; returns number of executed particles
 	void Draw(C4FacetEx &cgo, C4Object *pObj = nullptr); // draw all particles
 	void Clear(); // remove all particles
 	int32_t Remove(C4ParticleDef *pOfDef); // remove all particles of def
@@ -187,12 +187,18 @@ public:
 	C4ParticleDef *pFire1;  // default particle: fire base
 	C4ParticleDef *pFire2;  // default particle: fire additive
 
+	int32_t ExecCount; // number of particles executed in the last frame
+	int32_t ExecTime;  // time spent executing them, in microseconds
+
 	C4ParticleSystem();
 	~C4ParticleSystem();
 
 	void ClearParticles(); // remove all particles
 	void Clear(); // remove all particle definitions and particles
 
+	void Execute(); // execute global and object local particles
+	void DrawStatus(C4FacetEx &cgo); // draw particle statistics
+
 	C4Particle *Create(C4ParticleDef *pOfDef, // create one particle of given type
 		float x, float y, float xdir = 0.0f, float ydir = 0.0f,
 		float a = 0.0f, int32_t b = 0, C4ParticleList *pPxList = nullptr, C4Object *pObj = nullptr);
@@ -217,6 +223,7 @@ public:
 // default particle execution/drawing functions
 bool fxStdInit(C4Particle *pPrt, C4Object *pTarget);
 bool fxStdExec(C4Particle *pPrt, C4Object *pTarget);
+bool fxSmokeExec(C4Particle *pPrt, C4Object *pTarget);
 void fxStdDraw(C4Particle *pPrt, C4FacetEx &cgo, C4Object *pTarget);
 
 // structures used for static function maps
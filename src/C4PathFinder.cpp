@@ -39,6 +39,12 @@
    SetCompletePath don't set move-to waypoint if setting use-zone waypoint (is
    done by C4Command::Transfer on demand and would only cause no-good-entry-point
    move-to's on crawl-zone-entries).
+
+   With SetNavGraph (DefCore PathfinderGraph), a cached navigation graph
+   (see C4NavGraph) is searched instead of launching rays: one of surfaces
+   and walls for walking and climbing objects, or one of free space for
+   flying objects. Its waypoints are set the same way as by rays; rays are
+   only used if start or target can't be attached to the graph.
 */
 
 #include <C4Include.h>
@@ -47,11 +53,17 @@
 #include <C4FacetEx.h>
 #include <C4Game.h>
 
+#include <algorithm>
+#include <chrono>
+
 const int32_t C4PF_MaxDepth  = 35,
               C4PF_MaxCrawl  = 800,
               C4PF_MaxRay    = 350,
               C4PF_Threshold = 10,
 
+              C4PF_CacheGrid = 10, // precision of start and target of shared paths
+              C4PF_CacheSize = 64,
+
               C4PF_Direction_Left  = -1,
               C4PF_Direction_Right = +1,
               C4PF_Direction_None  = 0,
@@ -532,6 +544,9 @@ void C4PathFinder::Default()
 	TransferZones = nullptr;
 	TransferZonesEnabled = true;
 	Level = 1;
+	NavGraphMode = C4PF_Graph_None;
+	Searches = CacheHits = FindTime = 0;
+	LastSearches = LastCacheHits = LastFindTime = 0;
 }
 
 void C4PathFinder::Clear()
@@ -539,6 +554,7 @@ void C4PathFinder::Clear()
 	C4PathFinderRay *pRay, *pNext;
 	for (pRay = FirstRay; pRay; pRay = pNext) { pNext = pRay->Next; delete pRay; }
 	FirstRay = nullptr;
+	GraphPath.clear();
 }
 
 void C4PathFinder::Init(bool(*fnPointFree)(int32_t, int32_t), C4TransferZones *pTransferZones)
@@ -546,6 +562,65 @@ void C4PathFinder::Init(bool(*fnPointFree)(int32_t, int32_t), C4TransferZones *p
 	// Set data
 	PointFree = fnPointFree;
 	TransferZones = pTransferZones;
+	// Graph is built on first use
+	ClearGraph();
+}
+
+void C4PathFinder::ClearGraph()
+{
+	WalkGraph.Clear();
+	FreeGraph.Clear();
+	PathCache.clear();
+}
+
+void C4PathFinder::Invalidate(int32_t iX, int32_t iY)
+{
+	WalkGraph.Invalidate(iX, iY);
+	FreeGraph.Invalidate(iX, iY);
+	InvalidateCache(iX, iY, iX, iY);
+}
+
+void C4PathFinder::Invalidate(const C4Rect &rRect)
+{
+	WalkGraph.Invalidate(rRect);
+	FreeGraph.Invalidate(rRect);
+	InvalidateCache(rRect.x, rRect.y, rRect.x + rRect.Wdt - 1, rRect.y + rRect.Hgt - 1);
+}
+
+void C4PathFinder::InvalidateCache(int32_t iX1, int32_t iY1, int32_t iX2, int32_t iY2)
+{
+	if (PathCache.empty()) return;
+	// failed searches may succeed after any change
+	PathCache.erase(std::remove_if(PathCache.begin(), PathCache.end(), [=](const CachedPath &rPath)
+	{
+		return !rPath.Found || (iX2 >= rPath.X1 && iX1 <= rPath.X2 && iY2 >= rPath.Y1 && iY1 <= rPath.Y2);
+	}), PathCache.end());
+}
+
+void C4PathFinder::ClearPointers(C4Object *pObj)
+{
+	// drop paths transferring through the object
+	PathCache.erase(std::remove_if(PathCache.begin(), PathCache.end(), [=](const CachedPath &rPath)
+	{
+		return std::any_of(rPath.Waypoints.begin(), rPath.Waypoints.end(), [=](const CachedWaypoint &rWaypoint)
+		{
+			return rWaypoint.TransferTarget == reinterpret_cast<intptr_t>(pObj);
+		});
+	}), PathCache.end());
+}
+
+void C4PathFinder::NewFrame()
+{
+	// paths are only shared within one frame, so joining clients start with the same state
+	PathCache.clear();
+	LastSearches = Searches; LastCacheHits = CacheHits; LastFindTime = FindTime;
+	Searches = CacheHits = FindTime = 0;
+}
+
+void C4PathFinder::DrawStatus(C4FacetEx &cgo)
+{
+	Application.DDraw->TextOut(FormatString("Pathfinder: %d searches, %d shared (%d.%02d ms)", LastSearches, LastCacheHits, LastFindTime / 1000, LastFindTime % 1000 / 10).getData(),
+		Game.GraphicsResource.FontRegular, 1.0, cgo.Surface, cgo.X + 20, cgo.Y + cgo.Hgt - 110);
 }
 
 void C4PathFinder::EnableTransferZones(bool fEnabled)
@@ -558,10 +633,21 @@ void C4PathFinder::SetLevel(int iLevel)
 	Level = BoundBy(iLevel, 1, 10);
 }
 
+void C4PathFinder::SetNavGraph(int32_t iMode)
+{
+	NavGraphMode = Inside(iMode, C4PF_Graph_None, C4PF_Graph_Free) ? iMode : C4PF_Graph_None;
+}
+
 void C4PathFinder::Draw(C4FacetEx &cgo)
 {
 	if (TransferZones) TransferZones->Draw(cgo);
 	for (C4PathFinderRay *pRay = FirstRay; pRay; pRay = pRay->Next) pRay->Draw(cgo);
+	// Graph path
+	for (size_t i = 2; i + 1 < GraphPath.size(); i += 2)
+		lpDDraw->DrawLine(cgo.Surface,
+			cgo.X + GraphPath[i - 2] - cgo.TargetX, cgo.Y + GraphPath[i - 1] - cgo.TargetY,
+			cgo.X + GraphPath[i] - cgo.TargetX, cgo.Y + GraphPath[i + 1] - cgo.TargetY,
+			CGreen);
 }
 
 void C4PathFinder::Run()
@@ -608,9 +694,28 @@ bool C4PathFinder::Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iT
 	SetWaypoint = fnSetWaypoint;
 	WaypointParameter = iWaypointParameter;
 
+	// Search
+	const auto tStart = std::chrono::steady_clock::now();
+	const bool fFound = FindPath(iFromX, iFromY, iToX, iToY);
+	FindTime += static_cast<int32_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tStart).count());
+	++Searches;
+	return fFound;
+}
+
+bool C4PathFinder::FindPath(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY)
+{
 	// Start & target coordinates must be free
 	if (!PointFree(iFromX, iFromY) || !PointFree(iToX, iToY)) return false;
 
+	// Navigation graph
+	if (NavGraphMode != C4PF_Graph_None)
+		switch (FindInGraph(iFromX, iFromY, iToX, iToY))
+		{
+		case C4NavGraph::FR_Found: return true;
+		case C4NavGraph::FR_NoPath: return false;
+		case C4NavGraph::FR_NoAttach: break; // off the graph: use rays
+		}
+
 	// Add the first two rays
 	if (!AddRay(iFromX, iFromY, iToX, iToY, 0, C4PF_Direction_Left, nullptr)) return false;
 	if (!AddRay(iFromX, iFromY, iToX, iToY, 0, C4PF_Direction_Right, nullptr)) return false;
@@ -622,6 +727,93 @@ bool C4PathFinder::Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iT
 	return Success;
 }
 
+bool C4PathFinder::CacheWaypoint(int32_t iX, int32_t iY, intptr_t iTransferTarget, intptr_t ipWaypoints)
+{
+	reinterpret_cast<std::vector<CachedWaypoint> *>(ipWaypoints)->push_back({iX, iY, iTransferTarget});
+	return true;
+}
+
+bool C4PathFinder::FindShared(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, bool(*fnSetWaypoint)(int32_t, int32_t, intptr_t, intptr_t), intptr_t iWaypointParameter)
+{
+	if (!fnSetWaypoint) return false;
+	const int32_t iFromQX = iFromX / C4PF_CacheGrid, iFromQY = iFromY / C4PF_CacheGrid;
+	const int32_t iToQX = iToX / C4PF_CacheGrid, iToQY = iToY / C4PF_CacheGrid;
+	const int32_t iSettings = GetSettings();
+	auto it = std::find_if(PathCache.begin(), PathCache.end(), [&](const CachedPath &rPath)
+	{
+		return rPath.FromX == iFromQX && rPath.FromY == iFromQY && rPath.ToX == iToQX && rPath.ToY == iToQY
+			&& rPath.Settings == iSettings;
+	});
+	if (it != PathCache.end())
+	{
+		// waypoints are set from the target backwards: the path must connect to the exact start and target
+		const std::vector<CachedWaypoint> &rWaypoints = it->Waypoints;
+		if (!it->Found)
+		{
+			++CacheHits;
+			return false;
+		}
+		if (!rWaypoints.empty()
+			&& PathFree(iFromX, iFromY, rWaypoints.back().X, rWaypoints.back().Y)
+			&& PathFree(rWaypoints.front().X, rWaypoints.front().Y, iToX, iToY))
+		{
+			++CacheHits;
+			for (const CachedWaypoint &rWaypoint : rWaypoints)
+				fnSetWaypoint(rWaypoint.X, rWaypoint.Y, rWaypoint.TransferTarget, iWaypointParameter);
+			return true;
+		}
+		PathCache.erase(it);
+	}
+	// new search
+	CachedPath Path{iFromQX, iFromQY, iToQX, iToQY, iSettings, false, {},
+		(std::min)(iFromX, iToX), (std::min)(iFromY, iToY), (std::max)(iFromX, iToX), (std::max)(iFromY, iToY)};
+	Path.Found = Find(iFromX, iFromY, iToX, iToY, &CacheWaypoint, reinterpret_cast<intptr_t>(&Path.Waypoints));
+	for (const CachedWaypoint &rWaypoint : Path.Waypoints)
+	{
+		fnSetWaypoint(rWaypoint.X, rWaypoint.Y, rWaypoint.TransferTarget, iWaypointParameter);
+		Path.X1 = (std::min)(Path.X1, rWaypoint.X); Path.Y1 = (std::min)(Path.Y1, rWaypoint.Y);
+		Path.X2 = (std::max)(Path.X2, rWaypoint.X); Path.Y2 = (std::max)(Path.Y2, rWaypoint.Y);
+	}
+	// paths of nearby starts and targets run through the same area
+	Path.X1 -= C4PF_CacheGrid; Path.Y1 -= C4PF_CacheGrid;
+	Path.X2 += C4PF_CacheGrid; Path.Y2 += C4PF_CacheGrid;
+	if (PathCache.size() >= C4PF_CacheSize) PathCache.erase(PathCache.begin());
+	const bool fFound = Path.Found;
+	PathCache.push_back(std::move(Path));
+	return fFound;
+}
+
+int32_t C4PathFinder::GetSettings() const
+{
+	return Level | (TransferZonesEnabled << 8) | (NavGraphMode << 9);
+}
+
+C4NavGraph::FindResult C4PathFinder::FindInGraph(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY)
+{
+	// Build on first use
+	C4NavGraph &rGraph = NavGraphMode == C4PF_Graph_Walk ? WalkGraph : FreeGraph;
+	if (!rGraph.IsInitialized())
+		rGraph.Init(NavGraphMode == C4PF_Graph_Walk ? C4NavGraph::GM_Walk : C4NavGraph::GM_Free, PointFree, Game.Landscape.Width, Game.Landscape.Height);
+	if (TransferZones) TransferZones->ClearUsed();
+	std::vector<C4TransferZone *> PathZones;
+	const auto eResult = rGraph.Find(iFromX, iFromY, iToX, iToY, TransferZonesEnabled ? TransferZones : nullptr, GraphPath, PathZones);
+	if (eResult != C4NavGraph::FR_Found) return eResult;
+	// Set waypoints from the target backwards, like SetCompletePath
+	for (size_t i = PathZones.size() - 1; i > 0; --i)
+	{
+		// Transfer waypoint at zone exit
+		if (PathZones[i])
+		{
+			PathZones[i]->Used = true;
+			SetWaypoint(GraphPath[2 * i], GraphPath[2 * i + 1], reinterpret_cast<intptr_t>(PathZones[i]->Object), WaypointParameter);
+		}
+		// MoveTo waypoint at segment start
+		else if (i > 1)
+			SetWaypoint(GraphPath[2 * i - 2], GraphPath[2 * i - 1], 0, WaypointParameter);
+	}
+	return eResult;
+}
+
 bool C4PathFinder::AddRay(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, int32_t iDepth, int32_t iDirection, C4PathFinderRay *pFrom, C4TransferZone *pUseZone)
 {
 	// Max depth
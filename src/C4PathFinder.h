@@ -18,8 +18,16 @@
 
 #pragma once
 
+#include <C4NavGraph.h>
 #include <C4TransferZone.h>
 
+#include <vector>
+
+// navigation graph used instead of rays (DefCore PathfinderGraph)
+const int32_t C4PF_Graph_None = 0,
+              C4PF_Graph_Walk = 1, // surfaces and walls, for clonks
+              C4PF_Graph_Free = 2; // free space, for flying and swimming objects
+
 class C4PathFinderRay
 {
 	friend class C4PathFinder;
@@ -78,6 +86,29 @@ protected:
 	C4TransferZones *TransferZones;
 	bool TransferZonesEnabled;
 	int Level;
+	int32_t NavGraphMode;
+	C4NavGraph WalkGraph, FreeGraph;
+	std::vector<int32_t> GraphPath; // last path found in the navigation graph
+
+	// paths found in the current frame, shared by commands with similar start and target
+	struct CachedWaypoint
+	{
+		int32_t X, Y;
+		intptr_t TransferTarget;
+	};
+	struct CachedPath
+	{
+		int32_t FromX, FromY, ToX, ToY; // quantized
+		int32_t Settings; // see GetSettings
+		bool Found;
+		std::vector<CachedWaypoint> Waypoints; // in the order they were set
+		int32_t X1, Y1, X2, Y2; // bounds of start, target and waypoints
+	};
+	std::vector<CachedPath> PathCache;
+
+	// statistics of the current and the last frame
+	int32_t Searches, CacheHits, FindTime; // FindTime in microseconds
+	int32_t LastSearches, LastCacheHits, LastFindTime;
 
 public:
 	void Draw(C4FacetEx &cgo);
@@ -85,10 +116,24 @@ public:
 	void Default();
 	void Init(bool(*fnPointFree)(int32_t, int32_t), C4TransferZones *pTransferZones = nullptr);
 	bool Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, bool(*fnSetWaypoint)(int32_t, int32_t, intptr_t, intptr_t), intptr_t iWaypointParameter);
+	// like Find, but may reuse a path found for a nearby start and target in the same frame
+	bool FindShared(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, bool(*fnSetWaypoint)(int32_t, int32_t, intptr_t, intptr_t), intptr_t iWaypointParameter);
 	void EnableTransferZones(bool fEnabled);
 	void SetLevel(int iLevel);
+	void SetNavGraph(int32_t iMode); // C4PF_Graph_*
+	void ClearGraph(); // drop navigation graph of previous landscape
+	void Invalidate(int32_t iX, int32_t iY); // landscape pixel changed solidity
+	void Invalidate(const C4Rect &rRect);
+	void ClearPointers(C4Object *pObj);
+	void NewFrame(); // drop shared paths and update statistics
+	void DrawStatus(C4FacetEx &cgo);
 
 protected:
+	bool FindPath(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY);
+	int32_t GetSettings() const; // everything besides start and target that affects the result of a search
+	void InvalidateCache(int32_t iX1, int32_t iY1, int32_t iX2, int32_t iY2);
+	static bool CacheWaypoint(int32_t iX, int32_t iY, intptr_t iTransferTarget, intptr_t ipWaypoints);
+	C4NavGraph::FindResult FindInGraph(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY);
 	void Run();
 	bool AddRay(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, int32_t iDepth, int32_t iDirection, C4PathFinderRay *pFrom, C4TransferZone *pUseZone = nullptr);
 	bool SplitRay(C4PathFinderRay *pRay, int32_t iAtX, int32_t iAtY);
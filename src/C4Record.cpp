@@ -108,8 +108,197 @@ void C4RecordChunk::CompileFunc(StdCompiler *pComp)
 	}
 }
 
+// *** C4RecordWriter
+
+C4RecordWriter::C4RecordWriter()
+	: iBlockCnt(0), fBusy(false), fStop(false) {}
+
+C4RecordWriter::~C4RecordWriter()
+{
+	Close();
+}
+
+bool C4RecordWriter::Open(const char *szFilename)
+{
+	Close();
+	if (!File.Create(szFilename)) return false;
+	// start I/O thread
+	fStop = false;
+	Thread = std::thread{&C4RecordWriter::Execute, this};
+	return true;
+}
+
+void C4RecordWriter::Close()
+{
+	if (!Thread.joinable()) return;
+	// let the I/O thread write everything and exit
+	Submit();
+	{
+		const std::lock_guard lock{Mutex};
+		fStop = true;
+	}
+	QueueCV.notify_one();
+	Thread.join();
+	File.Close();
+}
+
+uint8_t *C4RecordWriter::Reserve(size_t iSize, bool fFile, bool fStream)
+{
+	// current block doesn't fit? hand it out
+	if (Current.Data && (Current.fFile != fFile || Current.fStream != fStream || Current.iCapacity - Current.iSize < iSize))
+		Submit();
+	// get a new block
+	if (!Current.Data)
+	{
+		if (iSize > BlockSize)
+		{
+			// oversized (streamed files): dedicated block, freed after writing
+			Current.Data.reset(new uint8_t[iSize]);
+			Current.iCapacity = iSize;
+		}
+		else
+		{
+			std::unique_lock lock{Mutex};
+			// all blocks in use? wait for the I/O thread
+			DoneCV.wait(lock, [this] { return !FreeBlocks.empty() || iBlockCnt < MaxBlocks; });
+			if (!FreeBlocks.empty())
+			{
+				Current = std::move(FreeBlocks.back());
+				FreeBlocks.pop_back();
+			}
+			else
+			{
+				Current.Data.reset(new uint8_t[BlockSize]);
+				Current.iCapacity = BlockSize;
+				iBlockCnt++;
+			}
+		}
+		Current.fFile = fFile; Current.fStream = fStream;
+	}
+	return Current.Data.get() + Current.iSize;
+}
+
+void C4RecordWriter::Commit(size_t iSize)
+{
+	assert(Current.iSize + iSize <= Current.iCapacity);
+	Current.iSize += iSize;
+}
+
+void C4RecordWriter::Submit()
+{
+	if (!Current.Data) return;
+	{
+		const std::lock_guard lock{Mutex};
+		if (Current.iSize)
+			Queue.push_back(std::move(Current));
+		else
+			Recycle(std::move(Current));
+	}
+	Current = {};
+	QueueCV.notify_one();
+}
+
+void C4RecordWriter::SubmitIfIdle()
+{
+	if (!Current.Data) return;
+	{
+		const std::lock_guard lock{Mutex};
+		if (fBusy || !Queue.empty()) return;
+	}
+	Submit();
+}
+
+void C4RecordWriter::SubmitStream()
+{
+	if (Current.fStream && Current.iSize) Submit();
+}
+
+void C4RecordWriter::Flush()
+{
+	Submit();
+	std::unique_lock lock{Mutex};
+	DoneCV.wait(lock, [this] { return Queue.empty() && !fBusy; });
+}
+
+void C4RecordWriter::GetStreamData(StdBuf &rTo)
+{
+	const std::lock_guard lock{Mutex};
+	if (!StreamData.getSize()) return;
+	if (!rTo.getSize())
+		rTo = std::move(StreamData);
+	else
+		rTo.Append(StreamData);
+	StreamData.Clear();
+}
+
+void C4RecordWriter::Recycle(Block &&rBlock)
+{
+	// keep pooled blocks, free oversized ones
+	if (rBlock.iCapacity == BlockSize)
+	{
+		rBlock.iSize = 0;
+		FreeBlocks.push_back(std::move(rBlock));
+	}
+	DoneCV.notify_all();
+}
+
+void C4RecordWriter::Execute()
+{
+	std::unique_lock lock{Mutex};
+	for (;;)
+	{
+		QueueCV.wait(lock, [this] { return fStop || !Queue.empty(); });
+		// stopped and everything written?
+		if (Queue.empty()) return;
+		Block Out{std::move(Queue.front())};
+		Queue.pop_front();
+		fBusy = true;
+		// write (without blocking the main thread)
+		if (Out.fFile)
+		{
+			lock.unlock();
+			File.Write(Out.Data.get(), Out.iSize);
+#ifdef IMMEDIATEREC
+			// immediate rec: always flush
+			File.Flush();
+#endif
+			lock.lock();
+		}
+		if (Out.fStream)
+			StreamData.Append(Out.Data.get(), Out.iSize);
+		fBusy = false;
+		Recycle(std::move(Out));
+	}
+}
+
+// binary writer serializing a chunk directly into the current block of the record writer
+class C4RecordChunkCompiler : public StdCompilerBinWrite
+{
+public:
+	C4RecordChunkCompiler(C4RecordWriter &Writer, const C4RecordChunkHead &Head, bool fFile, bool fStream)
+		: Writer(Writer), Head(Head), fFile(fFile), fStream(fStream) {}
+	// the block memory belongs to the writer
+	~C4RecordChunkCompiler() { Buf.GrabPointer(); }
+
+	virtual void BeginSecond() override
+	{
+		// size is known now: reserve head and data
+		uint8_t *pTarget = Writer.Reserve(sizeof(Head) + iPos, fFile, fStream);
+		memcpy(pTarget, &Head, sizeof(Head));
+		Buf.Take(pTarget + sizeof(Head), iPos);
+		fSecondPass = true; iPos = 0;
+	}
+
+private:
+	C4RecordWriter &Writer;
+	C4RecordChunkHead Head;
+	bool fFile, fStream;
+};
+
+// *** C4Record
+
 C4Record::C4Record()
-	: fRecording(false), fStreaming(false) {}
+	: fRecording(false), fStreaming(false), iLastStreamSubmit(0), iLastKeyframe(0) {}
 
 C4Record::~C4Record() {}
 
@@ -160,7 +349,7 @@ bool C4Record::Start(bool fInitial)
 	// open control record file
 	char szCtrlRecFilename[_MAX_PATH + 1 + _MAX_FNAME];
 	sprintf(szCtrlRecFilename, "%s" DirSep C4CFN_CtrlRec, sFilename.getData());
-	if (!CtrlRec.Create(szCtrlRecFilename)) return false;
+	if (!CtrlRec.Open(szCtrlRecFilename)) return false;
 
 	// open record group
 	if (!RecordGrp.Open(sFilename.getData()))
@@ -170,6 +359,8 @@ bool C4Record::Start(bool fInitial)
 	fStreaming = false;
 	fRecording = true;
 	iLastFrame = 0;
+	Keyframes.clear();
+	iLastKeyframe = Game.FrameCounter;
 	return true;
 }
 
@@ -188,13 +379,20 @@ bool C4Record::Stop(StdStrBuf *pRecordName, uint8_t *pRecordSHA1)
 
 	// save end player infos into record group
 	Game.PlayerInfos.Save(RecordGrp, C4CFN_RecPlayerInfos);
+
+	// save keyframe index
+	if (!Keyframes.empty())
+	{
+		StdStrBuf KeyframeIndex = DecompileToBuf<StdCompilerINIWrite>(mkNamingAdapt(mkNamingAdapt(mkSTLContainerAdapt(Keyframes), "Frames"), "Keyframes"));
+		RecordGrp.Add(C4CFN_RecKeyframes, KeyframeIndex, false, true);
+	}
 	RecordGrp.Close();
 
 	// write last entry and close
 	C4RecordChunkHead Head;
 	Head.iFrm = Game.FrameCounter + 37;
 	Head.Type = RCT_End;
-	CtrlRec.Write(&Head, sizeof(Head));
+	Write(Head, nullptr, 0, true);
 	CtrlRec.Close();
 
 	// pack group
@@ -214,6 +412,32 @@ bool C4Record::Stop(StdStrBuf *pRecordName, uint8_t *pRecordSHA1)
 	return true;
 }
 
+bool C4Record::SaveKeyframe()
+{
+	if (!fRecording) return false;
+	iLastKeyframe = Game.FrameCounter;
+
+	// Save current state (without copy of scenario!)
+	StdStrBuf sTempFilename(sFilename);
+	MakeTempFilename(&sTempFilename);
+	C4GameSaveRecord saveRec(false, Index, Game.Parameters.isLeague(), false);
+	if (!saveRec.Save(sTempFilename.getData()))
+	{
+		EraseItem(sTempFilename.getData());
+		return false;
+	}
+	saveRec.Close();
+
+	// Move into record group
+	if (!RecordGrp.Move(sTempFilename.getData(), FormatString(C4CFN_RecKeyframe, Game.FrameCounter).getData()))
+	{
+		EraseItem(sTempFilename.getData());
+		return false;
+	}
+	Keyframes.push_back(Game.FrameCounter);
+	return true;
+}
+
 bool C4Record::Rec(const C4Control &Ctrl, int iFrame)
 {
 	if (!fRecording) return false;
@@ -224,7 +448,8 @@ bool C4Record::Rec(const C4Control &Ctrl, int iFrame)
 	// prepare it for record
 	Cpy.PreRec(this);
 	// record it
-	return Rec(iFrame, DecompileToBuf<StdCompilerBinWrite>(Cpy), RCT_Ctrl);
+	WriteCompiled(GetChunkHead(iFrame, RCT_Ctrl), Cpy, true);
+	return true;
 }
 
 bool C4Record::Rec(C4PacketType eCtrlType, C4ControlPacket *pCtrl, int iFrame)
@@ -236,10 +461,18 @@ bool C4Record::Rec(C4PacketType eCtrlType, C4ControlPacket *pCtrl, int iFrame)
 	// prepare for recording
 	pCtrlCpy->PreRec(this);
 	// record it
-	return Rec(iFrame, DecompileToBuf<StdCompilerBinWrite>(Pkt), RCT_CtrlPkt);
+	WriteCompiled(GetChunkHead(iFrame, RCT_CtrlPkt), Pkt, true);
+	return true;
 }
 
 bool C4Record::Rec(uint32_t iFrame, const StdBuf &sBuf, C4RecordChunkType eType)
+{
+	if (!fRecording) return false;
+	Write(GetChunkHead(iFrame, eType), sBuf.getData(), sBuf.getSize(), true);
+	return true;
+}
+
+C4RecordChunkHead C4Record::GetChunkHead(uint32_t iFrame, C4RecordChunkType eType)
 {
 	// filler chunks (this should never be necessary, though)
 	while (iFrame > iLastFrame + 0xff)
@@ -248,25 +481,33 @@ bool C4Record::Rec(uint32_t iFrame, const StdBuf &sBuf, C4RecordChunkType eType)
 	const uint32_t iFrameDiff = iLastFrame > iFrame ? 0 : iFrame - iLastFrame;
 	iLastFrame += iFrameDiff;
 	// create head
-	C4RecordChunkHead Head = { static_cast<uint8_t>(iFrameDiff), static_cast<uint8_t>(eType) };
-	// pack
-	CtrlRec.Write(&Head, sizeof(Head));
-	CtrlRec.Write(sBuf.getData(), sBuf.getSize());
+	return { static_cast<uint8_t>(iFrameDiff), static_cast<uint8_t>(eType) };
+}
+
+void C4Record::Write(const C4RecordChunkHead &Head, const void *pData, size_t iSize, bool fFile)
+{
+	// pack into the current block (streamed, too, if streaming)
+	uint8_t *pTarget = CtrlRec.Reserve(sizeof(Head) + iSize, fFile, fStreaming);
+	memcpy(pTarget, &Head, sizeof(Head));
+	if (iSize) memcpy(pTarget + sizeof(Head), pData, iSize);
+	CtrlRec.Commit(sizeof(Head) + iSize);
 #ifdef IMMEDIATEREC
-	// immediate rec: always flush
-	CtrlRec.Flush();
+	// immediate rec: hand out as soon as possible
+	CtrlRec.SubmitIfIdle();
 #endif
-	// Stream
-	if (fStreaming)
-		Stream(Head, sBuf);
-	return true;
 }
 
-void C4Record::Stream(const C4RecordChunkHead &Head, const StdBuf &sBuf)
+template <class T>
+void C4Record::WriteCompiled(const C4RecordChunkHead &Head, const T &rData, bool fFile)
 {
-	if (!fStreaming) return;
-	StreamingData.Append(&Head, sizeof(Head));
-	StreamingData.Append(sBuf.getData(), sBuf.getSize());
+	// serialize into the current block
+	C4RecordChunkCompiler Compiler(CtrlRec, Head, fFile, fStreaming);
+	Compiler.Decompile(rData);
+	CtrlRec.Commit(sizeof(Head) + Compiler.getOutput().getSize());
+#ifdef IMMEDIATEREC
+	// immediate rec: hand out as soon as possible
+	CtrlRec.SubmitIfIdle();
+#endif
 }
 
 bool C4Record::AddFile(const char *szLocalFilename, const char *szAddAs, bool fDelete)
@@ -341,6 +582,18 @@ bool C4Record::StartStreaming(bool fInitial)
 	return true;
 }
 
+const StdBuf &C4Record::GetStreamingBuf()
+{
+	// don't let stream data wait for the current block to fill up
+	if (fStreaming && time(nullptr) >= iLastStreamSubmit + C4RecordStreamSubmitInterval)
+	{
+		CtrlRec.SubmitStream();
+		iLastStreamSubmit = time(nullptr);
+	}
+	CtrlRec.GetStreamData(StreamingData);
+	return StreamingData;
+}
+
 void C4Record::ClearStreamingBuf(unsigned int iAmount)
 {
 	iStreamingPos += iAmount;
@@ -365,13 +618,9 @@ bool C4Record::StreamFile(const char *szLocalFilename, const char *szAddAs)
 	if (!FileData.LoadFromFile(szLocalFilename))
 		return false;
 
-	// Prepend name
-	StdBuf Packed = DecompileToBuf<StdCompilerBinWrite>(
-		mkInsertAdapt(StdStrBuf::MakeRef(szAddAs), FileData, false));
-
-	// Add to stream
+	// Add to stream, prepend name
 	C4RecordChunkHead Head = { 0, RCT_File };
-	Stream(Head, Packed);
+	WriteCompiled(Head, mkInsertAdapt(StdStrBuf::MakeRef(szAddAs), FileData, false), false);
 	return true;
 }
 
@@ -624,8 +873,19 @@ StdBuf C4Playback::ReWriteBinary()
 	for (chunks_t::const_iterator i = chunks.begin(); !fFinished && i != chunks.end(); i++)
 	{
 		// Check frame difference
-		if (i->Frame - iFrame < 0 || i->Frame - iFrame > 0xff)
+		if (i->Frame < static_cast<int32_t>(iFrame))
 			LogF("ERROR: Invalid frame difference between chunks (0-255 allowed)! Data will be invalid!");
+		// Fill larger gaps (e.g. before the first chunk of a record starting at a keyframe)
+		while (i->Frame > static_cast<int32_t>(iFrame) + 0xff)
+		{
+			while (Output.getSize() - iPos < sizeof(C4RecordChunkHead))
+				Output.Grow(OUTPUT_GROW);
+			C4RecordChunkHead *pHead = getMBufPtr<C4RecordChunkHead>(Output, iPos);
+			pHead->Type = RCT_Frame;
+			pHead->iFrm = 0xff;
+			iPos += sizeof(C4RecordChunkHead);
+			iFrame += 0xff;
+		}
 		// Pack data
 		StdBuf Chunk;
 		try
@@ -1170,3 +1430,87 @@ bool C4Playback::StreamToRecord(const char *szStream, StdStrBuf *pRecordFile)
 	pRecordFile->Copy(szRecord);
 	return true;
 }
+
+bool C4Playback::KeyframeToRecord(const char *szRecord, int32_t iFrame, StdStrBuf *pRecordFile)
+{
+	// Records without keyframes are played from the beginning
+	C4Group Grp; StdStrBuf KeyframeIndex;
+	if (!Grp.Open(szRecord) || !Grp.LoadEntryString(C4CFN_RecKeyframes, KeyframeIndex))
+		return false;
+	std::vector<int32_t> Keyframes;
+	if (!CompileFromBuf_LogWarn<StdCompilerINIRead>(mkNamingAdapt(mkNamingAdapt(mkSTLContainerAdapt(Keyframes), "Frames", std::vector<int32_t>()), "Keyframes"), KeyframeIndex, C4CFN_RecKeyframes))
+		return false;
+
+	// Find the last keyframe before the seek target
+	int32_t iKeyframe = 0;
+	for (const int32_t iKeyframeFrame : Keyframes)
+		if (iKeyframeFrame <= iFrame)
+			iKeyframe = std::max(iKeyframe, iKeyframeFrame);
+	if (!iKeyframe) return false;
+	LogF("Record: Seeking to frame %d from keyframe at frame %d...", iFrame, iKeyframe);
+
+	// Parse control
+	C4Playback Playback;
+	StdBuf RecordData;
+	if (!Grp.LoadEntry(C4CFN_CtrlRec, RecordData) ||
+		!Playback.ReadBinary(RecordData))
+		return false;
+	RecordData.Clear();
+
+	// Put keyframe to temporary file and unpack
+	char szKeyframe[_MAX_PATH + 1] = "~keyframe.tmp";
+	MakeTempFilename(szKeyframe);
+	if (!Grp.ExtractEntry(FormatString(C4CFN_RecKeyframe, iKeyframe).getData(), szKeyframe) ||
+		!C4Group_UnpackDirectory(szKeyframe) ||
+		!Grp.Close())
+	{
+		EraseItem(szKeyframe);
+		return false;
+	}
+
+	// Copy record and merge keyframe
+	// Runtime components that are omitted when empty must not survive from the record start
+	char szSeekRecord[_MAX_PATH + 1];
+	SCopy(Config.AtTempPath(GetFilename(szRecord)), szSeekRecord, _MAX_PATH);
+	EraseItem(szSeekRecord);
+	if (!C4Group_CopyItem(szRecord, szSeekRecord) ||
+		!Grp.Open(szSeekRecord))
+	{
+		EraseItem(szKeyframe);
+		return false;
+	}
+	Grp.Delete(C4CFN_PXS);
+	Grp.Delete(C4CFN_MassMover);
+	Grp.Delete(C4CFN_PlayerFiles);
+	Grp.Delete(C4CFN_RecKeyframeFiles);
+	Grp.Delete(C4CFN_RecKeyframes);
+	Grp.Delete(C4CFN_CtrlRec);
+	const bool fMerged = Grp.Merge(szKeyframe);
+	EraseItem(szKeyframe);
+	if (!fMerged) return false;
+
+	// Drop control before the keyframe
+	// The keyframe has been saved while executing the control containing the synchronization,
+	// so playback continues with that control just like runtime records do
+	chunks_t::iterator chunkIter, firstChunk = Playback.chunks.end();
+	for (chunkIter = Playback.chunks.begin(); chunkIter != Playback.chunks.end() && chunkIter->Frame <= iKeyframe; chunkIter++)
+		if (chunkIter->Frame == iKeyframe && (firstChunk == Playback.chunks.end() || chunkIter->Type == RCT_Ctrl))
+			firstChunk = chunkIter;
+	if (firstChunk == Playback.chunks.end())
+		firstChunk = chunkIter;
+	for (chunkIter = Playback.chunks.begin(); chunkIter != firstChunk; )
+	{
+		chunkIter->Delete();
+		chunkIter = Playback.chunks.erase(chunkIter);
+	}
+
+	// Write record data
+	RecordData = Playback.ReWriteBinary();
+	if (!Grp.Add(C4CFN_CtrlRec, RecordData, false, true))
+		return false;
+
+	// Done
+	Grp.Close();
+	pRecordFile->Copy(szSeekRecord);
+	return true;
+}
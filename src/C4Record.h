@@ -24,6 +24,13 @@ class C4Record;
 #include "C4Group.h"
 #include "C4Control.h"
 
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #ifdef DEBUGREC
 extern int DoNoDebugRec; // debugrec disable counter in C4Record.cpp
 
@@ -246,10 +253,63 @@ public:
 	virtual void CompileFunc(StdCompiler *pComp) override;
 };
 
+// writes record data on a background thread: chunks are serialized into pooled blocks,
+// which are written to the control file and/or appended to the stream data by the I/O thread
+class C4RecordWriter
+{
+public:
+	static constexpr size_t BlockSize = 64 * 1024;
+	static constexpr size_t MaxBlocks = 16; // pooled blocks (bounds memory usage)
+
+	C4RecordWriter();
+	~C4RecordWriter();
+
+private:
+	struct Block
+	{
+		std::unique_ptr<uint8_t[]> Data;
+		size_t iCapacity = 0, iSize = 0;
+		bool fFile = false, fStream = false;
+	};
+
+	CStdFile File;
+	std::thread Thread;
+	std::mutex Mutex;
+	std::condition_variable QueueCV, DoneCV;
+	std::deque<Block> Queue; // filled blocks waiting for the I/O thread
+	std::vector<Block> FreeBlocks;
+	size_t iBlockCnt; // pooled blocks allocated
+	Block Current; // block being filled (main thread only)
+	bool fBusy, fStop;
+	StdBuf StreamData; // written for streaming, not fetched yet
+
+public:
+	bool Open(const char *szFilename);
+	void Close(); // writes everything that is pending
+
+	// contiguous space for iSize bytes, valid until Commit
+	uint8_t *Reserve(size_t iSize, bool fFile, bool fStream);
+	void Commit(size_t iSize);
+
+	void Submit(); // hand the current block to the I/O thread
+	void SubmitIfIdle(); // same, if the I/O thread has nothing to do
+	void SubmitStream(); // same, if the current block holds stream data
+	void Flush(); // submit and wait until everything is written
+
+	void GetStreamData(StdBuf &rTo); // append stream data written since last call
+
+private:
+	void Recycle(Block &&rBlock); // (Mutex held)
+	void Execute(); // I/O thread
+};
+
+const int32_t C4RecordKeyframeInterval = 10000; // frames between game state snapshots saved into records
+const int32_t C4RecordStreamSubmitInterval = 1; // (s) max time stream data may wait in a partially filled block
+
 class C4Record // demo recording
 {
 private:
-	CStdFile CtrlRec; // control file handle
+	C4RecordWriter CtrlRec; // control file writer
 	StdStrBuf sFilename; // recorded scenario file name
 	C4Group RecordGrp; // record scenario group
 	bool fRecording; // set if recording is active
@@ -257,6 +317,9 @@ private:
 	bool fStreaming; // perdiodically sent new control to server
 	unsigned int iStreamingPos; // Position of current buffer in stream
 	StdBuf StreamingData; // accumulated control data since last stream sync
+	time_t iLastStreamSubmit; // time partially filled blocks were last handed out for streaming
+	std::vector<int32_t> Keyframes; // frames of game states saved into the record for seeking
+	int32_t iLastKeyframe; // frame of last keyframe (or record start)
 
 public:
 	C4Record(); // creates control file etc
@@ -267,7 +330,7 @@ public:
 #endif
 
 	unsigned int GetStreamingPos() const { return iStreamingPos; }
-	const StdBuf &GetStreamingBuf() const { return StreamingData; }
+	const StdBuf &GetStreamingBuf();
 
 	bool Start(bool fInitial);
 	bool Stop(StdStrBuf *pRecordName = nullptr, uint8_t *pRecordSHA1 = nullptr);
@@ -275,6 +338,10 @@ public:
 	bool Rec(const C4Control &Ctrl, int iFrame); // record control
 	bool Rec(C4PacketType eCtrlType, C4ControlPacket *pCtrl, int iFrame); // record control packet
 	bool Rec(uint32_t iFrame, const StdBuf &sBuf, C4RecordChunkType eType);
+	void Flush() { CtrlRec.Flush(); } // wait for pending record and stream data
+
+	bool IsKeyframeDue(int32_t iFrame) const { return fRecording && iFrame >= iLastKeyframe + C4RecordKeyframeInterval; }
+	bool SaveKeyframe(); // save current game state into record; must be called at sync points only
 
 	bool AddFile(const char *szLocalFilename, const char *szAddAs, bool fDelete = false);
 
@@ -283,7 +350,9 @@ public:
 	void StopStreaming();
 
 private:
-	void Stream(const C4RecordChunkHead &Head, const StdBuf &sBuf);
+	C4RecordChunkHead GetChunkHead(uint32_t iFrame, C4RecordChunkType eType);
+	void Write(const C4RecordChunkHead &Head, const void *pData, size_t iSize, bool fFile);
+	template <class T> void WriteCompiled(const C4RecordChunkHead &Head, const T &rData, bool fFile);
 	bool StreamFile(const char *szFilename, const char *szAddAs);
 };
 
@@ -322,4 +391,5 @@ public:
 	void DebugRecError(const char *szError);
 #endif
 	static bool StreamToRecord(const char *szStream, StdStrBuf *pRecord);
+	static bool KeyframeToRecord(const char *szRecord, int32_t iFrame, StdStrBuf *pRecord); // create record starting at the last keyframe before iFrame
 };
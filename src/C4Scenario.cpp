@@ -215,6 +215,8 @@ void C4SGame::Default()
 	Goals.Clear();
 	Rules.Clear();
 	FoWColor = 0;
+	DistributeTimers = false;
+	MaxScriptCallDepth = 0;
 }
 
 void C4SGame::CompileFunc(StdCompiler *pComp, bool fSection)
@@ -253,6 +255,8 @@ void C4SGame::CompileFunc(StdCompiler *pComp, bool fSection)
 	pComp->Value(mkNamingAdapt(Goals,    "Goals",    C4IDList()));
 	pComp->Value(mkNamingAdapt(Rules,    "Rules",    C4IDList()));
 	pComp->Value(mkNamingAdapt(FoWColor, "FoWColor", 0u));
+	pComp->Value(mkNamingAdapt(DistributeTimers, "DistributeTimers", false));
+	pComp->Value(mkNamingAdapt(MaxScriptCallDepth, "MaxScriptCallDepth", 0));
 }
 
 void C4SPlrStart::Default()
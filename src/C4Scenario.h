@@ -150,6 +150,8 @@ public:
 	C4IDList Rules;
 
 	uint32_t FoWColor; // color of FoW; may contain transparency
+	bool DistributeTimers; // spread object and effect timer calls of equal interval over different frames
+	int32_t MaxScriptCallDepth; // maximum nesting of script calls; 0 for the engine default
 
 	C4SRealism Realism;
 
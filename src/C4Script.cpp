@@ -40,6 +40,8 @@
 #include <C4SoundSystem.h>
 
 #include <array>
+#include <string>
+#include <unordered_map>
 #include <optional>
 #include <type_traits>
 #include <utility>
@@ -1949,100 +1951,41 @@ static C4Object *FnFindBase(C4AulContext *cthr, long iOwner, long iIndex)
 	return Game.FindBase(iOwner, iIndex);
 }
 
-C4FindObject *CreateCriterionsFromPars(const C4Value *pPars, C4FindObject **pFOs, C4SortObject **pSOs)
-{
-	int i, iCnt = 0, iSortCnt = 0;
-	// Read all parameters
-	for (i = 0; i < C4AUL_MAX_Par; i++)
-	{
-		const C4Value &Data = pPars[i].GetRefVal();
-		// No data given?
-		if (!Data) break;
-		// Construct
-		C4SortObject *pSO = nullptr;
-		C4FindObject *pFO = C4FindObject::CreateByValue(Data, pSOs ? &pSO : nullptr);
-		// Add FindObject
-		if (pFO)
-		{
-			pFOs[iCnt++] = pFO;
-		}
-		// Add SortObject
-		if (pSO)
-		{
-			pSOs[iSortCnt++] = pSO;
-		}
-	}
-	// No criterions?
-	if (!iCnt)
-	{
-		for (i = 0; i < iSortCnt; ++i) delete pSOs[i];
-		return nullptr;
-	}
-	// create sort criterion
-	C4SortObject *pSO = nullptr;
-	if (iSortCnt)
-	{
-		if (iSortCnt == 1)
-			pSO = pSOs[0];
-		else
-			pSO = new C4SortObjectMultiple(iSortCnt, pSOs, false);
-	}
-	// Create search object
-	C4FindObject *pFO;
-	if (iCnt == 1)
-		pFO = pFOs[0];
-	else
-		pFO = new C4FindObjectAnd(iCnt, pFOs, false);
-	if (pSO) pFO->SetSort(pSO);
-	return pFO;
-}
-
 static C4Value FnObjectCount2(C4AulContext *cthr, const C4Value *pPars)
 {
-	// Create FindObject-structure
-	C4FindObject *pFOs[C4AUL_MAX_Par];
-	C4FindObject *pFO = CreateCriterionsFromPars(pPars, pFOs, nullptr);
+	// Get FindObject-structure
+	auto Criteria = Game.FindObjectCache.Get(cthr, pPars, false);
 	// Error?
-	if (!pFO)
+	if (!Criteria)
 		throw C4AulExecError(cthr->Obj, "ObjectCount: No valid search criterions supplied!");
 	// Search
-	int32_t iCnt = pFO->Count(Game.Objects, Game.Objects.Sectors);
-	// Free
-	delete pFO;
+	int32_t iCnt = Criteria->Count(Game.Objects, Game.Objects.Sectors);
 	// Return
 	return C4VInt(iCnt);
 }
 
 static C4Value FnFindObject2(C4AulContext *cthr, const C4Value *pPars)
 {
-	// Create FindObject-structure
-	C4FindObject *pFOs[C4AUL_MAX_Par];
-	C4SortObject *pSOs[C4AUL_MAX_Par];
-	C4FindObject *pFO = CreateCriterionsFromPars(pPars, pFOs, pSOs);
+	// Get FindObject-structure
+	auto Criteria = Game.FindObjectCache.Get(cthr, pPars, true);
 	// Error?
-	if (!pFO)
+	if (!Criteria)
 		throw C4AulExecError(cthr->Obj, "FindObject: No valid search criterions supplied!");
 	// Search
-	C4Object *pObj = pFO->Find(Game.Objects, Game.Objects.Sectors);
-	// Free
-	delete pFO;
+	C4Object *pObj = Criteria->Find(Game.Objects, Game.Objects.Sectors);
 	// Return
 	return C4VObj(pObj);
 }
 
 static C4Value FnFindObjects(C4AulContext *cthr, const C4Value *pPars)
 {
-	// Create FindObject-structure
-	C4FindObject *pFOs[C4AUL_MAX_Par];
-	C4SortObject *pSOs[C4AUL_MAX_Par];
-	C4FindObject *pFO = CreateCriterionsFromPars(pPars, pFOs, pSOs);
+	// Get FindObject-structure
+	auto Criteria = Game.FindObjectCache.Get(cthr, pPars, true);
 	// Error?
-	if (!pFO)
+	if (!Criteria)
 		throw C4AulExecError(cthr->Obj, "FindObjects: No valid search criterions supplied!");
 	// Search
-	C4ValueArray *pResult = pFO->FindMany(Game.Objects, Game.Objects.Sectors);
-	// Free
-	delete pFO;
+	C4ValueArray *pResult = Criteria->FindMany(Game.Objects, Game.Objects.Sectors);
 	// Return
 	return C4VArray(pResult);
 }
@@ -3386,19 +3329,18 @@ static C4Value FnLocal(C4AulContext *cthr, long iIndex, C4Object *pObj)
 }
 
 static C4Value FnCall(C4AulContext *cthr, C4String *szFunction,
-	C4Value par0, C4Value par1, C4Value par2, C4Value par3, C4Value par4,
-	C4Value par5, C4Value par6, C4Value par7, C4Value par8)
+	const C4Value &par0, const C4Value &par1, const C4Value &par2, const C4Value &par3, const C4Value &par4,
+	const C4Value &par5, const C4Value &par6, const C4Value &par7, const C4Value &par8)
 {
 	if (!szFunction || !cthr->Obj) return C4VNull;
-	C4AulParSet Pars;
-	Copy2ParSet9(Pars, par);
+	const C4AulParSet Pars{par0, par1, par2, par3, par4, par5, par6, par7, par8};
 	return cthr->Obj->Call(FnStringPar(szFunction), Pars, true);
 }
 
 static C4Value FnObjectCall(C4AulContext *cthr,
 	C4Object *pObj, C4String *szFunction,
-	C4Value par0, C4Value par1, C4Value par2, C4Value par3, C4Value par4,
-	C4Value par5, C4Value par6, C4Value par7)
+	const C4Value &par0, const C4Value &par1, const C4Value &par2, const C4Value &par3, const C4Value &par4,
+	const C4Value &par5, const C4Value &par6, const C4Value &par7)
 {
 	if (!pObj || !szFunction) return C4VNull;
 	if (!pObj->Def) return C4VNull;
@@ -3406,16 +3348,15 @@ static C4Value FnObjectCall(C4AulContext *cthr,
 	C4AulFunc *f;
 	if (!(f = pObj->Def->Script.GetSFunc(FnStringPar(szFunction), AA_PUBLIC, true))) return C4VNull;
 	// copy pars
-	C4AulParSet Pars;
-	Copy2ParSet8(Pars, par);
+	const C4AulParSet Pars{par0, par1, par2, par3, par4, par5, par6, par7};
 	// exec
 	return f->Exec(pObj, Pars, true);
 }
 
 static C4Value FnDefinitionCall(C4AulContext *cthr,
 	C4ID idID, C4String *szFunction,
-	C4Value par0, C4Value par1, C4Value par2, C4Value par3, C4Value par4,
-	C4Value par5, C4Value par6, C4Value par7)
+	const C4Value &par0, const C4Value &par1, const C4Value &par2, const C4Value &par3, const C4Value &par4,
+	const C4Value &par5, const C4Value &par6, const C4Value &par7)
 {
 	if (!idID || !szFunction) return C4VNull;
 	// Make failsafe
@@ -3424,46 +3365,43 @@ static C4Value FnDefinitionCall(C4AulContext *cthr,
 	C4Def *pDef;
 	if (!(pDef = C4Id2Def(idID))) return C4VNull;
 	// copy parameters
-	C4AulParSet Pars;
-	Copy2ParSet8(Pars, par);
+	const C4AulParSet Pars{par0, par1, par2, par3, par4, par5, par6, par7};
 	// Call
 	return pDef->Script.Call(szFunc2, Pars, true);
 }
 
 static C4Value FnGameCall(C4AulContext *cthr,
 	C4String *szFunction,
-	C4Value par0, C4Value par1, C4Value par2, C4Value par3, C4Value par4,
-	C4Value par5, C4Value par6, C4Value par7, C4Value par8)
+	const C4Value &par0, const C4Value &par1, const C4Value &par2, const C4Value &par3, const C4Value &par4,
+	const C4Value &par5, const C4Value &par6, const C4Value &par7, const C4Value &par8)
 {
 	if (!szFunction) return C4VNull;
 	// Make failsafe
 	char szFunc2[500 + 1]; sprintf(szFunc2, "~%s", FnStringPar(szFunction));
 	// copy parameters
-	C4AulParSet Pars;
-	Copy2ParSet9(Pars, par);
+	const C4AulParSet Pars{par0, par1, par2, par3, par4, par5, par6, par7, par8};
 	// Call
 	return Game.Script.Call(szFunc2, Pars, true);
 }
 
 static C4Value FnGameCallEx(C4AulContext *cthr,
 	C4String *szFunction,
-	C4Value par0, C4Value par1, C4Value par2, C4Value par3, C4Value par4,
-	C4Value par5, C4Value par6, C4Value par7, C4Value par8)
+	const C4Value &par0, const C4Value &par1, const C4Value &par2, const C4Value &par3, const C4Value &par4,
+	const C4Value &par5, const C4Value &par6, const C4Value &par7, const C4Value &par8)
 {
 	if (!szFunction) return C4VNull;
 	// Make failsafe
 	char szFunc2[500 + 1]; sprintf(szFunc2, "~%s", FnStringPar(szFunction));
 	// copy parameters
-	C4AulParSet Pars;
-	Copy2ParSet9(Pars, par);
+	const C4AulParSet Pars{par0, par1, par2, par3, par4, par5, par6, par7, par8};
 	// Call
 	return Game.Script.GRBroadcast(szFunc2, Pars, true);
 }
 
 static C4Value FnProtectedCall(C4AulContext *cthr,
 	C4Object *pObj, C4String *szFunction,
-	C4Value par0, C4Value par1, C4Value par2, C4Value par3, C4Value par4,
-	C4Value par5, C4Value par6, C4Value par7)
+	const C4Value &par0, const C4Value &par1, const C4Value &par2, const C4Value &par3, const C4Value &par4,
+	const C4Value &par5, const C4Value &par6, const C4Value &par7)
 {
 	if (!pObj || !szFunction) return C4VNull;
 	if (!pObj->Def) return C4VNull;
@@ -3471,16 +3409,15 @@ static C4Value FnProtectedCall(C4AulContext *cthr,
 	C4AulScriptFunc *f;
 	if (!(f = pObj->Def->Script.GetSFunc(FnStringPar(szFunction), AA_PROTECTED, true))) return C4VNull;
 	// copy parameters
-	C4AulParSet Pars;
-	Copy2ParSet8(Pars, par);
+	const C4AulParSet Pars{par0, par1, par2, par3, par4, par5, par6, par7};
 	// exec
 	return f->Exec(pObj, Pars, true);
 }
 
 static C4Value FnPrivateCall(C4AulContext *cthr,
 	C4Object *pObj, C4String *szFunction,
-	C4Value par0, C4Value par1, C4Value par2, C4Value par3, C4Value par4,
-	C4Value par5, C4Value par6, C4Value par7)
+	const C4Value &par0, const C4Value &par1, const C4Value &par2, const C4Value &par3, const C4Value &par4,
+	const C4Value &par5, const C4Value &par6, const C4Value &par7)
 {
 	if (!pObj || !szFunction) return C4VNull;
 	if (!pObj->Def) return C4VNull;
@@ -3488,8 +3425,7 @@ static C4Value FnPrivateCall(C4AulContext *cthr,
 	C4AulScriptFunc *f;
 	if (!(f = pObj->Def->Script.GetSFunc(FnStringPar(szFunction), AA_PRIVATE, true))) return C4VNull;
 	// copy parameters
-	C4AulParSet Pars;
-	Copy2ParSet8(Pars, par);
+	const C4AulParSet Pars{par0, par1, par2, par3, par4, par5, par6, par7};
 	// exec
 	return f->Exec(pObj, Pars, true);
 }
@@ -3893,12 +3829,98 @@ static bool FnGetMissionAccess(C4AulContext *cthr, C4String *strMissionAccess)
 	return SIsModule(Config.General.MissionAccess, FnStringPar(strMissionAccess));
 }
 
+// Where a named value of a structure is stored, relative to the structure
+struct C4ValueFieldLocation
+{
+	enum FieldType
+	{
+		FT_QWord, FT_UQWord, FT_DWord, FT_UDWord, FT_Word, FT_UWord, FT_Byte, FT_UByte,
+		FT_Boolean, FT_Character, FT_CharArray, FT_CharPtr, FT_StdString,
+	};
+
+	FieldType Type;
+	size_t Offset;
+	size_t MaxLength; // FT_CharArray only
+	bool IsID;
+	bool RuntimeWritable;
+};
+
+// Named values found by previous compiler runs, by structure type
+// Only single values stored directly inside the structure are indexed; everything passed through temporaries
+// by adaptors is not, and neither are array elements, as their count may differ between structures,
+// nor values in sections only some structures have (such as the temporary physicals of objects).
+class C4ValueFieldIndex
+{
+	std::unordered_map<std::string, C4ValueFieldLocation> Fields;
+
+	static std::string Key(const char *szEntry, const char *szSection, int iEntryNr)
+	{
+		std::string key{szSection ? szSection : ""};
+		key += '\n';
+		key += szEntry;
+		key += '\n';
+		key += std::to_string(iEntryNr);
+		return key;
+	}
+
+public:
+	const C4ValueFieldLocation *Find(const char *szEntry, const char *szSection, int iEntryNr) const
+	{
+		const auto it = Fields.find(Key(szEntry, szSection, iEntryNr));
+		return it != Fields.end() ? &it->second : nullptr;
+	}
+
+	void Add(const char *szEntry, const char *szSection, int iEntryNr, const C4ValueFieldLocation &rLocation)
+	{
+		Fields.emplace(Key(szEntry, szSection, iEntryNr), rLocation);
+	}
+
+	void Clear() { Fields.clear(); }
+};
+
 // Helper to read or write a value from/to a structure. Must be two
 class C4ValueCompiler : public StdCompiler
 {
 public:
-	C4ValueCompiler(const char **pszNames, int iNameCnt, int iEntryNr)
-		: pszNames(pszNames), iNameCnt(iNameCnt), iEntryNr(iEntryNr) {}
+	C4ValueCompiler(const char **pszNames, int iNameCnt, int iEntryNr, const void *pBase = nullptr, size_t iBaseSize = 0)
+		: pszNames(pszNames), iNameCnt(iNameCnt), iEntryNr(iEntryNr), pBase(static_cast<const char *>(pBase)), iBaseSize(iBaseSize) {}
+
+	// location of the processed value, if it is a single value stored inside the base structure
+	std::optional<C4ValueFieldLocation> getLocation() const { return fMultipleValues ? std::nullopt : Location; }
+
+	virtual void setRuntimeWritesAllowed(int32_t iChange) override { iRuntimeWriteAllowed += iChange; }
+	virtual void setInsideArray(int32_t iChange) override { iArrayDepth += iChange; }
+	virtual void setConditional(int32_t iChange) override { iConditionalDepth += iChange; }
+
+	virtual bool Separator(Sep eSep) override
+	{
+		// the matched entry holds more than one value
+		if (haveCompleteMatch()) fMultipleValues = true;
+		return true;
+	}
+
+	// process a value at a known location without compiling the whole structure
+	void ProcessLocation(const C4ValueFieldLocation &rLocation, void *pBase)
+	{
+		void *const pData = static_cast<char *>(pBase) + rLocation.Offset;
+		iRuntimeWriteAllowed = rLocation.RuntimeWritable ? 1 : 0;
+		switch (rLocation.Type)
+		{
+			case C4ValueFieldLocation::FT_QWord: ProcessQWord(*static_cast<int64_t *>(pData)); break;
+			case C4ValueFieldLocation::FT_UQWord: ProcessQWord(*static_cast<uint64_t *>(pData)); break;
+			case C4ValueFieldLocation::FT_DWord: ProcessInt(*static_cast<int32_t *>(pData)); break;
+			case C4ValueFieldLocation::FT_UDWord: ProcessSmallInt(*static_cast<uint32_t *>(pData)); break;
+			case C4ValueFieldLocation::FT_Word: ProcessSmallInt(*static_cast<int16_t *>(pData)); break;
+			case C4ValueFieldLocation::FT_UWord: ProcessSmallInt(*static_cast<uint16_t *>(pData)); break;
+			case C4ValueFieldLocation::FT_Byte: ProcessSmallInt(*static_cast<int8_t *>(pData)); break;
+			case C4ValueFieldLocation::FT_UByte: ProcessSmallInt(*static_cast<uint8_t *>(pData)); break;
+			case C4ValueFieldLocation::FT_Boolean: ProcessBool(*static_cast<bool *>(pData)); break;
+			case C4ValueFieldLocation::FT_Character: ProcessChar(*static_cast<char *>(pData)); break;
+			case C4ValueFieldLocation::FT_CharArray: ProcessString(static_cast<char *>(pData), rLocation.MaxLength, rLocation.IsID); break;
+			case C4ValueFieldLocation::FT_CharPtr: ProcessString(static_cast<char **>(pData), rLocation.IsID); break;
+			case C4ValueFieldLocation::FT_StdString: ProcessString(*static_cast<std::string *>(pData), rLocation.IsID); break;
+		}
+	}
 
 	virtual bool isCompiler() override { return false; }
 	virtual bool hasNaming() override { return true; }
@@ -3945,6 +3967,11 @@ public:
 	}
 
 protected:
+	int32_t iRuntimeWriteAllowed = 0; // if >0, runtime writing of values is allowed
+
+	template <class T> void ProcessQWord(T &rInt) { auto i = static_cast<int32_t>(rInt); ProcessInt(i); rInt = i; }
+	template <class T> void ProcessSmallInt(T &rInt) { int32_t i = rInt; ProcessInt(i); rInt = i; }
+
 	// value function forward to be overwritten by get or set compiler
 	virtual void ProcessInt(int32_t &rInt) = 0;
 	virtual void ProcessBool(bool &rBool) = 0;
@@ -3955,29 +3982,29 @@ protected:
 
 public:
 	// value functions
-	virtual void QWord(int64_t &rInt)   override { if (haveCompleteMatch()) if (!iEntryNr--) { auto i = static_cast<int32_t>(rInt); ProcessInt(i); rInt = i; } }
-	virtual void QWord(uint64_t &rInt)  override { if (haveCompleteMatch()) if (!iEntryNr--) { auto i = static_cast<int32_t>(rInt); ProcessInt(i); rInt = i; } }
-	virtual void DWord(int32_t &rInt)   override { if (haveCompleteMatch()) if (!iEntryNr--) ProcessInt(rInt); }
-	virtual void DWord(uint32_t &rInt)  override { if (haveCompleteMatch()) if (!iEntryNr--) { int32_t i = rInt;   ProcessInt(i); rInt = i; } }
-	virtual void Word(int16_t &rShort)  override { if (haveCompleteMatch()) if (!iEntryNr--) { int32_t i = rShort; ProcessInt(i); rShort = i; } }
-	virtual void Word(uint16_t &rShort) override { if (haveCompleteMatch()) if (!iEntryNr--) { int32_t i = rShort; ProcessInt(i); rShort = i; } }
-	virtual void Byte(int8_t &rByte)    override { if (haveCompleteMatch()) if (!iEntryNr--) { int32_t i = rByte;  ProcessInt(i); rByte = i; } }
-	virtual void Byte(uint8_t &rByte)   override { if (haveCompleteMatch()) if (!iEntryNr--) { int32_t i = rByte;  ProcessInt(i); rByte = i; } }
-	virtual void Boolean(bool &rBool)   override { if (haveCompleteMatch()) if (!iEntryNr--) ProcessBool(rBool); }
-	virtual void Character(char &rChar) override { if (haveCompleteMatch()) if (!iEntryNr--) ProcessChar(rChar); }
+	virtual void QWord(int64_t &rInt)   override { if (Match(&rInt, C4ValueFieldLocation::FT_QWord)) ProcessQWord(rInt); }
+	virtual void QWord(uint64_t &rInt)  override { if (Match(&rInt, C4ValueFieldLocation::FT_UQWord)) ProcessQWord(rInt); }
+	virtual void DWord(int32_t &rInt)   override { if (Match(&rInt, C4ValueFieldLocation::FT_DWord)) ProcessInt(rInt); }
+	virtual void DWord(uint32_t &rInt)  override { if (Match(&rInt, C4ValueFieldLocation::FT_UDWord)) ProcessSmallInt(rInt); }
+	virtual void Word(int16_t &rShort)  override { if (Match(&rShort, C4ValueFieldLocation::FT_Word)) ProcessSmallInt(rShort); }
+	virtual void Word(uint16_t &rShort) override { if (Match(&rShort, C4ValueFieldLocation::FT_UWord)) ProcessSmallInt(rShort); }
+	virtual void Byte(int8_t &rByte)    override { if (Match(&rByte, C4ValueFieldLocation::FT_Byte)) ProcessSmallInt(rByte); }
+	virtual void Byte(uint8_t &rByte)   override { if (Match(&rByte, C4ValueFieldLocation::FT_UByte)) ProcessSmallInt(rByte); }
+	virtual void Boolean(bool &rBool)   override { if (Match(&rBool, C4ValueFieldLocation::FT_Boolean)) ProcessBool(rBool); }
+	virtual void Character(char &rChar) override { if (Match(&rChar, C4ValueFieldLocation::FT_Character)) ProcessChar(rChar); }
 
 	// The C4ID-Adaptor will set RCT_ID for it's strings (see C4Id.h), so we don't have to guess the type.
 	virtual void String(char *szString, size_t iMaxLength, RawCompileType eType) override
 	{
-		if (haveCompleteMatch()) if (!iEntryNr--) ProcessString(szString, iMaxLength, eType == StdCompiler::RCT_ID);
+		if (Match(szString, C4ValueFieldLocation::FT_CharArray, eType == StdCompiler::RCT_ID, iMaxLength)) ProcessString(szString, iMaxLength, eType == StdCompiler::RCT_ID);
 	}
 	virtual void String(char **pszString, RawCompileType eType) override
 	{
-		if (haveCompleteMatch()) if (!iEntryNr--) ProcessString(pszString, eType == StdCompiler::RCT_ID);
+		if (Match(pszString, C4ValueFieldLocation::FT_CharPtr, eType == StdCompiler::RCT_ID)) ProcessString(pszString, eType == StdCompiler::RCT_ID);
 	}
 	virtual void String(std::string &str, RawCompileType type) override
 	{
-		if (haveCompleteMatch()) if (!iEntryNr--) ProcessString(str, type == StdCompiler::RCT_ID);
+		if (Match(&str, C4ValueFieldLocation::FT_StdString, type == StdCompiler::RCT_ID)) ProcessString(str, type == StdCompiler::RCT_ID);
 	}
 	virtual void Raw(void *pData, size_t iSize, RawCompileType eType = RCT_Escaped) override
 	{
@@ -3997,7 +4024,28 @@ private:
 	// match count (how many names did match, from that point?)
 	int iMatchStart, iMatchCount;
 
+	// structure the values are indexed relative to
+	const char *pBase;
+	size_t iBaseSize;
+	std::optional<C4ValueFieldLocation> Location;
+	int32_t iArrayDepth = 0;
+	int32_t iConditionalDepth = 0;
+	bool fMultipleValues = false;
+
 private:
+	// is this the value to process? Remembers its location if it is inside the base structure
+	bool Match(const void *pData, C4ValueFieldLocation::FieldType eType, bool fIsID = false, size_t iMaxLength = 0)
+	{
+		if (!haveCompleteMatch()) return false;
+		// array elements and entries holding several values can't be indexed by entry number
+		if (iArrayDepth) fMultipleValues = true;
+		if (iEntryNr--) { fMultipleValues = true; return false; }
+		const auto *const pChar = static_cast<const char *>(pData);
+		if (pBase && !iConditionalDepth && pChar >= pBase && pChar < pBase + iBaseSize)
+			Location = C4ValueFieldLocation{eType, static_cast<size_t>(pChar - pBase), iMaxLength, fIsID, iRuntimeWriteAllowed > 0};
+		return true;
+	}
+
 	// match active?
 	bool haveCurrentMatch() const { return iDepth + 1 == iMatchStart + iMatchCount; }
 	// match complete?
@@ -4011,8 +4059,8 @@ private:
 	C4Value Res;
 
 public:
-	C4ValueGetCompiler(const char **pszNames, int iNameCnt, int iEntryNr)
-		: C4ValueCompiler(pszNames, iNameCnt, iEntryNr) {}
+	C4ValueGetCompiler(const char **pszNames, int iNameCnt, int iEntryNr, const void *pBase = nullptr, size_t iBaseSize = 0)
+		: C4ValueCompiler(pszNames, iNameCnt, iEntryNr, pBase, iBaseSize) {}
 
 	// Result-getter
 	const C4Value &getResult() const { return Res; }
@@ -4042,17 +4090,14 @@ class C4ValueSetCompiler : public C4ValueCompiler
 private:
 	C4Value Val; // value to which the setting should be set
 	bool fSuccess; // set if the value could be set successfully
-	int32_t iRuntimeWriteAllowed; // if >0, runtime writing of values is allowed
 
 public:
-	C4ValueSetCompiler(const char **pszNames, int iNameCnt, int iEntryNr, const C4Value &rSetVal)
-		: C4ValueCompiler(pszNames, iNameCnt, iEntryNr), Val(rSetVal), fSuccess(false), iRuntimeWriteAllowed(0) {}
+	C4ValueSetCompiler(const char **pszNames, int iNameCnt, int iEntryNr, const C4Value &rSetVal, const void *pBase = nullptr, size_t iBaseSize = 0)
+		: C4ValueCompiler(pszNames, iNameCnt, iEntryNr, pBase, iBaseSize), Val(rSetVal), fSuccess(false) {}
 
 	// Query successful setting
 	bool getSuccess() const { return fSuccess; }
 
-	virtual void setRuntimeWritesAllowed(int32_t iChange) override { iRuntimeWriteAllowed += iChange; }
-
 protected:
 	// set values as C4Value, only if type matches or is convertible
 	virtual void ProcessInt(int32_t &rInt) override { if (iRuntimeWriteAllowed > 0 && Val.ConvertTo(C4V_Int)) { rInt = Val.getInt(); fSuccess = true; } }
@@ -4102,17 +4147,26 @@ protected:
 };
 
 // Use the compiler to find a named value in a structure
-template <class T>
-C4Value GetValByStdCompiler(const char *strEntry, const char *strSection, int iEntryNr, const T &rFrom)
+// rBase is the structure wrapped by rFrom; values found inside it are indexed, so further lookups skip the compiler
+template <class B, class T>
+C4Value GetValByStdCompiler(C4ValueFieldIndex &rIndex, B &rBase, const char *strEntry, const char *strSection, int iEntryNr, const T &rFrom)
 {
 	// Set up name array, create compiler
 	const char *szNames[2] = { strSection ? strSection : strEntry, strSection ? strEntry : nullptr };
-	C4ValueGetCompiler Comp(szNames, strSection ? 2 : 1, iEntryNr);
+	C4ValueGetCompiler Comp(szNames, strSection ? 2 : 1, iEntryNr, &rBase, sizeof(B));
+
+	// Known location?
+	if (const auto *pLocation = rIndex.Find(strEntry, strSection, iEntryNr))
+	{
+		Comp.ProcessLocation(*pLocation, &rBase);
+		return Comp.getResult();
+	}
 
 	// Compile
 	try
 	{
 		Comp.Decompile(rFrom);
+		if (Comp.getLocation()) rIndex.Add(strEntry, strSection, iEntryNr, *Comp.getLocation());
 		return Comp.getResult();
 	}
 	// Should not happen, catch it anyway.
@@ -4123,17 +4177,25 @@ C4Value GetValByStdCompiler(const char *strEntry, const char *strSection, int iE
 }
 
 // Use the compiler to set a named value in a structure
-template <class T>
-bool SetValByStdCompiler(const char *strEntry, const char *strSection, int iEntryNr, const T &rTo, const C4Value &rvNewVal)
+template <class B, class T>
+bool SetValByStdCompiler(C4ValueFieldIndex &rIndex, B &rBase, const char *strEntry, const char *strSection, int iEntryNr, const T &rTo, const C4Value &rvNewVal)
 {
 	// Set up name array, create compiler
 	const char *szNames[2] = { strSection ? strSection : strEntry, strSection ? strEntry : nullptr };
-	C4ValueSetCompiler Comp(szNames, strSection ? 2 : 1, iEntryNr, rvNewVal);
+	C4ValueSetCompiler Comp(szNames, strSection ? 2 : 1, iEntryNr, rvNewVal, &rBase, sizeof(B));
+
+	// Known location?
+	if (const auto *pLocation = rIndex.Find(strEntry, strSection, iEntryNr))
+	{
+		Comp.ProcessLocation(*pLocation, &rBase);
+		return Comp.getSuccess();
+	}
 
 	// Compile
 	try
 	{
 		Comp.Decompile(rTo);
+		if (Comp.getLocation()) rIndex.Add(strEntry, strSection, iEntryNr, *Comp.getLocation());
 		return Comp.getSuccess();
 	}
 	// Should not happen, catch it anyway.
@@ -4143,6 +4205,15 @@ bool SetValByStdCompiler(const char *strEntry, const char *strSection, int iEntr
 	}
 }
 
+// field indices of the structures accessible by Get*Val
+static C4ValueFieldIndex DefCoreFields, ObjectFields, ObjectInfoCoreFields, ActMapFields, ScenarioFields, PlayerFields, PlayerInfoCoreFields, MaterialCoreFields;
+
+void ClearScriptFieldIndices()
+{
+	for (auto *const pIndex : {&DefCoreFields, &ObjectFields, &ObjectInfoCoreFields, &ActMapFields, &ScenarioFields, &PlayerFields, &PlayerInfoCoreFields, &MaterialCoreFields})
+		pIndex->Clear();
+}
+
 static C4Value FnGetDefCoreVal(C4AulContext *cthr, C4String *strEntry, C4String *section, C4ID idDef, long iEntryNr)
 {
 	const char *strSection = FnStringPar(section);
@@ -4154,7 +4225,7 @@ static C4Value FnGetDefCoreVal(C4AulContext *cthr, C4String *strEntry, C4String
 	C4Def *pDef = C4Id2Def(idDef);
 	if (!pDef) return C4VNull;
 
-	return GetValByStdCompiler(FnStringPar(strEntry), strSection, iEntryNr, mkNamingAdapt(*pDef, "DefCore"));
+	return GetValByStdCompiler(DefCoreFields, *pDef, FnStringPar(strEntry), strSection, iEntryNr, mkNamingAdapt(*pDef, "DefCore"));
 }
 
 static C4Value FnGetObjectVal(C4AulContext *cthr, C4String *strEntry, C4String *section, C4Object *pObj, long iEntryNr)
@@ -4166,7 +4237,7 @@ static C4Value FnGetObjectVal(C4AulContext *cthr, C4String *strEntry, C4String *
 	if (!pObj) return C4VNull;
 
 	// get value
-	return GetValByStdCompiler(FnStringPar(strEntry), strSection, iEntryNr, mkNamingAdapt(*pObj, "Object"));
+	return GetValByStdCompiler(ObjectFields, *pObj, FnStringPar(strEntry), strSection, iEntryNr, mkNamingAdapt(*pObj, "Object"));
 }
 
 static C4Value FnGetObjectInfoCoreVal(C4AulContext *cthr, C4String *strEntry, C4String *section, C4Object *pObj, long iEntryNr)
@@ -4186,7 +4257,7 @@ static C4Value FnGetObjectInfoCoreVal(C4AulContext *cthr, C4String *strEntry, C4
 	C4ObjectInfoCore *pObjInfoCore = static_cast<C4ObjectInfoCore *>(pObjInfo);
 
 	// get value
-	return GetValByStdCompiler(FnStringPar(strEntry), strSection, iEntryNr, mkNamingAdapt(*pObjInfoCore, "ObjectInfo"));
+	return GetValByStdCompiler(ObjectInfoCoreFields, *pObjInfoCore, FnStringPar(strEntry), strSection, iEntryNr, mkNamingAdapt(*pObjInfoCore, "ObjectInfo"));
 }
 
 static C4Value FnGetActMapVal(C4AulContext *cthr, C4String *strEntry, C4String *action, C4ID idDef, long iEntryNr)
@@ -4213,7 +4284,7 @@ static C4Value FnGetActMapVal(C4AulContext *cthr, C4String *strEntry, C4String *
 		return C4VNull;
 
 	// get value
-	return GetValByStdCompiler(FnStringPar(strEntry), nullptr, iEntryNr, *pAct);
+	return GetValByStdCompiler(ActMapFields, *pAct, FnStringPar(strEntry), nullptr, iEntryNr, *pAct);
 }
 
 static C4Value FnGetScenarioVal(C4AulContext *cthr, C4String *strEntry, C4String *section, long iEntryNr)
@@ -4221,7 +4292,7 @@ static C4Value FnGetScenarioVal(C4AulContext *cthr, C4String *strEntry, C4String
 	const char *strSection = FnStringPar(section);
 	if (strSection && !*strSection) strSection = nullptr;
 
-	return GetValByStdCompiler(FnStringPar(strEntry), strSection, iEntryNr, mkParAdapt(Game.C4S, false));
+	return GetValByStdCompiler(ScenarioFields, Game.C4S, FnStringPar(strEntry), strSection, iEntryNr, mkParAdapt(Game.C4S, false));
 }
 
 static C4Value FnGetPlayerVal(C4AulContext *cthr, C4String *strEntry, C4String *section, long iPlr, long iEntryNr)
@@ -4235,7 +4306,7 @@ static C4Value FnGetPlayerVal(C4AulContext *cthr, C4String *strEntry, C4String *
 	C4Player *pPlayer = Game.Players.Get(iPlr);
 
 	// get value
-	return GetValByStdCompiler(FnStringPar(strEntry), strSection, iEntryNr, mkNamingAdapt(*pPlayer, "Player"));
+	return GetValByStdCompiler(PlayerFields, *pPlayer, FnStringPar(strEntry), strSection, iEntryNr, mkNamingAdapt(*pPlayer, "Player"));
 }
 
 static C4Value FnGetPlayerInfoCoreVal(C4AulContext *cthr, C4String *strEntry, C4String *section, long iPlr, long iEntryNr)
@@ -4252,7 +4323,7 @@ static C4Value FnGetPlayerInfoCoreVal(C4AulContext *cthr, C4String *strEntry, C4
 	C4PlayerInfoCore *pPlayerInfoCore = static_cast<C4PlayerInfoCore *>(pPlayer);
 
 	// get value
-	return GetValByStdCompiler(FnStringPar(strEntry), strSection, iEntryNr, *pPlayerInfoCore);
+	return GetValByStdCompiler(PlayerInfoCoreFields, *pPlayerInfoCore, FnStringPar(strEntry), strSection, iEntryNr, *pPlayerInfoCore);
 }
 
 static C4Value FnGetMaterialVal(C4AulContext *cthr, C4String *strEntry, C4String *section, long iMat, long iEntryNr)
@@ -4272,7 +4343,7 @@ static C4Value FnGetMaterialVal(C4AulContext *cthr, C4String *strEntry, C4String
 	if (!SEqual(strSection, "Material")) return C4VNull;
 
 	// get value
-	return GetValByStdCompiler(FnStringPar(strEntry), nullptr, iEntryNr, *pMaterialCore);
+	return GetValByStdCompiler(MaterialCoreFields, *pMaterialCore, FnStringPar(strEntry), nullptr, iEntryNr, *pMaterialCore);
 }
 
 static bool FnCloseMenu(C4AulContext *cthr, C4Object *pObj)
@@ -5194,6 +5265,8 @@ static C4ValueHash *FnGetPath(C4AulContext *ctx, long iFromX, long iFromY, long
 	PathInfo pathinfo;
 	pathinfo.path.push_back({static_cast<int32_t>(iFromX), static_cast<int32_t>(iFromY), nullptr});
 
+	// script paths always use rays, regardless of the last MoveTo command
+	Game.PathFinder.SetNavGraph(C4PF_Graph_None);
 	if (!Game.PathFinder.Find(iFromX, iFromY, iToX, iToY, SetWaypoint, reinterpret_cast<intptr_t>(&pathinfo)))
 	{
 		return nullptr;
@@ -6707,6 +6780,13 @@ template <> struct C4ValueConv<C4Value>
 	inline static C4Value ToC4V(C4Value v) { return v; }
 };
 
+// binds the parameter on the value stack without copying it
+template <> struct C4ValueConv<const C4Value &>
+{
+	inline static C4V_Type Type() { return C4V_Any; }
+	inline static const C4Value &_FromC4V(const C4Value &v) { return v; }
+};
+
 template <typename T> struct C4ValueConv<std::optional<T>>
 {
 	inline static C4V_Type Type() { return C4ValueConv<T>::Type(); }
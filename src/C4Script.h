@@ -47,6 +47,7 @@ struct C4ScriptFnDef
 };
 
 void InitFunctionMap(C4AulScriptEngine *pEngine); // add functions to engine
+void ClearScriptFieldIndices(); // forget the field locations remembered by Get*Val/Set*Val
 
 /* Engine-Calls */
 
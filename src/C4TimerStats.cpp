@@ -0,0 +1,123 @@
+/*
+ * LegacyClonk
+ *
+ * Copyright (c) 2026, The LegacyClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Measures time spent in object and effect timer calls */
+
+#include <C4Include.h>
+#include <C4TimerStats.h>
+
+#include <C4FacetEx.h>
+#include <C4Game.h>
+#include <C4Log.h>
+#include <C4Wrappers.h>
+
+#include <algorithm>
+#include <vector>
+
+C4TimerStats::C4TimerStats()
+{
+	Default();
+}
+
+void C4TimerStats::Default()
+{
+	FrameTime = FrameCalls = 0;
+	LastFrameTime = LastFrameCalls = AverageTime = 0;
+	Frames = Spikes = 0;
+	Profiling = false;
+}
+
+void C4TimerStats::Clear()
+{
+	FrameSources.clear();
+	Sources.clear();
+	Default();
+}
+
+void C4TimerStats::Stop(Clock::time_point tStart, C4ID idDef, const char *szCallback)
+{
+	const int32_t iTime = static_cast<int32_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - tStart).count());
+	FrameTime += iTime;
+	++FrameCalls;
+	// sources are only told apart while profiling
+	if (!Profiling) return;
+	Source &rSource = FrameSources[SourceKey(idDef, szCallback ? szCallback : "")];
+	rSource.Time += iTime;
+	++rSource.Calls;
+}
+
+void C4TimerStats::NewFrame()
+{
+	if (Profiling)
+	{
+		++Frames;
+		// spike: blame everything that ran in this frame by its share
+		const bool fSpike = FrameTime >= MinSpikeTime && FrameTime > AverageTime * SpikeFactor;
+		if (fSpike) ++Spikes;
+		for (const auto &[rKey, rFrameSource] : FrameSources)
+		{
+			Source &rSource = Sources[rKey];
+			rSource.Time += rFrameSource.Time;
+			rSource.Calls += rFrameSource.Calls;
+			if (fSpike)
+			{
+				rSource.SpikeTime += rFrameSource.Time;
+				++rSource.Spikes;
+			}
+		}
+		FrameSources.clear();
+	}
+	// running average over about 16 frames
+	AverageTime = (AverageTime * 15 + FrameTime) / 16;
+	LastFrameTime = FrameTime; LastFrameCalls = FrameCalls;
+	FrameTime = FrameCalls = 0;
+}
+
+void C4TimerStats::DrawStatus(C4FacetEx &cgo)
+{
+	Application.DDraw->TextOut(FormatString("Timers: %d calls (%d.%02d ms, average %d.%02d ms)", LastFrameCalls, LastFrameTime / 1000, LastFrameTime % 1000 / 10, AverageTime / 1000, AverageTime % 1000 / 10).getData(),
+		Game.GraphicsResource.FontRegular, 1.0, cgo.Surface, cgo.X + 20, cgo.Y + cgo.Hgt - 130);
+}
+
+void C4TimerStats::ToggleProfiling()
+{
+	if (!Profiling)
+	{
+		Sources.clear(); FrameSources.clear();
+		Frames = Spikes = 0;
+		Profiling = true;
+		Log("Timer profiling started.");
+		return;
+	}
+	Show();
+	Profiling = false;
+	Sources.clear(); FrameSources.clear();
+}
+
+void C4TimerStats::Show()
+{
+	LogF("Timer profiling: %d frames, %d spikes (average %d.%02d ms per frame)", Frames, Spikes, AverageTime / 1000, AverageTime % 1000 / 10);
+	// worst spike sources first, then most expensive overall
+	std::vector<std::pair<SourceKey, Source>> Sorted(Sources.begin(), Sources.end());
+	std::sort(Sorted.begin(), Sorted.end(), [](const auto &rA, const auto &rB)
+	{
+		if (rA.second.SpikeTime != rB.second.SpikeTime) return rA.second.SpikeTime > rB.second.SpikeTime;
+		return rA.second.Time > rB.second.Time;
+	});
+	if (Sorted.size() > ShowSources) Sorted.resize(ShowSources);
+	for (const auto &[rKey, rSource] : Sorted)
+		LogF("  %s::%s: %d spikes (%d ms), %d calls (%d ms)", C4IdText(rKey.first), rKey.second.c_str(),
+			rSource.Spikes, static_cast<int>(rSource.SpikeTime / 1000), rSource.Calls, static_cast<int>(rSource.Time / 1000));
+}
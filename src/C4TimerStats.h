@@ -0,0 +1,68 @@
+/*
+ * LegacyClonk
+ *
+ * Copyright (c) 2026, The LegacyClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Measures time spent in object and effect timer calls */
+
+#pragma once
+
+#include <C4Id.h>
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <utility>
+
+class C4FacetEx;
+
+class C4TimerStats
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static const int32_t SpikeFactor = 3; // frames exceeding the average timer time by this factor are spikes
+	static const int32_t MinSpikeTime = 2000; // ...and by at least this many microseconds
+	static const int32_t ShowSources = 20;
+
+	C4TimerStats();
+
+protected:
+	struct Source
+	{
+		int64_t Time = 0, SpikeTime = 0; // microseconds
+		int32_t Calls = 0, Spikes = 0;
+	};
+	using SourceKey = std::pair<C4ID, std::string>; // definition and callback
+
+	// current frame
+	int32_t FrameTime, FrameCalls;
+	std::map<SourceKey, Source> FrameSources;
+	// previous frames
+	int32_t LastFrameTime, LastFrameCalls, AverageTime;
+	int32_t Frames, Spikes;
+	bool Profiling;
+	std::map<SourceKey, Source> Sources;
+
+public:
+	void Default();
+	void Clear();
+	void Stop(Clock::time_point tStart, C4ID idDef, const char *szCallback); // timer call started at tStart returned
+	void NewFrame();
+	void DrawStatus(C4FacetEx &cgo);
+	void ToggleProfiling(); // start collecting spike sources or log them
+	bool IsProfiling() const { return Profiling; }
+
+protected:
+	void Show();
+};
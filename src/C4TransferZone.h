@@ -23,6 +23,7 @@ class C4TransferZones;
 class C4TransferZone
 {
 	friend class C4TransferZones;
+	friend class C4NavGraph;
 
 public:
 	C4TransferZone();
@@ -46,6 +47,8 @@ public:
 
 class C4TransferZones
 {
+	friend class C4NavGraph;
+
 public:
 	C4TransferZones();
 	~C4TransferZones();
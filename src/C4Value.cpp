@@ -163,9 +163,10 @@ void C4Value::Set0()
 
 void C4Value::CheckRemoveFromMap()
 {
-	if (Type == C4V_Any && OwningMap)
+	if (Type == C4V_Any && IsMapValue)
 	{
-		OwningMap->removeValue(this);
+		auto *const value = static_cast<C4ValueHash::Value *>(this);
+		value->OwningMap->removeValue(value);
 	}
 }
 
@@ -128,13 +128,6 @@ public:
 		Data.Ref = pVal; AddDataRef();
 	}
 
-	static C4Value *OfMap(C4ValueHash *map)
-	{
-		auto ret = new C4Value;
-		ret->OwningMap = map;
-		return ret;
-	}
-
 	C4Value &operator=(const C4Value &nValue);
 
 	~C4Value();
@@ -256,11 +249,10 @@ protected:
 	};
 	C4Value *FirstRef;
 
-	C4ValueHash *OwningMap = nullptr;
-
 	// data type
 	C4V_Type Type : 8;
 	bool HasBaseContainer = false;
+	bool IsMapValue = false; // this is a C4ValueHash::Value, which removes its key when set to nil
 
 	C4Value *GetNextRef() { if (HasBaseContainer) return nullptr; else return NextRef; }
 	C4ValueContainer *GetBaseContainer() { if (HasBaseContainer) return BaseContainer; else return nullptr; }
@@ -285,8 +277,14 @@ protected:
 
 	friend class C4Object;
 	friend class C4AulDefFunc;
+	friend class C4ValueHash;
 };
 
+// values are copied around a lot, so the map owning a value is not stored in every value.
+// The reference list stays: the executor references variables for every ++, += and by-reference
+// parameter, so keeping the first reference outside the value costs more than the smaller values gain.
+static_assert(sizeof(C4Value) <= 4 * sizeof(void *), "C4Value should not grow");
+
 // converter
 inline C4Value C4VInt(int32_t iVal) { C4V_Data d; d.Int = iVal; return C4Value(d, C4V_Int); }
 inline C4Value C4VBool(bool fVal) { C4V_Data d; d.Int = fVal; return C4Value(d, C4V_Bool); }
@@ -17,8 +17,25 @@
 #include "C4ValueHash.h"
 #include "C4StringTable.h"
 
-#include <optional>
-#include <stdexcept>
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+namespace
+{
+	// released small maps, kept so short-lived maps like literals don't need allocations
+	struct C4ValueHashPool
+	{
+		static constexpr std::size_t MaxMaps = 32;
+		static constexpr std::size_t MaxCapacity = 32;
+
+		std::vector<C4ValueHash *> Maps;
+
+		~C4ValueHashPool() { for (C4ValueHash *map : Maps) delete map; }
+	};
+
+	thread_local C4ValueHashPool MapPool;
+}
 
 C4ValueHash::C4ValueHash() { }
 
@@ -32,6 +49,29 @@ C4ValueHash::~C4ValueHash()
 	clear();
 }
 
+C4ValueHash *C4ValueHash::New()
+{
+	if (MapPool.Maps.empty()) return new C4ValueHash;
+	C4ValueHash *map = MapPool.Maps.back();
+	MapPool.Maps.pop_back();
+	return map;
+}
+
+void C4ValueHash::Destroy(C4ValueHash *map)
+{
+	if (map->entries.capacity() <= C4ValueHashPool::MaxCapacity)
+	{
+		// releasing the values may release other maps
+		map->clear();
+		if (MapPool.Maps.size() < C4ValueHashPool::MaxMaps)
+		{
+			MapPool.Maps.push_back(map);
+			return;
+		}
+	}
+	delete map;
+}
+
 void C4ValueHash::CompileFunc(StdCompiler *pComp)
 {
 	pComp->Value(mkSTLMapAdapt(*this));
@@ -46,48 +86,98 @@ void C4ValueHash::DenumeratePointers()
 	}
 }
 
-void C4ValueHash::removeKey(const C4Value &key)
+std::size_t C4ValueHash::findSlot(const C4Value &key, std::size_t hash) const
+{
+	const std::size_t mask = slots.size() - 1;
+	for (std::size_t slot = hash & mask; ; slot = (slot + 1) & mask)
+	{
+		const std::int32_t entry = slots[slot];
+		if (entry == SlotEmpty) return slot;
+		if (entry != SlotRemoved && entries[entry].hash == hash && entries[entry].key == key) return slot;
+	}
+}
+
+void C4ValueHash::removeEntry(std::size_t entry)
 {
-	const auto &value = map[key];
-	emptyValues.push_front(value.value);
-	keyOrder.erase(value.keyOrderIterator);
-	map.erase(key);
+	auto &mapEntry = entries[entry];
+	slots[findSlot(mapEntry.key, mapEntry.hash)] = SlotRemoved;
+	emptyValues.push_back(mapEntry.value);
+	mapEntry.value = nullptr;
+	mapEntry.key.Set0();
+	++removedEntries;
 }
 
-void C4ValueHash::removeValue(C4Value *value)
+void C4ValueHash::rebuild(std::size_t slotCount)
 {
-	bool found = false;
-	for (auto it = map.begin(); it != map.end(); )
+	// drop removed entries, keeping the order of the others
+	if (removedEntries)
 	{
-		if (it->second.value == value)
+		// live iterators point to the entry they visit next
+		std::vector<std::size_t> iteratorEntries;
+		iteratorEntries.reserve(iterators.size());
+		for (Iterator *iterator : iterators) iteratorEntries.push_back(iterator->entry);
+
+		std::size_t target = 0;
+		for (std::size_t i = 0; i < entries.size(); ++i)
 		{
-			keyOrder.erase(it->second.keyOrderIterator);
-			map.erase(it++);
-			found = true;
+			for (std::size_t j = 0; j < iterators.size(); ++j)
+				if (iteratorEntries[j] == i) iterators[j]->entry = target;
+			if (!entries[i].value) continue;
+			if (target != i)
+			{
+				entries[target].key.Set(entries[i].key);
+				entries[target].value = entries[i].value;
+				entries[target].hash = entries[i].hash;
+			}
+			entries[target].value->entry = target;
+			++target;
 		}
-		else ++it;
+		for (std::size_t j = 0; j < iterators.size(); ++j)
+			if (iteratorEntries[j] >= entries.size()) iterators[j]->entry = target;
+		entries.erase(entries.begin() + target, entries.end());
+		removedEntries = 0;
 	}
-	if (found) emptyValues.push_front(value);
+
+	slots.assign(slotCount, SlotEmpty);
+	for (std::size_t i = 0; i < entries.size(); ++i)
+		slots[findSlot(entries[i].key, entries[i].hash)] = static_cast<std::int32_t>(i);
+}
+
+void C4ValueHash::removeKey(const C4Value &key)
+{
+	if (slots.empty()) return;
+	const auto slot = findSlot(key, std::hash<C4Value>{}(key));
+	if (slots[slot] >= 0) removeEntry(slots[slot]);
+}
+
+void C4ValueHash::removeValue(Value *value)
+{
+	if (value->entry < entries.size() && entries[value->entry].value == value)
+		removeEntry(value->entry);
 }
 
 bool C4ValueHash::contains(const C4Value &key) const
 {
-	return map.find(key) != map.end();
+	return !slots.empty() && slots[findSlot(key, std::hash<C4Value>{}(key))] >= 0;
 }
 
 void C4ValueHash::clear()
 {
-	for (auto &[key, value] : map) delete value.value;
-	map.clear();
+	// live iterators are at the end now
+	for (Iterator *iterator : iterators) iterator->entry = 0;
+	for (auto &entry : entries) delete entry.value;
+	entries.clear();
+	slots.clear();
+	removedEntries = 0;
 	for (auto &value : emptyValues) delete value;
 	emptyValues.clear();
 }
 
 C4ValueHash &C4ValueHash::operator=(const C4ValueHash &other)
 {
-	for (const auto key : other.keyOrder)
+	for (const auto &entry : other.entries)
 	{
-		(*this)[*key].Set(*other.map.at(*key).value);
+		if (entry.value) (*this)[entry.key].Set(*entry.value);
 	}
 	return *this;
 }
@@ -96,9 +186,9 @@ bool C4ValueHash::operator==(const C4ValueHash &other) const
 {
 	if (other.size() != size()) return false;
 
-	for (const auto &it : map)
+	for (const auto &entry : entries)
 	{
-		if (!other.contains(it.first) || other[it.first] != *it.second.value)
+		if (entry.value && (!other.contains(entry.key) || other[entry.key] != *entry.value))
 			return false;
 	}
 
@@ -112,83 +202,102 @@ bool C4ValueHash::hasIndex(const C4Value &key) const
 
 C4Value &C4ValueHash::operator[](const C4Value &key)
 {
-	try
+	const auto hash = std::hash<C4Value>{}(key);
+	if (!slots.empty())
 	{
-		return *map.at(key).value;
+		const auto entry = slots[findSlot(key, hash)];
+		if (entry >= 0) return *entries[entry].value;
 	}
-	catch (const std::out_of_range &)
+
+	// keep at least a quarter of the slots empty; removed entries still occupy theirs until the next rebuild
+	if ((entries.size() + 1) * 4 > slots.size() * 3)
 	{
-		C4Value *value;
-		if (emptyValues.empty()) value = C4Value::OfMap(this);
-		else
-		{
-			value = emptyValues.front();
-			emptyValues.pop_front();
-		}
+		std::size_t slotCount = slots.empty() ? 8 : slots.size();
+		while ((size() + 1) * 2 > slotCount) slotCount *= 2;
+		rebuild(slotCount);
+	}
 
-		const auto& inserted = map.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(MapEntry{value})).first;
-		inserted->second.keyOrderIterator = keyOrder.insert(keyOrder.end(), &inserted->first);
-		return *value;
+	Value *value;
+	if (emptyValues.empty()) value = new Value(this);
+	else
+	{
+		value = emptyValues.back();
+		emptyValues.pop_back();
 	}
+
+	value->entry = entries.size();
+	slots[findSlot(key, hash)] = static_cast<std::int32_t>(entries.size());
+	entries.push_back(MapEntry{key, value, hash});
+	return *value;
 }
 
 const C4Value &C4ValueHash::operator[](const C4Value &key) const
 {
-	try
-	{
-		return *map.at(key).value;
-	}
-	catch (const std::out_of_range &)
-	{
-		return C4VNull;
-	}
+	if (slots.empty()) return C4VNull;
+	const auto entry = slots[findSlot(key, std::hash<C4Value>{}(key))];
+	return entry >= 0 ? *entries[entry].value : C4VNull;
 }
 
 C4ValueHash::Iterator C4ValueHash::begin()
 {
-	return Iterator(this, keyOrder.begin(), keyOrder.end());
+	return Iterator(this, 0);
 }
 
 C4ValueHash::Iterator C4ValueHash::end()
 {
-	return Iterator(this, keyOrder.end(), keyOrder.end());
+	return Iterator(this, entries.size());
 }
 
-C4ValueHash::Iterator::Iterator(C4ValueHash *map, C4ValueHash::Iterator::iterator_type it, C4ValueHash::Iterator::iterator_type end) : it(it), end(end), map(map)
+C4ValueHash::Iterator::Iterator(C4ValueHash *map, std::size_t entry) : map(map), entry(entry)
 {
+	map->iterators.push_back(this);
 	update();
 }
 
+C4ValueHash::Iterator::~Iterator()
+{
+	auto &iterators = map->iterators;
+	if (const auto it = std::find(iterators.begin(), iterators.end(), this); it != iterators.end())
+		iterators.erase(it);
+}
+
 void C4ValueHash::Iterator::update()
 {
-	if (it != end)
-	{
-		current = std::make_unique<pair_type>(**it, (*map)[**it]);
-	}
-	else
-	{
-		current.reset();
-	}
+	// skip removed entries
+	while (entry < map->entries.size() && !map->entries[entry].value) ++entry;
 }
 
 C4ValueHash::Iterator &C4ValueHash::Iterator::operator++()
 {
-	++it;
+	++entry;
 	update();
 	return *this;
 }
 
 C4ValueHash::Iterator::pair_type &C4ValueHash::Iterator::operator*()
 {
+	// entries the loop body removed are skipped
+	update();
+	assert(entry < map->entries.size());
+	const auto &mapEntry = map->entries[entry];
+	current.emplace(mapEntry.key, *mapEntry.value);
 	return *current;
 }
 
+bool C4ValueHash::Iterator::atEnd()
+{
+	update();
+	return entry >= map->entries.size();
+}
+
 bool C4ValueHash::Iterator::operator==(const C4ValueHash::Iterator &other)
 {
-	return it == other.it;
+	update();
+	const auto size = map->entries.size();
+	return (std::min)(entry, size) == (std::min)(other.entry, size);
 }
 
 bool C4ValueHash::Iterator::operator!=(const C4ValueHash::Iterator &other)
 {
-	return it != other.it;
+	return !(*this == other);
 }
@@ -17,10 +17,10 @@
 #include "C4Value.h"
 #include "C4ValueStandardRefCountedContainer.h"
 
-#include <unordered_map>
-#include <forward_list>
-#include <list>
-#include <memory>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
 
 class C4ValueHash : public C4ValueStandardRefCountedContainer<C4ValueHash>
 {
@@ -28,36 +28,66 @@ public:
 	using key_type = C4Value;
 	using mapped_type = C4Value;
 
+	// element of a map; only these know their map
+	class Value : public C4Value
+	{
+	public:
+		C4ValueHash *const OwningMap;
+
+		explicit Value(C4ValueHash *map) : OwningMap{map} { IsMapValue = true; }
+
+	private:
+		std::size_t entry = 0; // index into OwningMap->entries
+		friend class C4ValueHash;
+	};
+
+	class Iterator;
+
 private:
+	// entries are kept in insertion order, as we need a defined order for network sync
 	struct MapEntry
 	{
-		C4Value *value;
-		std::list<const C4Value *>::iterator keyOrderIterator;
+		C4Value key;
+		Value *value; // nullptr for removed entries
+		std::size_t hash;
 	};
 
-	std::unordered_map<key_type, MapEntry> map;
-	std::forward_list<C4Value *> emptyValues;
+	enum : std::int32_t { SlotEmpty = -1, SlotRemoved = -2 };
+
+	std::vector<MapEntry> entries;
+	std::vector<std::int32_t> slots; // open addressing table of indices into entries, size is a power of two
+	std::size_t removedEntries = 0;
+	std::vector<Value *> emptyValues;
+	std::vector<Iterator *> iterators; // live iterators, moved along when entries are compacted
 
-	// we need a defined order for network sync
-	std::list<const C4Value *> keyOrder;
+	std::size_t findSlot(const C4Value &key, std::size_t hash) const; // slot of key or of SlotEmpty if not found
+	void removeEntry(std::size_t entry);
+
+	friend C4ValueStandardRefCountedContainer<C4ValueHash>;
+	static void Destroy(C4ValueHash *map);
+	void rebuild(std::size_t slotCount); // compacts entries and rehashes them into slotCount slots
 
 public:
 
 	class Iterator
 	{
 		using pair_type = std::pair<const C4Value &, C4Value &>;
-		using iterator_type = decltype(keyOrder.begin());
-		iterator_type it, end;
 		C4ValueHash *map;
-		std::unique_ptr<pair_type> current;
+		std::size_t entry;
+		std::optional<pair_type> current; // resolved on dereference, as entries may be reallocated meanwhile
 
 		void update();
+		friend class C4ValueHash;
 
 	public:
-		Iterator(C4ValueHash *map, iterator_type it, iterator_type end);
+		Iterator(C4ValueHash *map, std::size_t entry);
+		Iterator(const Iterator &other) : Iterator(other.map, other.entry) {}
+		Iterator &operator=(const Iterator &other) = delete;
+		~Iterator();
 
 		Iterator &operator++();
 		pair_type &operator*();
+		bool atEnd();
 		bool operator==(const Iterator& other);
 		bool operator!=(const Iterator& other);
 	};
@@ -67,6 +97,8 @@ public:
 
 	~C4ValueHash();
 
+	static C4ValueHash *New(); // reuses released maps if possible
+
 	virtual void CompileFunc(StdCompiler *pComp) override;
 	virtual void DenumeratePointers() override;
 
@@ -80,7 +112,7 @@ public:
 
 	bool contains(const C4Value &key) const;
 	void removeKey(const C4Value &key);
-	void removeValue(C4Value *value);
-	auto size() const { return map.size(); }
+	void removeValue(Value *value);
+	std::size_t size() const { return entries.size() - removedEntries; }
 	void clear();
 };
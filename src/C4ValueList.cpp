@@ -18,21 +18,22 @@
 #include <C4ValueList.h>
 #include <algorithm>
 #include <stdexcept>
+#include <vector>
 
 #include <C4Aul.h>
 #include <C4FindObject.h>
 
 C4ValueList::C4ValueList()
-	: iSize(0), pData(nullptr) {}
+	: iSize(0), iCapacity(0), pData(nullptr) {}
 
 C4ValueList::C4ValueList(int32_t inSize)
-	: iSize(0), pData(nullptr)
+	: iSize(0), iCapacity(0), pData(nullptr)
 {
 	SetSize(inSize);
 }
 
 C4ValueList::C4ValueList(const C4ValueList &ValueList2)
-	: iSize(0), pData(nullptr)
+	: iSize(0), iCapacity(0), pData(nullptr)
 {
 	SetSize(ValueList2.GetSize());
 	for (int32_t i = 0; i < iSize; i++)
@@ -42,7 +43,7 @@ C4ValueList::C4ValueList(const C4ValueList &ValueList2)
 C4ValueList::~C4ValueList()
 {
 	delete[] pData; pData = nullptr;
-	iSize = 0;
+	iSize = iCapacity = 0;
 }
 
 C4ValueList &C4ValueList::operator=(const C4ValueList &ValueList2)
@@ -100,7 +101,12 @@ void C4ValueList::Sort(class C4SortObject &rSort)
 C4Value &C4ValueList::GetItem(int32_t iElem)
 {
 	if (iElem < 0) iElem = 0;
-	if (iElem >= iSize && iElem < MaxSize) this->SetSize(iElem + 1);
+	if (iElem >= iSize && iElem < MaxSize)
+	{
+		// appending element by element (e.g. a[] = x) should not reallocate every time
+		if (iElem >= iCapacity) Reserve((std::min<int32_t>)((std::max)(iElem + 1, iCapacity * 2), MaxSize));
+		this->SetSize(iElem + 1);
+	}
 	// out-of-memory? This might not be catched, but it's better than a segfault
 	if (iElem >= iSize)
 #ifdef C4ENGINE
@@ -126,8 +132,18 @@ void C4ValueList::SetSize(int32_t inSize)
 	// bounds check
 	if (inSize > MaxSize) return;
 
+	// values beyond the size are nil, so they can be used right away
+	Reserve(inSize);
+	if (inSize > iCapacity) return;
+	iSize = inSize;
+}
+
+void C4ValueList::Reserve(int32_t inCapacity)
+{
+	if (inCapacity <= iCapacity || inCapacity > MaxSize) return;
+
 	// create new array (initialises)
-	C4Value *pnData = new C4Value[inSize];
+	C4Value *pnData = new C4Value[inCapacity];
 	if (!pnData) return;
 
 	// move existing values
@@ -138,7 +154,7 @@ void C4ValueList::SetSize(int32_t inSize)
 	// replace
 	delete[] pData;
 	pData = pnData;
-	iSize = inSize;
+	iCapacity = inCapacity;
 }
 
 bool C4ValueList::operator==(const C4ValueList &IntList2) const
@@ -153,7 +169,7 @@ bool C4ValueList::operator==(const C4ValueList &IntList2) const
 void C4ValueList::Reset()
 {
 	delete[] pData; pData = nullptr;
-	iSize = 0;
+	iSize = iCapacity = 0;
 }
 
 void C4ValueList::DenumeratePointers()
@@ -202,6 +218,22 @@ void C4ValueList::CompileFunc(class StdCompiler *pComp)
 	}
 }
 
+namespace
+{
+	// released small arrays, kept so short-lived arrays like literals don't need allocations
+	struct C4ValueArrayPool
+	{
+		static constexpr size_t MaxArrays = 64;
+		static constexpr int32_t MaxCapacity = 32;
+
+		std::vector<C4ValueArray *> Arrays;
+
+		~C4ValueArrayPool() { for (C4ValueArray *pArray : Arrays) delete pArray; }
+	};
+
+	thread_local C4ValueArrayPool ArrayPool;
+}
+
 C4ValueArray::C4ValueArray()
 	: C4ValueList() {}
 
@@ -213,6 +245,30 @@ C4ValueArray::C4ValueArray(const C4ValueArray &Array2)
 
 C4ValueArray::~C4ValueArray() {}
 
+C4ValueArray *C4ValueArray::New(int32_t inSize)
+{
+	if (ArrayPool.Arrays.empty()) return new C4ValueArray(inSize);
+	C4ValueArray *pArray = ArrayPool.Arrays.back();
+	ArrayPool.Arrays.pop_back();
+	pArray->SetSize(inSize);
+	return pArray;
+}
+
+void C4ValueArray::Destroy(C4ValueArray *pArray)
+{
+	if (pArray->iCapacity <= C4ValueArrayPool::MaxCapacity)
+	{
+		// releasing the values may release other arrays
+		pArray->SetSize(0);
+		if (ArrayPool.Arrays.size() < C4ValueArrayPool::MaxArrays)
+		{
+			ArrayPool.Arrays.push_back(pArray);
+			return;
+		}
+	}
+	delete pArray;
+}
+
 C4ValueArray *C4ValueArray::SetLength(int32_t size)
 {
 	if (GetRefCount() > 1)
@@ -35,6 +35,7 @@ public:
 
 protected:
 	int32_t iSize;
+	int32_t iCapacity; // allocated elements; those beyond iSize are nil
 	C4Value *pData;
 
 public:
@@ -49,7 +50,8 @@ public:
 	C4Value &operator[](int32_t iElem) { return GetItem(iElem); }
 
 	void Reset();
-	void SetSize(int32_t inSize); // (enlarge only!)
+	void SetSize(int32_t inSize); // shrinking keeps the allocation and sets the values cut off to nil
+	void Reserve(int32_t inCapacity); // allocate at least inCapacity elements; never shrinks
 
 	void DenumeratePointers();
 
@@ -61,6 +63,9 @@ public:
 };
 
 // value list with reference count, used for arrays
+// Writes to a shared array copy all of it. There is no per-element copy-on-write and no lazy
+// slice or concatenation view: element references (C4V_pC4Value) point straight into pData
+// and are relinked when values move, so storage must neither be shared nor materialized late.
 class C4ValueArray : public C4ValueList, public C4ValueStandardRefCountedContainer<C4ValueArray>
 {
 public:
@@ -69,6 +74,8 @@ public:
 
 	~C4ValueArray();
 
+	static C4ValueArray *New(int32_t inSize = 0); // reuses released arrays if possible
+
 	// Change length, return self or new copy if necessary
 	C4ValueArray *SetLength(int32_t size);
 	virtual bool hasIndex(const C4Value &index) const override;
@@ -89,4 +96,5 @@ private:
 	// Only for IncRef/AddElementRef
 	friend C4ValueStandardRefCountedContainer<C4ValueArray>;
 	C4ValueArray(const C4ValueArray &Array2);
+	static void Destroy(C4ValueArray *pArray);
 };
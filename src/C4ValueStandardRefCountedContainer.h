@@ -40,7 +40,7 @@ public:
 		assert(referenceCount);
 		if (!--referenceCount)
 		{
-			delete this;
+			T::Destroy(static_cast<T *>(this));
 		}
 	}
 
@@ -69,4 +69,10 @@ protected:
 	{
 		return referenceCount;
 	}
+
+	// called when the last reference is gone; containers may keep themselves for reuse instead
+	static void Destroy(T *container)
+	{
+		delete container;
+	}
 };
\ No newline at end of file
@@ -1103,7 +1103,21 @@ void C4Viewport::Draw(C4FacetEx &cgo, bool fDrawOverlay)
 
 	// Netstats
 	if (Game.GraphicsSystem.ShowNetstatus)
+	{
 		Game.Network.DrawStatus(cgo);
+		Game.Particles.DrawStatus(cgo);
+		Game.PathFinder.DrawStatus(cgo);
+		Game.TimerStats.DrawStatus(cgo);
+		Game.FindObjectCache.DrawStatus(cgo);
+#ifndef USE_CONSOLE
+		if (pGL)
+			Application.DDraw->TextOut(FormatString("Draw calls: %d (%d vertices, %d textured)", pGL->LastDrawCalls, pGL->LastVertexCnt, pGL->LastTexturedDrawCalls).getData(),
+				Game.GraphicsResource.FontRegular, 1.0, cgo.Surface, cgo.X + 20, cgo.Y + cgo.Hgt - 70);
+#endif
+		const int64_t iLayoutLookups = CStdFont::LayoutCacheHits + CStdFont::LayoutCacheMisses;
+		Application.DDraw->TextOut(FormatString("Text layouts: %d%% cached", iLayoutLookups ? static_cast<int>(CStdFont::LayoutCacheHits * 100 / iLayoutLookups) : 0).getData(),
+			Game.GraphicsResource.FontRegular, 1.0, cgo.Surface, cgo.X + 20, cgo.Y + cgo.Hgt - 90);
+	}
 
 	C4ST_STOP(OvrStat)
 
@@ -311,11 +311,13 @@ struct StdArrayAdapt
 
 	inline void CompileFunc(StdCompiler *pComp) const
 	{
+		pComp->setInsideArray(+1);
 		for (int i = 0; i < iSize; i++)
 		{
 			if (i) pComp->Separator(StdCompiler::SEP_SEP);
 			pComp->Value(map(pArray[i]));
 		}
+		pComp->setInsideArray(-1);
 	}
 
 	// Operators for default checking/setting
@@ -377,6 +379,7 @@ struct StdArrayDefaultAdapt
 			while (iWrite > 0 && pArray[iWrite - 1] == rDefault)
 				iWrite--;
 		// Read/write values
+		pComp->setInsideArray(+1);
 		for (i = 0; i < iWrite; i++)
 		{
 			// Separator?
@@ -384,6 +387,7 @@ struct StdArrayDefaultAdapt
 			// Expect a value. Default if not found.
 			pComp->Value(mkDefaultAdapt(map(pArray[i]), rDefault));
 		}
+		pComp->setInsideArray(-1);
 		// Fill rest of array
 		if (fCompiler)
 			for (; i < iSize; i++)
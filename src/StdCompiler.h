@@ -64,6 +64,12 @@ public:
 	// callback by runtime-write-allowed adaptor used by compilers that may set runtime values only
 	virtual void setRuntimeWritesAllowed(int32_t iChange) {}
 
+	// callback by array adaptors used by compilers that must tell array elements from single values
+	virtual void setInsideArray(int32_t iChange) {}
+
+	// callback around values only some instances of a structure have, used by compilers that remember where values are stored
+	virtual void setConditional(int32_t iChange) {}
+
 	// * Naming
 	// Provides extra data for the compiler so he can deal with reordered data.
 	// Note that sections stack and each section will get compiled only once.
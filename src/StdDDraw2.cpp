@@ -697,6 +697,7 @@ bool CStdDDraw::Blit(CSurface *sfcSource, float fx, float fy, float fwdt, float
 	// blit with basesfc?
 	bool fBaseSfc = false;
 	if (sfcSource->pMainSfc) if (sfcSource->pMainSfc->ppTex) fBaseSfc = true;
+	CSurface *const sfcBase = fBaseSfc ? sfcSource->pMainSfc : sfcSource;
 	// set blitting state - done by PerformBlt
 	// get involved texture offsets
 	int iTexSize = sfcSource->iTexSize;
@@ -756,9 +757,12 @@ bool CStdDDraw::Blit(CSurface *sfcSource, float fx, float fy, float fwdt, float
 					// - apply back scaling and texture-indent - simply scale matrix down
 					// - finally, move in texture - this must be done last, so no stupid zoom is applied...
 					// Set resulting matrix directly
+					// - atlas surfaces are additionally moved to their position in the shared texture
+					const float fTexX = (fTexBlt.left + DDrawCfg.fTexIndent) / iTexSize - (tTexBlt.left + DDrawCfg.fBlitOff) / scaleX2;
+					const float fTexY = (fTexBlt.top  + DDrawCfg.fTexIndent) / iTexSize - (tTexBlt.top  + DDrawCfg.fBlitOff) / scaleY2;
 					BltData.TexPos.SetMoveScale(
-						(fTexBlt.left + DDrawCfg.fTexIndent) / iTexSize - (tTexBlt.left + DDrawCfg.fBlitOff) / scaleX2,
-						(fTexBlt.top  + DDrawCfg.fTexIndent) / iTexSize - (tTexBlt.top  + DDrawCfg.fBlitOff) / scaleY2,
+						fTexX + static_cast<float>(sfcBase->iTexOffX) / iTexSize,
+						fTexY + static_cast<float>(sfcBase->iTexOffY) / iTexSize,
 						1 / scaleX2,
 						1 / scaleY2);
 					// set up blit data as rect
@@ -773,15 +777,19 @@ bool CStdDDraw::Blit(CSurface *sfcSource, float fx, float fy, float fwdt, float
 					if (fBaseSfc)
 					{
 						// then get this surface as same offset as from other surface
-						// assuming this is only valid as long as there's no texture management,
-						// organizing partially used textures together!
-						pBaseTex = *(sfcSource->pMainSfc->ppTex + iY * sfcSource->iTexX + iX);
+						// the atlas keeps the tiling of both surfaces equal
+						pBaseTex = *(sfcBase->ppTex + iY * sfcSource->iTexX + iX);
 					}
 					// base blit
 					PerformBlt(BltData, pBaseTex, BlitModulated ? BlitModulateClr : 0xffffff, !!(dwBlitMode & C4GFXBLIT_MOD2), fExact);
 					// overlay
 					if (fBaseSfc)
 					{
+						BltData.TexPos.SetMoveScale(
+							fTexX + static_cast<float>(sfcSource->iTexOffX) / iTexSize,
+							fTexY + static_cast<float>(sfcSource->iTexOffY) / iTexSize,
+							1 / scaleX2,
+							1 / scaleY2);
 						uint32_t dwModClr = sfcSource->ClrByOwnerClr;
 						// apply global modulation to overlay surfaces only if desired
 						if (BlitModulated && !(dwBlitMode & C4GFXBLIT_CLRSFC_OWNCLR))
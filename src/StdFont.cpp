@@ -685,6 +685,7 @@ void CStdFont::Clear()
 	iNumFontSfcs = 0;
 	for (int c = ' '; c < 256; ++c) fctAsciiTexCoords[c - ' '].Clear();
 	fctUnicodeMap.clear();
+	ClearLayoutCache();
 	// set default values
 	dwDefFontHeight = iLineHgt = 10;
 	iFontZoom = 1; // default: no internal font zooming - likely no antialiasing either...
@@ -699,17 +700,99 @@ void CStdFont::Clear()
 	id = 0;
 }
 
+/* Text layout cache */
+
+int64_t CStdFont::LayoutCacheHits = 0;
+int64_t CStdFont::LayoutCacheMisses = 0;
+
+bool CStdFont::LayoutKey::operator==(const LayoutKey &rOther) const
+{
+	return fBreak == rOther.fBreak && iWdt == rOther.iWdt && fZoom == rOther.fZoom && maxLines == rOther.maxLines
+		&& fCheckMarkup == rOther.fCheckMarkup && fIgnoreScale == rOther.fIgnoreScale && Text == rOther.Text;
+}
+
+size_t CStdFont::LayoutKeyHash::operator()(const LayoutKey &rKey) const
+{
+	size_t iHash = std::hash<std::string_view>{}(rKey.Text);
+	const auto Combine = [&iHash](size_t iValue) { iHash ^= iValue + 0x9e3779b9 + (iHash << 6) + (iHash >> 2); };
+	Combine(std::hash<int32_t>{}(rKey.iWdt));
+	Combine(std::hash<float>{}(rKey.fZoom));
+	Combine(rKey.maxLines);
+	Combine(rKey.fBreak | rKey.fCheckMarkup << 1 | rKey.fIgnoreScale << 2);
+	return iHash;
+}
+
+const CStdFont::Layout *CStdFont::LookupLayout(const LayoutKey &rKey)
+{
+	const auto it = LayoutIndex.find(rKey);
+	if (it == LayoutIndex.end()) { ++LayoutCacheMisses; return nullptr; }
+	++LayoutCacheHits;
+	// mark as most recently used
+	LayoutCache.splice(LayoutCache.begin(), LayoutCache, it->second);
+	return &*it->second;
+}
+
+CStdFont::Layout &CStdFont::StoreLayout(const LayoutKey &rKey)
+{
+	// drop least recently used entry
+	if (LayoutCache.size() >= LayoutCacheSize)
+	{
+		LayoutIndex.erase(LayoutCache.back().Key);
+		LayoutCache.pop_back();
+	}
+	LayoutCache.emplace_front();
+	Layout &rLayout = LayoutCache.front();
+	rLayout.Text = rKey.Text;
+	rLayout.Key = rKey;
+	rLayout.Key.Text = rLayout.Text;
+	LayoutIndex.emplace(rLayout.Key, LayoutCache.begin());
+	return rLayout;
+}
+
+void CStdFont::ClearLayoutCache()
+{
+	LayoutIndex.clear();
+	LayoutCache.clear();
+}
+
+// images may not be available yet when a text is measured first, so texts containing them aren't cached
+static bool IsLayoutCacheable(const char *szText, bool fCheckMarkup)
+{
+	return !fCheckMarkup || !SSearch(szText, "{{");
+}
+
 /* Text size measurement */
 
 bool CStdFont::GetTextExtent(const char *szText, int32_t &rsx, int32_t &rsy, bool fCheckMarkup, bool ignoreScale)
+{
+	// safety
+	if (!szText) return false;
+	// repeated texts are looked up in the cache
+	if (!IsLayoutCacheable(szText, fCheckMarkup))
+	{
+		MeasureText(szText, rsx, rsy, fCheckMarkup, ignoreScale);
+		return true;
+	}
+	const LayoutKey Key{szText, false, 0, 1.f, 0, fCheckMarkup, ignoreScale};
+	if (const Layout *pLayout = LookupLayout(Key))
+	{
+		rsx = pLayout->iWdt; rsy = pLayout->iHgt;
+		return true;
+	}
+	MeasureText(szText, rsx, rsy, fCheckMarkup, ignoreScale);
+	Layout &rLayout = StoreLayout(Key);
+	rLayout.iWdt = rsx; rLayout.iHgt = rsy;
+	// done, success
+	return true;
+}
+
+void CStdFont::MeasureText(const char *szText, int32_t &rsx, int32_t &rsy, bool fCheckMarkup, bool ignoreScale)
 {
 	float realScale = 1.f;
 	if (!ignoreScale)
 	{
 		realScale = scale;
 	}
-	// safety
-	if (!szText) return false;
 	// keep track of each row's size
 	int lineStepHeight = static_cast<int>(std::ceil(iLineHgt / realScale));
 	float iRowWdt = 0, iWdt = 0;
@@ -766,14 +849,29 @@ bool CStdFont::GetTextExtent(const char *szText, int32_t &rsx, int32_t &rsy, boo
 	}
 	// store output
 	rsx = static_cast<int>(iWdt); rsy = iHgt;
-	// done, success
-	return true;
 }
 
 int CStdFont::BreakMessage(const char *szMsg, int iWdt, StdStrBuf *pOut, bool fCheckMarkup, float fZoom, size_t maxLines)
 {
 	// safety
 	if (!szMsg || !pOut) return 0;
+	// repeated texts are looked up in the cache
+	if (!IsLayoutCacheable(szMsg, fCheckMarkup)) return IntBreakMessage(szMsg, iWdt, pOut, fCheckMarkup, fZoom, maxLines);
+	const LayoutKey Key{szMsg, true, iWdt, fZoom, maxLines, fCheckMarkup, false};
+	if (const Layout *pLayout = LookupLayout(Key))
+	{
+		pOut->Copy(pLayout->BrokenText);
+		return pLayout->iHgt;
+	}
+	const int iHgt = IntBreakMessage(szMsg, iWdt, pOut, fCheckMarkup, fZoom, maxLines);
+	Layout &rLayout = StoreLayout(Key);
+	rLayout.BrokenText.Copy(*pOut);
+	rLayout.iWdt = iWdt; rLayout.iHgt = iHgt;
+	return iHgt;
+}
+
+int CStdFont::IntBreakMessage(const char *szMsg, int iWdt, StdStrBuf *pOut, bool fCheckMarkup, float fZoom, size_t maxLines)
+{
 	pOut->Clear();
 	uint32_t c;
 	const char *szPos = szMsg, // current parse position in the text
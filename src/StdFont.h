@@ -24,7 +24,11 @@
 #include <StdFacet.h>
 #include <StdBuf.h>
 #include <stdio.h>
+#include <list>
 #include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #ifdef _WIN32
 #include <tchar.h>
 #endif
@@ -121,7 +125,46 @@ protected:
 	int iLineHgt; // height of one line of font (in pixels)
 	float scale = 1.f;
 
+	// cache of measured and broken texts, so repeated labels don't have to be parsed again
+	struct LayoutKey
+	{
+		std::string_view Text; // points into the owning cache entry
+		bool fBreak; // BreakMessage result instead of text extent
+		int32_t iWdt;
+		float fZoom;
+		size_t maxLines;
+		bool fCheckMarkup, fIgnoreScale;
+
+		bool operator==(const LayoutKey &rOther) const;
+	};
+
+	struct LayoutKeyHash
+	{
+		size_t operator()(const LayoutKey &rKey) const;
+	};
+
+	struct Layout
+	{
+		std::string Text;
+		LayoutKey Key;
+		int32_t iWdt, iHgt; // text extent; iHgt is the overall height for broken texts
+		StdStrBuf BrokenText;
+	};
+
+	static const size_t LayoutCacheSize = 256; // number of texts cached per font
+	std::list<Layout> LayoutCache; // most recently used first
+	std::unordered_map<LayoutKey, std::list<Layout>::iterator, LayoutKeyHash> LayoutIndex;
+
+	const Layout *LookupLayout(const LayoutKey &rKey);
+	Layout &StoreLayout(const LayoutKey &rKey);
+	void ClearLayoutCache();
+
+	void MeasureText(const char *szText, int32_t &rsx, int32_t &rsy, bool fCheckMarkup, bool ignoreScale);
+	int IntBreakMessage(const char *szMsg, int iWdt, StdStrBuf *pOut, bool fCheckMarkup, float fZoom, size_t maxLines);
+
 public:
+	static int64_t LayoutCacheHits, LayoutCacheMisses; // lookups of all fonts
+
 	// draw ine line of text
 	void DrawText(CSurface *sfcDest, int iX, int iY, uint32_t dwColor, const char *szText, uint32_t dwFlags, CMarkup &Markup, float fZoom);
 
@@ -164,6 +207,7 @@ public:
 	void SetCustomImages(CustomImages *pHandler)
 	{
 		pCustomImages = pHandler;
+		ClearLayoutCache();
 	}
 };
 
@@ -28,6 +28,9 @@
 #include <math.h>
 #include <limits.h>
 
+#include <cstdint>
+#include <iterator>
+
 static void glColorDw(const uint32_t dwClr)
 {
 	glColor4ub(
@@ -37,6 +40,19 @@ static void glColorDw(const uint32_t dwClr)
 		static_cast<GLubyte>(dwClr >> 24));
 }
 
+static void SetVertexClr(CStdGLVertex &rVtx, const uint32_t dwClr)
+{
+	rVtx.clr[0] = static_cast<uint8_t>(dwClr >> 16);
+	rVtx.clr[1] = static_cast<uint8_t>(dwClr >> 8);
+	rVtx.clr[2] = static_cast<uint8_t>(dwClr);
+	rVtx.clr[3] = static_cast<uint8_t>(dwClr >> 24);
+}
+
+static void SetVertexPos(CStdGLVertex &rVtx, const float x, const float y)
+{
+	rVtx.x = x; rVtx.y = y; rVtx.z = 0.0f; rVtx.w = 1.0f;
+}
+
 CStdGL::CStdGL()
 {
 	Default();
@@ -81,6 +97,12 @@ bool CStdGL::PageFlip(RECT *, RECT *, CStdWindow *)
 	if (!pApp || !pApp->AssertMainThread()) return false;
 	// safety
 	if (!pCurrCtx) return false;
+	// draw pending primitives and rotate counters
+	FlushBatch();
+	LastDrawCalls = iDrawCalls;
+	LastVertexCnt = iVertexCnt;
+	LastTexturedDrawCalls = iTexturedDrawCalls;
+	iDrawCalls = iVertexCnt = iTexturedDrawCalls = 0;
 	// end the scene and present it
 	if (!pCurrCtx->PageFlip()) return false;
 	// success!
@@ -90,6 +112,7 @@ bool CStdGL::PageFlip(RECT *, RECT *, CStdWindow *)
 void CStdGL::FillBG(const uint32_t dwClr)
 {
 	if (!pCurrCtx && !MainCtx.Select()) return;
+	FlushBatch();
 	glClearColor(
 		GetBValue(dwClr) / 255.0f,
 		GetGValue(dwClr) / 255.0f,
@@ -100,6 +123,8 @@ void CStdGL::FillBG(const uint32_t dwClr)
 
 bool CStdGL::UpdateClipper()
 {
+	// pending primitives belong to the old clipper
+	FlushBatch();
 	int iX, iY, iWdt, iHgt;
 	// no render target or clip all? do nothing
 	if (!CalculateClipper(&iX, &iY, &iWdt, &iHgt)) return true;
@@ -176,126 +201,70 @@ void CStdGL::PerformBlt(CBltData &rBltData, CTexRef *const pTex,
 	}
 	// reset MOD2 for completely black modulations
 	if (fMod2 && !fAnyModNotBlack) fMod2 = 0;
-	if (shader)
+	// collect render state
+	CStdGLBatchState State;
+	State.Tex = pTex->texName;
+	State.BlendDst = (dwBlitMode & C4GFXBLIT_ADDITIVE) ? GL_ONE : GL_SRC_ALPHA;
+	if (shader || shaders[0])
 	{
-		glEnable(GL_FRAGMENT_SHADER_ATI);
-		if (!fModClr) glColor4f(1.0f, 1.0f, 1.0f, 0.0f);
 		dwModMask = 0;
-		if (Saturation < 255)
-		{
-			glBindFragmentShaderATI(fMod2 ? shader + 3 : shader + 2);
-			const GLfloat value[4] =
-				{ Saturation / 255.0f, Saturation / 255.0f, Saturation / 255.0f, 1.0f };
-			glSetFragmentShaderConstantATI(GL_CON_1_ATI, value);
-		}
-		else
-		{
-			glBindFragmentShaderATI(fMod2 ? shader + 1 : shader);
-		}
-	}
-	else if (shaders[0])
-	{
-		glEnable(GL_FRAGMENT_PROGRAM_ARB);
-		if (!fModClr) glColor4f(1.0f, 1.0f, 1.0f, 0.0f);
-		dwModMask = 0;
-		if (Saturation < 255)
-		{
-			glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, shaders[fMod2 ? 3 : 2]);
-			const GLfloat value[4] =
-				{ Saturation / 255.0f, Saturation / 255.0f, Saturation / 255.0f, 1.0f };
-			glProgramLocalParameter4fvARB(GL_FRAGMENT_PROGRAM_ARB, 0, value);
-		}
-		else
-		{
-			glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, shaders[fMod2 ? 1 : 0]);
-		}
+		State.Program = (fMod2 ? 1 : 0) + (Saturation < 255 ? 2 : 0);
+		if (Saturation < 255) State.Saturation = Saturation;
 	}
 	// modulated blit
 	else if (fModClr)
 	{
 		if (fMod2 || ((dwModClr >> 24 || dwModMask) && !DDrawCfg.NoAlphaAdd))
 		{
-			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB,      fMod2 ? GL_ADD_SIGNED : GL_MODULATE);
-			glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE,        fMod2 ? 2.0f : 1.0f);
-			glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA,    GL_ADD);
-			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB,      GL_TEXTURE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_RGB,      GL_PRIMARY_COLOR);
-			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA,    GL_TEXTURE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA,    GL_PRIMARY_COLOR);
-			glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB,     GL_SRC_COLOR);
-			glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_RGB,     GL_SRC_COLOR);
-			glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA,   GL_SRC_ALPHA);
-			glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA,   GL_SRC_ALPHA);
+			State.TexEnv = fMod2 ? CStdGLBatchState::TexEnvMod2 : CStdGLBatchState::TexEnvAddAlpha;
 			dwModMask = 0;
 		}
 		else
 		{
-			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-			glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE,        1.0f);
+			State.TexEnv = CStdGLBatchState::TexEnvModulate;
 			dwModMask = 0xff000000;
 		}
 	}
-	else
-	{
-		glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
-		glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE, 1.0f);
-	}
-	// set texture+modes
-	glShadeModel((fUseClrModMap && fModClr && !DDrawCfg.NoBoxFades) ? GL_SMOOTH : GL_FLAT);
-	glBindTexture(GL_TEXTURE_2D, pTex->texName);
-	if (pApp->GetScale() != 1.f || (!fExact && !DDrawCfg.PointFiltering))
-	{
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	}
-
-	glMatrixMode(GL_TEXTURE);
-	float matrix[16];
-	matrix[0] = rBltData.TexPos.mat[0];  matrix[ 1] = rBltData.TexPos.mat[3];  matrix[ 2] = 0; matrix[ 3] = rBltData.TexPos.mat[6];
-	matrix[4] = rBltData.TexPos.mat[1];  matrix[ 5] = rBltData.TexPos.mat[4];  matrix[ 6] = 0; matrix[ 7] = rBltData.TexPos.mat[7];
-	matrix[8] = 0;                       matrix[ 9] = 0;                       matrix[10] = 1; matrix[11] = 0;
-	matrix[12] = rBltData.TexPos.mat[2]; matrix[13] = rBltData.TexPos.mat[5];  matrix[14] = 0; matrix[15] = rBltData.TexPos.mat[8];
-	glLoadMatrixf(matrix);
+	State.fSmooth = fUseClrModMap && fModClr && !DDrawCfg.NoBoxFades;
+	State.fLinear = pApp->GetScale() != 1.f || (!fExact && !DDrawCfg.PointFiltering);
 
-	glMatrixMode(GL_MODELVIEW);
-	if (rBltData.pTransform)
-	{
-		const float *const mat = rBltData.pTransform->mat;
-		matrix[ 0] = mat[0]; matrix[ 1] = mat[3]; matrix[ 2] = 0; matrix[ 3] = mat[6];
-		matrix[ 4] = mat[1]; matrix[ 5] = mat[4]; matrix[ 6] = 0; matrix[ 7] = mat[7];
-		matrix[ 8] = 0;      matrix[ 9] = 0;      matrix[10] = 1; matrix[11] = 0;
-		matrix[12] = mat[2]; matrix[13] = mat[5]; matrix[14] = 0; matrix[15] = mat[8];
-		glLoadMatrixf(matrix);
-	}
-	else
-	{
-		glLoadIdentity();
-	}
-
-	// draw polygon
-	glBegin(GL_POLYGON);
+	// apply texture and vertex transformation here, so blits with different matrices can share a batch
+	CStdGLVertex Vtx[std::size(rBltData.vtVtx)];
+	const float *const tex = rBltData.TexPos.mat;
 	for (int i = 0; i < rBltData.byNumVertices; ++i)
 	{
 		const auto &vtx = rBltData.vtVtx[i];
-		if (fModClr) glColorDw(vtx.dwModClr | dwModMask);
-		glTexCoord2f(vtx.ftx, vtx.fty);
-		glVertex2f(vtx.ftx, vtx.fty);
-	}
-	glEnd();
-	glLoadIdentity();
-	if (shader)
-	{
-		glDisable(GL_FRAGMENT_SHADER_ATI);
-	}
-	else if (shaders[0])
-	{
-		glDisable(GL_FRAGMENT_PROGRAM_ARB);
+		Vtx[i].s = tex[0] * vtx.ftx + tex[1] * vtx.fty + tex[2];
+		Vtx[i].t = tex[3] * vtx.ftx + tex[4] * vtx.fty + tex[5];
+		Vtx[i].r = 0.0f;
+		Vtx[i].q = tex[6] * vtx.ftx + tex[7] * vtx.fty + tex[8];
+		if (rBltData.pTransform)
+		{
+			const float *const mat = rBltData.pTransform->mat;
+			Vtx[i].x = mat[0] * vtx.ftx + mat[1] * vtx.fty + mat[2];
+			Vtx[i].y = mat[3] * vtx.ftx + mat[4] * vtx.fty + mat[5];
+			Vtx[i].w = mat[6] * vtx.ftx + mat[7] * vtx.fty + mat[8];
+		}
+		else
+		{
+			Vtx[i].x = vtx.ftx;
+			Vtx[i].y = vtx.fty;
+			Vtx[i].w = 1.0f;
+		}
+		Vtx[i].z = 0.0f;
+		// flat shaded polygons take the color of their first vertex
+		SetVertexClr(Vtx[i], !fModClr ? 0x00ffffff : (State.fSmooth ? vtx.dwModClr : rBltData.vtVtx[0].dwModClr) | dwModMask);
 	}
-	if (pApp->GetScale() != 1.f || (!fExact && !DDrawCfg.PointFiltering))
+
+	// add polygon as triangle fan
+	const int iTriCnt = rBltData.byNumVertices - 2;
+	if (iTriCnt <= 0) return;
+	CStdGLVertex *pOut = AddToBatch(State, iTriCnt * 3);
+	for (int i = 0; i < iTriCnt; ++i)
 	{
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		*pOut++ = Vtx[0];
+		*pOut++ = Vtx[i + 1];
+		*pOut++ = Vtx[i + 2];
 	}
 }
 
@@ -317,6 +286,8 @@ void CStdGL::BlitLandscape(CSurface *const sfcSource, CSurface *const sfcSource2
 	if (!PrepareRendering(sfcTarget)) return;
 	// texture present?
 	if (!sfcSource->ppTex) return;
+	// landscape is drawn directly
+	FlushBatch();
 	// blit with basesfc?
 	bool fBaseSfc = false;
 	// get involved texture offsets
@@ -530,6 +501,8 @@ void CStdGL::BlitLandscape(CSurface *const sfcSource, CSurface *const sfcSource2
 					}
 
 					glEnd();
+					++iDrawCalls; ++iTexturedDrawCalls;
+					iVertexCnt += 4;
 				}
 			}
 		}
@@ -630,25 +603,26 @@ void CStdGL::DrawQuadDw(CSurface *const sfcTarget, int *const ipVtx,
 		ModulateClr(dwClr3, pClrModMap->GetModAt(ipVtx[4], ipVtx[5]));
 		ModulateClr(dwClr4, pClrModMap->GetModAt(ipVtx[6], ipVtx[7]));
 	}
+	CStdGLBatchState State;
 	// no clr fading supported
 	if (DDrawCfg.NoBoxFades)
-	{
 		NormalizeColors(dwClr1, dwClr2, dwClr3, dwClr4);
-		glShadeModel(GL_FLAT);
-	}
 	else
-		glShadeModel((dwClr1 == dwClr2 && dwClr1 == dwClr3 && dwClr1 == dwClr4) ? GL_FLAT : GL_SMOOTH);
+		State.fSmooth = !(dwClr1 == dwClr2 && dwClr1 == dwClr3 && dwClr1 == dwClr4);
 	// set blitting state
 	const int iAdditive = dwBlitMode & C4GFXBLIT_ADDITIVE;
-	glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, iAdditive ? GL_ONE : GL_SRC_ALPHA);
+	State.BlendDst = iAdditive ? GL_ONE : GL_SRC_ALPHA;
 	// draw two triangles
-	glBegin(GL_POLYGON);
-	glColorDw(dwClr1); glVertex2f(ipVtx[0] + DDrawCfg.fBlitOff, ipVtx[1] + DDrawCfg.fBlitOff);
-	glColorDw(dwClr2); glVertex2f(ipVtx[2] + DDrawCfg.fBlitOff, ipVtx[3] + DDrawCfg.fBlitOff);
-	glColorDw(dwClr3); glVertex2f(ipVtx[4] + DDrawCfg.fBlitOff, ipVtx[5] + DDrawCfg.fBlitOff);
-	glColorDw(dwClr4); glVertex2f(ipVtx[6] + DDrawCfg.fBlitOff, ipVtx[7] + DDrawCfg.fBlitOff);
-	glEnd();
-	glShadeModel(GL_FLAT);
+	CStdGLVertex Vtx[4];
+	const uint32_t dwClrs[4] = { dwClr1, dwClr2, dwClr3, dwClr4 };
+	for (int i = 0; i < 4; ++i)
+	{
+		SetVertexPos(Vtx[i], ipVtx[i * 2] + DDrawCfg.fBlitOff, ipVtx[i * 2 + 1] + DDrawCfg.fBlitOff);
+		SetVertexClr(Vtx[i], dwClrs[i]);
+	}
+	CStdGLVertex *const pOut = AddToBatch(State, 6);
+	pOut[0] = Vtx[0]; pOut[1] = Vtx[1]; pOut[2] = Vtx[2];
+	pOut[3] = Vtx[0]; pOut[4] = Vtx[2]; pOut[5] = Vtx[3];
 }
 
 void CStdGL::DrawLineDw(CSurface *const sfcTarget,
@@ -662,28 +636,27 @@ void CStdGL::DrawLineDw(CSurface *const sfcTarget,
 	if (!PrepareRendering(sfcTarget)) return;
 	// set blitting state
 	const int iAdditive = dwBlitMode & C4GFXBLIT_ADDITIVE;
+	CStdGLBatchState State;
+	State.Mode = GL_LINES;
 	// use a different blendfunc here, because GL_LINE_SMOOTH expects this one
-	glBlendFunc(GL_SRC_ALPHA, iAdditive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
-	// draw one line
-	glBegin(GL_LINES);
+	State.BlendSrc = GL_SRC_ALPHA;
+	State.BlendDst = iAdditive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA;
 	// global clr modulation map
 	uint32_t dwClr1 = dwClr;
 	if (fUseClrModMap)
 	{
 		ModulateClr(dwClr1, pClrModMap->GetModAt(
 			static_cast<int>(x1), static_cast<int>(y1)));
-	}
-	// convert from clonk-alpha to GL_LINE_SMOOTH alpha
-	glColorDw(InvertRGBAAlpha(dwClr1));
-	glVertex2f(x1 + 0.5f, y1 + 0.5f);
-	if (fUseClrModMap)
-	{
 		ModulateClr(dwClr, pClrModMap->GetModAt(
 			static_cast<int>(x2), static_cast<int>(y2)));
-		glColorDw(InvertRGBAAlpha(dwClr));
 	}
-	glVertex2f(x2 + 0.5f, y2 + 0.5f);
-	glEnd();
+	// draw one line
+	CStdGLVertex *const pOut = AddToBatch(State, 2);
+	// convert from clonk-alpha to GL_LINE_SMOOTH alpha
+	SetVertexPos(pOut[0], x1 + 0.5f, y1 + 0.5f);
+	SetVertexClr(pOut[0], InvertRGBAAlpha(dwClr1));
+	SetVertexPos(pOut[1], x2 + 0.5f, y2 + 0.5f);
+	SetVertexClr(pOut[1], InvertRGBAAlpha(dwClr));
 }
 
 void CStdGL::DrawPixInt(CSurface *const sfcTarget,
@@ -694,13 +667,15 @@ void CStdGL::DrawPixInt(CSurface *const sfcTarget,
 
 	if (!PrepareRendering(sfcTarget)) return;
 	const int iAdditive = dwBlitMode & C4GFXBLIT_ADDITIVE;
+	CStdGLBatchState State;
+	State.Mode = GL_POINTS;
 	// use a different blendfunc here because of GL_POINT_SMOOTH
-	glBlendFunc(GL_SRC_ALPHA, iAdditive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+	State.BlendSrc = GL_SRC_ALPHA;
+	State.BlendDst = iAdditive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA;
 	// convert the alpha value for that blendfunc
-	glBegin(GL_POINTS);
-	glColorDw(InvertRGBAAlpha(dwClr));
-	glVertex2f(tx + 0.5f, ty + 0.5f);
-	glEnd();
+	CStdGLVertex *const pOut = AddToBatch(State, 1);
+	SetVertexPos(pOut[0], tx + 0.5f, ty + 0.5f);
+	SetVertexClr(pOut[0], InvertRGBAAlpha(dwClr));
 }
 
 static void DefineShaderARB(const char *const p, GLuint &s)
@@ -734,6 +709,8 @@ bool CStdGL::RestoreDeviceObjects()
 	if (Active) EnableGamma();
 	// reset blit states
 	dwBlitMode = 0;
+	// create streaming buffer for batched primitives; client arrays are used otherwise
+	if (Active && !BatchBuffer && GLEW_VERSION_1_5) glGenBuffers(1, &BatchBuffer);
 
 	if (!DDrawCfg.Shader)
 	{
@@ -954,6 +931,128 @@ bool CStdGL::RestoreDeviceObjects()
 	return Active;
 }
 
+CStdGLVertex *CStdGL::AddToBatch(const CStdGLBatchState &State, const size_t iCnt)
+{
+	if (!BatchVertices.empty() && (!(State == BatchState) || BatchVertices.size() + iCnt > MaxBatchVertices))
+		FlushBatch();
+	BatchState = State;
+	const size_t iStart = BatchVertices.size();
+	BatchVertices.resize(iStart + iCnt);
+	return &BatchVertices[iStart];
+}
+
+void CStdGL::FlushBatch()
+{
+	// batches are filled and drawn by the gfx thread only
+	if (!pApp || !pApp->IsMainThread() || BatchVertices.empty()) return;
+	const CStdGLBatchState &State = BatchState;
+	// set state
+	glBlendFunc(State.BlendSrc, State.BlendDst);
+	glShadeModel(State.fSmooth ? GL_SMOOTH : GL_FLAT);
+	glMatrixMode(GL_TEXTURE);
+	glLoadIdentity();
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+	if (State.Tex)
+	{
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, State.Tex);
+		if (State.fLinear)
+		{
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		}
+		if (State.Program >= 0)
+		{
+			const GLfloat value[4] =
+				{ State.Saturation / 255.0f, State.Saturation / 255.0f, State.Saturation / 255.0f, 1.0f };
+			if (shader)
+			{
+				glEnable(GL_FRAGMENT_SHADER_ATI);
+				glBindFragmentShaderATI(shader + State.Program);
+				if (State.Program >= 2) glSetFragmentShaderConstantATI(GL_CON_1_ATI, value);
+			}
+			else
+			{
+				glEnable(GL_FRAGMENT_PROGRAM_ARB);
+				glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, shaders[State.Program]);
+				if (State.Program >= 2) glProgramLocalParameter4fvARB(GL_FRAGMENT_PROGRAM_ARB, 0, value);
+			}
+		}
+		else if (State.TexEnv == CStdGLBatchState::TexEnvAddAlpha || State.TexEnv == CStdGLBatchState::TexEnvMod2)
+		{
+			const bool fMod2 = State.TexEnv == CStdGLBatchState::TexEnvMod2;
+			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+			glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB,      fMod2 ? GL_ADD_SIGNED : GL_MODULATE);
+			glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE,        fMod2 ? 2.0f : 1.0f);
+			glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA,    GL_ADD);
+			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB,      GL_TEXTURE);
+			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_RGB,      GL_PRIMARY_COLOR);
+			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA,    GL_TEXTURE);
+			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA,    GL_PRIMARY_COLOR);
+			glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB,     GL_SRC_COLOR);
+			glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_RGB,     GL_SRC_COLOR);
+			glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA,   GL_SRC_ALPHA);
+			glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA,   GL_SRC_ALPHA);
+		}
+		else
+		{
+			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, State.TexEnv == CStdGLBatchState::TexEnvModulate ? GL_MODULATE : GL_REPLACE);
+			glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE,        1.0f);
+		}
+	}
+	else
+	{
+		glDisable(GL_TEXTURE_2D);
+	}
+
+	// upload vertices
+	const CStdGLVertex *pBase = BatchVertices.data();
+	if (BatchBuffer)
+	{
+		// orphan the old buffer, so the driver does not have to wait for it
+		const auto iSize = static_cast<GLsizeiptr>(BatchVertices.size() * sizeof(CStdGLVertex));
+		glBindBuffer(GL_ARRAY_BUFFER, BatchBuffer);
+		glBufferData(GL_ARRAY_BUFFER, iSize, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, iSize, pBase);
+		pBase = nullptr;
+	}
+	const auto Attrib = [pBase](const size_t iOffset)
+	{
+		return reinterpret_cast<const GLvoid *>(reinterpret_cast<uintptr_t>(pBase) + iOffset);
+	};
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(4, GL_FLOAT, sizeof(CStdGLVertex), Attrib(offsetof(CStdGLVertex, x)));
+	glEnableClientState(GL_COLOR_ARRAY);
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(CStdGLVertex), Attrib(offsetof(CStdGLVertex, clr)));
+	if (State.Tex)
+	{
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(4, GL_FLOAT, sizeof(CStdGLVertex), Attrib(offsetof(CStdGLVertex, s)));
+	}
+
+	// draw
+	glDrawArrays(State.Mode, 0, static_cast<GLsizei>(BatchVertices.size()));
+	++iDrawCalls;
+	iVertexCnt += static_cast<int32_t>(BatchVertices.size());
+	if (State.Tex) ++iTexturedDrawCalls;
+	BatchVertices.clear();
+
+	// reset state
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	if (BatchBuffer) glBindBuffer(GL_ARRAY_BUFFER, 0);
+	if (State.Program >= 0) glDisable(shader ? GL_FRAGMENT_SHADER_ATI : GL_FRAGMENT_PROGRAM_ARB);
+	if (State.fLinear)
+	{
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	}
+	glDisable(GL_TEXTURE_2D);
+	glShadeModel(GL_FLAT);
+}
+
 bool CStdGL::InvalidateDeviceObjects()
 {
 	// clear gamma
@@ -965,6 +1064,13 @@ bool CStdGL::InvalidateDeviceObjects()
 	// invalidate font objects
 	// invalidate primary surfaces
 	if (lpPrimary) lpPrimary->Clear();
+	// drop pending primitives
+	BatchVertices.clear();
+	if (BatchBuffer)
+	{
+		glDeleteBuffers(1, &BatchBuffer);
+		BatchBuffer = 0;
+	}
 	if (shader)
 	{
 		glDeleteFragmentShaderATI(shader);
@@ -1001,6 +1107,10 @@ void CStdGL::Default()
 {
 	CStdDDraw::Default();
 	sfcFmt = 0;
+	BatchVertices.clear();
+	BatchBuffer = 0;
+	iDrawCalls = iVertexCnt = iTexturedDrawCalls = 0;
+	LastDrawCalls = LastVertexCnt = LastTexturedDrawCalls = 0;
 	MainCtx.Clear();
 }
 
@@ -38,8 +38,43 @@
 #endif
 #include <StdDDraw2.h>
 
+#include <cstddef>
+#include <vector>
+
 class CStdWindow;
 
+// one vertex of a batched primitive
+struct CStdGLVertex
+{
+	float x, y, z, w; // position; transformed already
+	float s, t, r, q; // texture coordinates; transformed already
+	uint8_t clr[4]; // color as RGBA
+};
+
+// render state shared by all primitives of a batch
+// Note: batching has not been tested on Mesa or software renderers yet. It was written without GLEW
+// available, and console builds leave out the GL code, so it was neither compiled nor run against them.
+struct CStdGLBatchState
+{
+	enum { TexEnvReplace, TexEnvModulate, TexEnvAddAlpha, TexEnvMod2 };
+
+	GLenum Mode{GL_TRIANGLES}; // GL_TRIANGLES, GL_LINES or GL_POINTS
+	GLuint Tex{0}; // texture; zero for untextured primitives
+	int Program{-1}; // fragment shader index (mod2 + 2 * greying); -1 to use TexEnv
+	int TexEnv{TexEnvReplace}; // fixed function texture environment
+	int Saturation{255}; // saturation for greying shaders
+	bool fLinear{false}; // linear texture filtering
+	bool fSmooth{false}; // smooth shading
+	GLenum BlendSrc{GL_ONE_MINUS_SRC_ALPHA}, BlendDst{GL_SRC_ALPHA};
+
+	bool operator==(const CStdGLBatchState &rOther) const
+	{
+		return Mode == rOther.Mode && Tex == rOther.Tex && Program == rOther.Program && TexEnv == rOther.TexEnv &&
+			Saturation == rOther.Saturation && fLinear == rOther.fLinear && fSmooth == rOther.fSmooth &&
+			BlendSrc == rOther.BlendSrc && BlendDst == rOther.BlendDst;
+	}
+};
+
 // one OpenGL context
 class CStdGLCtx
 {
@@ -95,8 +130,18 @@ protected:
 	unsigned int shader;
 	// shaders for the ARB extension
 	GLuint shaders[6];
+	// pending primitives; drawn on state changes and at frame end
+	static const size_t MaxBatchVertices = 6 * 4096;
+	std::vector<CStdGLVertex> BatchVertices;
+	CStdGLBatchState BatchState;
+	GLuint BatchBuffer; // streaming vertex buffer; zero if not supported
+	int32_t iDrawCalls, iVertexCnt, iTexturedDrawCalls; // counters of the current frame
+
+	CStdGLVertex *AddToBatch(const CStdGLBatchState &State, size_t iCnt); // get room for iCnt vertices; flushes on state changes
 
 public:
+	int32_t LastDrawCalls, LastVertexCnt, LastTexturedDrawCalls; // counters of the last frame
+
 	// General
 	void Clear() override;
 	void Default() override;
@@ -134,6 +179,7 @@ public:
 	bool InvalidateDeviceObjects() override; // free device dependent objects
 	void SetTexture() override;
 	void ResetTexture() override;
+	void FlushBatch(); // draw all pending primitives; must be called before any direct GL access
 #ifdef _WIN32
 	bool DeviceReady() override { return !!MainCtx.hrc; }
 #elif defined(USE_X11)
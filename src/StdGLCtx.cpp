@@ -30,6 +30,7 @@ void CStdGLCtx::Deselect(bool secondary)
 {
 	if (pGL && pGL->pCurrCtx == this)
 	{
+		pGL->FlushBatch();
 		DoDeselect();
 		pGL->pCurrCtx = nullptr;
 	}
@@ -114,6 +115,8 @@ bool CStdGLCtx::Select(bool verbose, bool selectOnly)
 {
 	// safety
 	if (!pGL || !hrc) return false; if (!pGL->lpPrimary) return false;
+	// pending primitives belong to the previous context
+	pGL->FlushBatch();
 	// make context current
 	if (!wglMakeCurrent(hDC, hrc)) return false;
 
@@ -252,6 +255,8 @@ bool CStdGLCtx::Select(bool verbose, bool selectOnly)
 		if (verbose) pGL->Error("  gl: lpPrimary is zero");
 		return false;
 	}
+	// pending primitives belong to the previous context
+	pGL->FlushBatch();
 	// make context current
 	if (!pWindow->renderwnd || !glXMakeCurrent(pWindow->dpy, pWindow->renderwnd, ctx))
 	{
@@ -399,6 +404,8 @@ bool CStdGLCtx::Init(CStdWindow *pWindow, CStdApp *)
 
 bool CStdGLCtx::Select(bool verbose, bool selectOnly)
 {
+	// pending primitives belong to the previous context
+	pGL->FlushBatch();
 	SDL_GL_MakeCurrent(this->pWindow->sdlWindow, ctx);
 	if (!selectOnly)
 	{
@@ -0,0 +1,113 @@
+/*
+ * LegacyClonk
+ *
+ * Copyright (c) 2026, The LegacyClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* A pool of worker threads for data parallel loops */
+
+#include "StdParallel.h"
+
+#include <algorithm>
+
+namespace
+{
+	thread_local bool fInJob = false;
+}
+
+CStdWorkerPool::CStdWorkerPool()
+{
+	// the calling thread works, too
+	const unsigned int iThreads = std::min(std::thread::hardware_concurrency(), MaxThreads);
+	for (unsigned int i = 1; i < iThreads; ++i)
+		Workers.emplace_back(&CStdWorkerPool::Execute, this);
+}
+
+CStdWorkerPool::~CStdWorkerPool()
+{
+	{
+		const std::lock_guard lock{Mutex};
+		fStop = true;
+	}
+	StartCV.notify_all();
+	for (auto &Worker : Workers)
+		Worker.join();
+}
+
+CStdWorkerPool &CStdWorkerPool::Default()
+{
+	static CStdWorkerPool Pool;
+	return Pool;
+}
+
+void CStdWorkerPool::ForEach(int iCnt, const std::function<void(int)> &fnJob)
+{
+	if (iCnt <= 0) return;
+	// nothing to distribute?
+	if (Workers.empty() || iCnt == 1 || fInJob)
+	{
+		for (int i = 0; i < iCnt; ++i) fnJob(i);
+		return;
+	}
+	const std::lock_guard runLock{RunMutex};
+	// publish jobs once workers woken late for the previous call are gone
+	{
+		std::unique_lock lock{Mutex};
+		DoneCV.wait(lock, [this] { return !iActiveWorkers; });
+		pJob = &fnJob;
+		iJobCnt = iCnt;
+		iNextJob = 0;
+		iJobsDone = 0;
+		++iGeneration;
+	}
+	StartCV.notify_all();
+	// work on them, too
+	const int iDone = RunJobs(fnJob, iCnt);
+	// wait until all jobs are done and no worker accesses the job anymore
+	std::unique_lock lock{Mutex};
+	iJobsDone += iDone;
+	DoneCV.wait(lock, [this] { return iJobsDone == iJobCnt && !iActiveWorkers; });
+	pJob = nullptr;
+}
+
+void CStdWorkerPool::Execute()
+{
+	uint32_t iSeenGeneration = 0;
+	std::unique_lock lock{Mutex};
+	for (;;)
+	{
+		StartCV.wait(lock, [&] { return fStop || iGeneration != iSeenGeneration; });
+		if (fStop) return;
+		iSeenGeneration = iGeneration;
+		// already finished by the other threads?
+		if (!pJob) continue;
+		const std::function<void(int)> &fnJob = *pJob;
+		const int iCnt = iJobCnt;
+		++iActiveWorkers;
+		lock.unlock();
+		const int iDone = RunJobs(fnJob, iCnt);
+		lock.lock();
+		--iActiveWorkers;
+		iJobsDone += iDone;
+		DoneCV.notify_all();
+	}
+}
+
+int CStdWorkerPool::RunJobs(const std::function<void(int)> &fnJob, int iCnt)
+{
+	fInJob = true;
+	int iDone = 0;
+	for (int i; (i = iNextJob++) < iCnt; ++iDone)
+		fnJob(i);
+	fInJob = false;
+	return iDone;
+}
@@ -0,0 +1,61 @@
+/*
+ * LegacyClonk
+ *
+ * Copyright (c) 2026, The LegacyClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* A pool of worker threads for data parallel loops */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class CStdWorkerPool
+{
+public:
+	CStdWorkerPool();
+	~CStdWorkerPool();
+
+	static constexpr unsigned int MaxThreads = 16;
+
+protected:
+	std::vector<std::thread> Workers;
+	std::mutex Mutex; // guards job state
+	std::mutex RunMutex; // one ForEach at a time
+	std::condition_variable StartCV, DoneCV;
+	const std::function<void(int)> *pJob{nullptr};
+	int iJobCnt{0};
+	std::atomic<int> iNextJob{0};
+	int iJobsDone{0};
+	int iActiveWorkers{0};
+	uint32_t iGeneration{0};
+	bool fStop{false};
+
+public:
+	int GetThreadCount() const { return static_cast<int>(Workers.size()) + 1; } // including calling thread
+
+	// calls fnJob(i) for every i in [0, iCnt) on any thread and returns when all calls are done
+	// jobs must be independent; ForEach calls from within jobs are executed serially
+	void ForEach(int iCnt, const std::function<void(int)> &fnJob);
+
+	static CStdWorkerPool &Default(); // shared pool, created on first use
+
+protected:
+	void Execute();
+	int RunJobs(const std::function<void(int)> &fnJob, int iCnt);
+};
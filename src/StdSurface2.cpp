@@ -73,6 +73,8 @@ void CSurface::Default()
 	pMainSfc = nullptr;
 	ClrByOwnerClr = 0;
 	iTexSize = iTexX = iTexY = 0;
+	iTexOffX = iTexOffY = 0;
+	fInAtlas = false;
 	fIsRenderTarget = false;
 	fIsBackground = false;
 #ifdef _DEBUG
@@ -103,6 +105,8 @@ void CSurface::MoveFrom(CSurface *psfcFrom)
 	ClrByOwnerClr = psfcFrom->ClrByOwnerClr;
 	iTexSize = psfcFrom->iTexSize;
 	iTexX = psfcFrom->iTexX; iTexY = psfcFrom->iTexY;
+	iTexOffX = psfcFrom->iTexOffX; iTexOffY = psfcFrom->iTexOffY;
+	fInAtlas = psfcFrom->fInAtlas;
 #ifndef USE_CONSOLE
 	Format = psfcFrom->Format;
 #endif
@@ -118,6 +122,7 @@ void CSurface::Clear()
 	// release surface
 	FreeTextures();
 	ppTex = nullptr;
+	CTexAtlas::DeleteIfEmpty();
 #ifdef _DEBUG
 	delete dbg_idx;
 	dbg_idx = nullptr;
@@ -223,14 +228,24 @@ void CSurface::FreeTextures()
 {
 	if (ppTex)
 	{
-		// clear all textures
-		CTexRef **ppTx = ppTex;
-		for (int i = 0; i < iTexX * iTexY; ++i, ++ppTx)
-			delete *ppTx;
+		if (fInAtlas)
+		{
+			// shared texture is freed by the atlas
+			pTexAtlas->Release(this);
+		}
+		else
+		{
+			// clear all textures
+			CTexRef **ppTx = ppTex;
+			for (int i = 0; i < iTexX * iTexY; ++i, ++ppTx)
+				delete *ppTx;
+		}
 		// clear texture list
 		delete[] ppTex;
 		ppTex = nullptr;
 	}
+	iTexOffX = iTexOffY = 0;
+	fInAtlas = false;
 }
 
 #define RANGE 255
@@ -317,6 +332,18 @@ bool CSurface::CreateColorByOwner(CSurface *pBySurface)
 	// unlock
 	Unlock();
 	pMainSfc->Unlock();
+	// keep the same texture layout as the main surface
+	if (pMainSfc->fInAtlas)
+	{
+		if (pTexAtlas->Add(this)) pTexAtlas->Commit();
+		// no atlas space left: the main surface gets textures of its own again
+		else
+		{
+			const bool fRemoved = pTexAtlas->Remove(pMainSfc);
+			CTexAtlas::DeleteIfEmpty();
+			if (!fRemoved) return false;
+		}
+	}
 	// success
 	return true;
 }
@@ -434,6 +461,7 @@ bool CSurface::SavePNG(const char *szFilename, bool fSaveAlpha, bool fApplyGamma
 	if (fPrimary && pGL)
 	{
 		// Take shortcut. FIXME: Check Endian
+		pGL->FlushBatch();
 		for (int y = 0; y < realHgt; ++y)
 			glReadPixels(0, realHgt - y, realWdt, 1, fSaveAlpha ? GL_BGRA : GL_BGR, GL_UNSIGNED_BYTE, bmp.GetPixelAddr(0, y));
 	}
@@ -560,8 +588,8 @@ bool CSurface::GetTexAt(CTexRef **ppTexRef, int &rX, int &rY)
 	// get texture by pos
 	*ppTexRef = *(ppTex + iY * iTexX + iX);
 	// adjust pos
-	rX -= iX * iTexSize;
-	rY -= iY * iTexSize;
+	rX -= iX * iTexSize - iTexOffX;
+	rY -= iY * iTexSize - iTexOffY;
 	// success
 	return true;
 }
@@ -578,14 +606,21 @@ bool CSurface::GetLockTexAt(CTexRef **ppTexRef, int &rX, int &rY)
 		if (r.left > rX || r.top > rY || r.right < rX || r.bottom < rY)
 			// Unlock, then relock the whole thing
 			(*ppTexRef)->Unlock();
-		else return true;
+		else if (!fInAtlas) return true;
 	}
 	// ensure it's locked
-	if (!(*ppTexRef)->Lock()) return false;
+	if (!LockTex(*ppTexRef)) return false;
 	// success
 	return true;
 }
 
+bool CSurface::LockTex(CTexRef *pTex)
+{
+	if (!fInAtlas) return pTex->Lock();
+	const RECT rtSfc{iTexOffX, iTexOffY, iTexOffX + Wdt, iTexOffY + Hgt};
+	return pTex->Lock(rtSfc);
+}
+
 bool CSurface::SetPix(int iX, int iY, uint8_t byCol)
 {
 	return SetPixDw(iX, iY, lpDDrawPal->GetClr(byCol));
@@ -609,6 +644,7 @@ uint32_t CSurface::GetPixDw(int iX, int iY, bool fApplyModulation, float scale)
 				int wdt = static_cast<int32_t>(ceilf(Wdt * scale));
 				wdt = ((wdt + 3) / 4) * 4; // round up to the next multiple of 4
 				PrimarySurfaceLockBits = new unsigned char[wdt * hgt * 3];
+				pGL->FlushBatch();
 				glReadPixels(0, 0, wdt, hgt, GL_BGR, GL_UNSIGNED_BYTE, PrimarySurfaceLockBits);
 				PrimarySurfaceLockPitch = wdt * 3;
 			}
@@ -760,12 +796,16 @@ void CSurface::ClearBoxDw(int iX, int iY, int iWdt, int iHgt)
 			if (fBaseSfc)
 			{
 				// then get this surface as same offset as from other surface
-				// assuming this is only valid as long as there's no texture management,
-				// organizing partially used textures together!
+				// the atlas places both surfaces with the same tiling, but at different positions
 				CTexRef *pBaseTex = *(pMainSfc->ppTex + y * iTexX + x);
-				pBaseTex->ClearRect(rtClear);
+				RECT rtBaseClear = rtClear;
+				rtBaseClear.left += pMainSfc->iTexOffX; rtBaseClear.right += pMainSfc->iTexOffX;
+				rtBaseClear.top += pMainSfc->iTexOffY; rtBaseClear.bottom += pMainSfc->iTexOffY;
+				pBaseTex->ClearRect(rtBaseClear);
 			}
 			// clear this texture
+			rtClear.left += iTexOffX; rtClear.right += iTexOffX;
+			rtClear.top += iTexOffY; rtClear.bottom += iTexOffY;
 			pTex->ClearRect(rtClear);
 		}
 	}
@@ -783,8 +823,8 @@ bool CSurface::CopyBytes(uint8_t *pImageData)
 		for (int iX = 0; iX < iTexX; ++iX)
 		{
 			pTex = *ppCurrTex++;
-			if (!pTex->Lock()) return false;
-			uint8_t *pTarget = reinterpret_cast<uint8_t *>(pTex->texLock.pBits);
+			if (!LockTex(pTex)) return false;
+			uint8_t *pTarget = reinterpret_cast<uint8_t *>(pTex->texLock.pBits) + iTexOffY * pTex->texLock.Pitch + iTexOffX * 4;
 			int iCpyNum = (std::min)(pTex->iSize, Wdt - iXImgPos) * 4;
 			int iYMax = (std::min)(pTex->iSize, Hgt - iLineTotal);
 			for (int iLine = 0; iLine < iYMax; ++iLine)
@@ -801,6 +841,15 @@ bool CSurface::CopyBytes(uint8_t *pImageData)
 	return true;
 }
 
+// extend rect to cover another one; empty rects are ignored
+static void UniteRect(RECT &rRect, const RECT &rAdd)
+{
+	if (rAdd.left >= rAdd.right || rAdd.top >= rAdd.bottom) return;
+	if (rRect.left >= rRect.right || rRect.top >= rRect.bottom) { rRect = rAdd; return; }
+	rRect.left = (std::min)(rRect.left, rAdd.left); rRect.top = (std::min)(rRect.top, rAdd.top);
+	rRect.right = (std::max)(rRect.right, rAdd.right); rRect.bottom = (std::max)(rRect.bottom, rAdd.bottom);
+}
+
 CTexRef::CTexRef(int iSize, bool fSingle)
 {
 	// zero fields
@@ -808,6 +857,7 @@ CTexRef::CTexRef(int iSize, bool fSingle)
 	texName = 0;
 #endif
 	texLock.pBits = nullptr; fIntLock = false;
+	LockSize = ChangedRect = RECT{};
 	// store size
 	this->iSize = iSize;
 	// add to texture manager
@@ -848,7 +898,11 @@ CTexRef::~CTexRef()
 #ifndef USE_CONSOLE
 	if (pGL)
 	{
-		if (texName && pGL->pCurrCtx) glDeleteTextures(1, &texName);
+		if (texName && pGL->pCurrCtx)
+		{
+			pGL->FlushBatch();
+			glDeleteTextures(1, &texName);
+		}
 	}
 #endif
 	if (lpDDraw) delete[] texLock.pBits; texLock.pBits = nullptr;
@@ -864,6 +918,7 @@ bool CTexRef::LockForUpdate(RECT &rtUpdate)
 		// fully locked
 		if (LockSize.left == 0 && LockSize.right == iSize && LockSize.top == 0 && LockSize.bottom == iSize)
 		{
+			UniteRect(ChangedRect, rtUpdate);
 			return true;
 		}
 		else
@@ -882,7 +937,7 @@ bool CTexRef::LockForUpdate(RECT &rtUpdate)
 			texLock.pBits = new unsigned char[
 				(rtUpdate.right - rtUpdate.left) * (rtUpdate.bottom - rtUpdate.top) * 4];
 			texLock.Pitch = (rtUpdate.right - rtUpdate.left) * 4;
-			LockSize = rtUpdate;
+			LockSize = ChangedRect = rtUpdate;
 			return true;
 		}
 	}
@@ -896,11 +951,18 @@ bool CTexRef::LockForUpdate(RECT &rtUpdate)
 }
 
 bool CTexRef::Lock()
+{
+	const RECT rtAll{0, 0, iSize, iSize};
+	return Lock(rtAll);
+}
+
+bool CTexRef::Lock(const RECT &rtChange)
 {
 	// already locked?
-	if (texLock.pBits) return true;
+	if (texLock.pBits) { UniteRect(ChangedRect, rtChange); return true; }
 	LockSize.right = LockSize.bottom = iSize;
 	LockSize.top = LockSize.left = 0;
+	ChangedRect = rtChange;
 	// lock
 #ifndef USE_CONSOLE
 	if (pGL)
@@ -935,6 +997,8 @@ void CTexRef::Unlock()
 	{
 		// select context, if not already done
 		if (!pGL->pCurrCtx) if (!pGL->MainCtx.Select()) return;
+		// pending primitives might use the old contents
+		pGL->FlushBatch();
 		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 		if (!texName)
 		{
@@ -950,11 +1014,17 @@ void CTexRef::Unlock()
 		}
 		else
 		{
-			// reuse the existing texture
-			glBindTexture(GL_TEXTURE_2D, texName);
-			glTexSubImage2D(GL_TEXTURE_2D, 0,
-				LockSize.left, LockSize.top, LockSize.right - LockSize.left, LockSize.bottom - LockSize.top,
-				GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, texLock.pBits);
+			// reuse the existing texture; only the changed part is uploaded
+			const int iLeft = (std::max)(ChangedRect.left, LockSize.left), iTop = (std::max)(ChangedRect.top, LockSize.top);
+			const int iRight = (std::min)(ChangedRect.right, LockSize.right), iBottom = (std::min)(ChangedRect.bottom, LockSize.bottom);
+			if (iRight > iLeft && iBottom > iTop)
+			{
+				glBindTexture(GL_TEXTURE_2D, texName);
+				glPixelStorei(GL_UNPACK_ROW_LENGTH, texLock.Pitch / 4);
+				glTexSubImage2D(GL_TEXTURE_2D, 0, iLeft, iTop, iRight - iLeft, iBottom - iTop, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
+					texLock.pBits + (iTop - LockSize.top) * texLock.Pitch + (iLeft - LockSize.left) * 4);
+				glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+			}
 		}
 		delete[] texLock.pBits; texLock.pBits = nullptr;
 		// switch back to original context
@@ -1041,4 +1111,221 @@ void CTexMgr::IntUnlock()
 }
 
 CTexMgr *pTexMgr;
+
+// texture atlas
+
+bool CTexAtlas::AllocateIn(Page &rPage, int iWdt, int iHgt, int &rX, int &rY)
+{
+	// find the lowest shelf the surface fits in
+	Shelf *pShelf = nullptr;
+	for (Shelf &rShelf : rPage.Shelves)
+		if (iHgt <= rShelf.iHgt && rShelf.iX + iWdt <= PageSize)
+			if (!pShelf || rShelf.iHgt < pShelf->iHgt) pShelf = &rShelf;
+	if (!pShelf)
+	{
+		// open a new shelf below the last one
+		if (rPage.iUsedHgt + iHgt > PageSize) return false;
+		rPage.Shelves.push_back({rPage.iUsedHgt, iHgt, 0});
+		rPage.iUsedHgt += iHgt;
+		pShelf = &rPage.Shelves.back();
+	}
+	// place it
+	rX = pShelf->iX; rY = pShelf->iY;
+	pShelf->iX += iWdt;
+	return true;
+}
+
+CTexAtlas::Page *CTexAtlas::Allocate(int iWdt, int iHgt, int &rX, int &rY)
+{
+	// try existing pages first
+	for (Page &rPage : Pages)
+		if (AllocateIn(rPage, iWdt, iHgt, rX, rY)) return &rPage;
+#ifndef USE_CONSOLE
+	// the page must fit into a single texture
+	GLint iMaxTexSize = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &iMaxTexSize);
+	if (iMaxTexSize < PageSize) return nullptr;
+#endif
+	// open a new page; it starts out transparent
+	Pages.push_back({new CTexRef(PageSize, false), {}, 0, 0, 0});
+	Page &rPage = Pages.back();
+	if (!AllocateIn(rPage, iWdt, iHgt, rX, rY))
+	{
+		delete rPage.pTex;
+		Pages.pop_back();
+		return nullptr;
+	}
+	return &rPage;
+}
+
+void CTexAtlas::Deallocate(Page *pPage, int iX, int iY, int iWdt)
+{
+	// only the latest allocation can be taken back
+	for (Shelf &rShelf : pPage->Shelves)
+		if (rShelf.iY == iY && rShelf.iX == iX + iWdt)
+		{
+			rShelf.iX = iX;
+			break;
+		}
+	if (!pPage->Shelves.empty() && !pPage->Shelves.back().iX)
+	{
+		pPage->iUsedHgt -= pPage->Shelves.back().iHgt;
+		pPage->Shelves.pop_back();
+	}
+	// drop pages that were opened for nothing
+	if (!pPage->iSurfaceCnt)
+	{
+		delete pPage->pTex;
+		Pages.erase(Pages.begin() + (pPage - Pages.data()));
+	}
+}
+
+bool CTexAtlas::CopyTiles(CSurface *pSfc, const D3DLOCKED_RECT &rBuf, int iX, int iY, bool fToTiles)
+{
+	for (int tY = 0; tY < pSfc->iTexY; ++tY)
+		for (int tX = 0; tX < pSfc->iTexX; ++tX)
+		{
+			CTexRef *pTex = pSfc->ppTex[tY * pSfc->iTexX + tX];
+			if (!pTex->Lock()) return false;
+			const int iSrcX = tX * pSfc->iTexSize, iSrcY = tY * pSfc->iTexSize;
+			const int iCpyWdt = (std::min)(pTex->iSize, pSfc->Wdt - iSrcX);
+			const int iCpyHgt = (std::min)(pTex->iSize, pSfc->Hgt - iSrcY);
+			for (int y = 0; y < iCpyHgt; ++y)
+			{
+				unsigned char *pBuf = rBuf.pBits + (iY + iSrcY + y) * rBuf.Pitch + (iX + iSrcX) * 4;
+				unsigned char *pTile = pTex->texLock.pBits + y * pTex->texLock.Pitch;
+				if (fToTiles) memcpy(pTile, pBuf, iCpyWdt * 4); else memcpy(pBuf, pTile, iCpyWdt * 4);
+			}
+			// tiles that are read from are freed right afterwards
+			if (fToTiles) pTex->Unlock();
+		}
+	return true;
+}
+
+void CTexAtlas::MoveTo(Page *pPage, CSurface *pSfc, int iX, int iY)
+{
+	pSfc->FreeTextures();
+	pSfc->ppTex = new CTexRef *[1]{pPage->pTex};
+	pSfc->iTexSize = PageSize;
+	pSfc->iTexX = pSfc->iTexY = 1;
+	pSfc->iTexOffX = iX; pSfc->iTexOffY = iY;
+	pSfc->fInAtlas = true;
+	++pPage->iSurfaceCnt;
+	pPage->iUsedArea += pSfc->Wdt * pSfc->Hgt;
+}
+
+bool CTexAtlas::CanAdd(CSurface *pSfc)
+{
+#ifndef USE_CONSOLE
+	// only accelerated surfaces profit from shared textures
+	if (!pGL || !pSfc || !pSfc->ppTex) return false;
+	if (pSfc->fInAtlas || pSfc->fPrimary || pSfc->fIsRenderTarget || pSfc->fIsBackground || pSfc->Locked) return false;
+	return pSfc->Wdt <= MaxSurfaceSize && pSfc->Hgt <= MaxSurfaceSize;
+#else
+	return false;
+#endif
+}
+
+bool CTexAtlas::Add(CSurface *pSfc, CSurface *pClrSfc)
+{
+	if (!CanAdd(pSfc)) return false;
+	// ColorByOwner-surfaces are blitted with the tiling of their main surface
+	if (pSfc->pMainSfc && !pSfc->pMainSfc->fInAtlas) return false;
+	if (pClrSfc && (!CanAdd(pClrSfc) || pClrSfc->pMainSfc != pSfc || pClrSfc->Wdt != pSfc->Wdt || pClrSfc->Hgt != pSfc->Hgt)) return false;
+	// reserve space including the gutter; a ColorByOwner-surface goes right next to its main surface
+	const int iSfcWdt = pSfc->Wdt + Gutter * 2;
+	const int iWdt = pClrSfc ? iSfcWdt * 2 : iSfcWdt;
+	int iX, iY;
+	Page *pPage = Allocate(iWdt, pSfc->Hgt + Gutter * 2, iX, iY);
+	if (!pPage) return false;
+	// copy surface contents; only the reserved area is uploaded, with a transparent gutter
+	CTexRef *pPageTex = pPage->pTex;
+	RECT rtArea{iX, iY, iX + iWdt, iY + pSfc->Hgt + Gutter * 2};
+	bool fCopied = pPageTex->LockForUpdate(rtArea);
+	if (fCopied)
+	{
+		const D3DLOCKED_RECT &rDst = pPageTex->texLock;
+		const int iDstX = iX - pPageTex->LockSize.left, iDstY = iY - pPageTex->LockSize.top;
+		for (int y = 0; y < rtArea.bottom - rtArea.top; ++y)
+			memset(rDst.pBits + (iDstY + y) * rDst.Pitch + iDstX * 4, 0xff, iWdt * 4);
+		fCopied = CopyTiles(pSfc, rDst, iDstX + Gutter, iDstY + Gutter, false)
+			&& (!pClrSfc || CopyTiles(pClrSfc, rDst, iDstX + iSfcWdt + Gutter, iDstY + Gutter, false));
+	}
+	if (!fCopied)
+	{
+		// leave both surfaces as they were
+		for (CSurface *pUnlockSfc : {pSfc, pClrSfc})
+			if (pUnlockSfc)
+				for (int i = 0; i < pUnlockSfc->iTexX * pUnlockSfc->iTexY; ++i)
+					pUnlockSfc->ppTex[i]->Unlock();
+		Deallocate(pPage, iX, iY, iWdt);
+		return false;
+	}
+	// switch surfaces over to the shared texture
+	MoveTo(pPage, pSfc, iX + Gutter, iY + Gutter);
+	if (pClrSfc) MoveTo(pPage, pClrSfc, iX + iSfcWdt + Gutter, iY + Gutter);
+	return true;
+}
+
+bool CTexAtlas::Remove(CSurface *pSfc)
+{
+	if (!pSfc->fInAtlas) return false;
+	// save contents; pending changes of the page go up first, reading it changes nothing
+	CTexRef *pPageTex = *pSfc->ppTex;
+	pPageTex->Unlock();
+	if (!pPageTex->Lock(RECT{})) return false;
+	std::vector<unsigned char> Pixels(pSfc->Wdt * pSfc->Hgt * 4);
+	const D3DLOCKED_RECT Buf{pSfc->Wdt * 4, Pixels.data()};
+	for (int y = 0; y < pSfc->Hgt; ++y)
+		memcpy(Buf.pBits + y * Buf.Pitch, pPageTex->texLock.pBits + (pSfc->iTexOffY + y) * pPageTex->texLock.Pitch + pSfc->iTexOffX * 4, Buf.Pitch);
+	pPageTex->Unlock();
+	// create textures of its own; this releases the atlas space
+	if (!pSfc->CreateTextures()) return false;
+	return CopyTiles(pSfc, Buf, 0, 0, true);
+}
+
+void CTexAtlas::Commit()
+{
+	for (Page &rPage : Pages) rPage.pTex->Unlock();
+}
+
+void CTexAtlas::Release(CSurface *pSfc)
+{
+	for (auto it = Pages.begin(); it != Pages.end(); ++it)
+		if (it->pTex == *pSfc->ppTex)
+		{
+			it->iUsedArea -= pSfc->Wdt * pSfc->Hgt;
+			// the space itself is not reused; drop the page once it's empty
+			if (!--it->iSurfaceCnt)
+			{
+				delete it->pTex;
+				Pages.erase(it);
+			}
+			return;
+		}
+}
+
+void CTexAtlas::DeleteIfEmpty()
+{
+	// not done in Release, which may be called from within the atlas
+	if (pTexAtlas && pTexAtlas->IsEmpty())
+	{
+		delete pTexAtlas; pTexAtlas = nullptr;
+	}
+}
+
+StdStrBuf CTexAtlas::GetStats()
+{
+	int iSurfaceCnt = 0, iUsedArea = 0;
+	for (const Page &rPage : Pages)
+	{
+		iSurfaceCnt += rPage.iSurfaceCnt;
+		iUsedArea += rPage.iUsedArea;
+	}
+	const int iPageCnt = static_cast<int>(Pages.size());
+	const int iOccupied = iPageCnt ? static_cast<int>(int64_t{iUsedArea} * 100 / (int64_t{iPageCnt} * PageSize * PageSize)) : 0;
+	return FormatString("Texture atlas: %d surfaces on %d pages, %d%% occupied", iSurfaceCnt, iPageCnt, iOccupied);
+}
+
+CTexAtlas *pTexAtlas;
 const uint8_t FColors[] = { 31, 16, 39, 47, 55, 63, 71, 79, 87, 95, 23, 30, 99, 103 };
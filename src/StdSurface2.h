@@ -20,6 +20,7 @@
 #pragma once
 
 #include <Standard.h>
+#include <StdBuf.h>
 #include <StdColors.h>
 
 #ifndef USE_CONSOLE
@@ -27,6 +28,7 @@
 #endif
 
 #include <list>
+#include <vector>
 
 // config settings
 #define C4GFXCFG_NO_ALPHA_ADD    1
@@ -147,6 +149,8 @@ public:
 	CTexRef **ppTex; // textures
 	CSurface *pMainSfc; // main surface for simple ColorByOwner-surfaces
 	uint32_t ClrByOwnerClr; // current color to be used for ColorByOwner-blits
+	int iTexOffX, iTexOffY; // position of surface data within texture
+	bool fInAtlas; // set if surface is placed in a shared atlas texture
 
 	void MoveFrom(CSurface *psfcFrom); // grab data from other surface - invalidates other surface
 	bool IsRenderTarget(); // surface can be used as a render target?
@@ -189,10 +193,12 @@ public:
 protected:
 	bool CreateTextures(); // create ppTex-array
 	void FreeTextures(); // free ppTex-array if existent
+	bool LockTex(CTexRef *pTex); // lock texture of this surface; surfaces in an atlas only change their part of the page
 
 	friend class CStdDDraw;
 	friend class CPattern;
 	friend class CStdGL;
+	friend class CTexAtlas;
 };
 
 typedef struct _D3DLOCKED_RECT
@@ -212,10 +218,12 @@ public:
 	int iSize;
 	bool fIntLock; // if set, texref is locked internally only
 	RECT LockSize;
+	RECT ChangedRect; // part of the locked area that is uploaded on unlock
 
 	CTexRef(int iSize, bool fAsRenderTarget); // create texture with given size
 	~CTexRef(); // release texture
 	bool Lock(); // lock texture
+	bool Lock(const RECT &rtChange); // lock texture; only the given part of it is uploaded on unlock
 	// Lock a part of the rect, discarding the content
 	// Note: Calling Lock afterwards without an Unlock first is undefined
 	bool LockForUpdate(RECT &rtUpdate);
@@ -247,3 +255,48 @@ public:
 };
 
 extern CTexMgr *pTexMgr;
+
+// packs small surfaces into shared textures, so blits from them can be batched
+class CTexAtlas
+{
+public:
+	static const int PageSize = 1024; // size of atlas textures
+	static const int MaxSurfaceSize = 256; // larger surfaces keep their own textures
+	static const int Gutter = 2; // transparent border around each surface against filtering bleed
+
+protected:
+	struct Shelf
+	{
+		int iY, iHgt; // vertical position and height of shelf
+		int iX; // start of free space
+	};
+
+	struct Page
+	{
+		CTexRef *pTex;
+		std::vector<Shelf> Shelves;
+		int iUsedHgt; // bottom of last shelf
+		int iSurfaceCnt; // number of surfaces placed on this page
+		int iUsedArea; // pixels covered by these surfaces
+	};
+
+	std::vector<Page> Pages;
+
+	bool AllocateIn(Page &rPage, int iWdt, int iHgt, int &rX, int &rY);
+	Page *Allocate(int iWdt, int iHgt, int &rX, int &rY);
+	void Deallocate(Page *pPage, int iX, int iY, int iWdt); // undo the latest allocation; drops the page if it's unused
+	static bool CopyTiles(CSurface *pSfc, const D3DLOCKED_RECT &rBuf, int iX, int iY, bool fToTiles); // copy between surface textures and a locked buffer
+	void MoveTo(Page *pPage, CSurface *pSfc, int iX, int iY);
+
+public:
+	bool CanAdd(CSurface *pSfc); // check whether surface is small and static enough to be moved into the atlas
+	bool Add(CSurface *pSfc, CSurface *pClrSfc = nullptr); // move surface and its ColorByOwner-surface into the atlas, both or neither; ColorByOwner-surfaces added alone need their main surface to be added first
+	bool Remove(CSurface *pSfc); // move surface back into textures of its own; may leave the atlas empty
+	void Commit(); // upload pending changes of all pages
+	void Release(CSurface *pSfc); // free atlas space of surface
+	bool IsEmpty() { return Pages.empty(); }
+	static void DeleteIfEmpty(); // delete the atlas once its last page is gone
+	StdStrBuf GetStats(); // get page count and occupancy
+};
+
+extern CTexAtlas *pTexAtlas;
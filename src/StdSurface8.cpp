@@ -299,12 +299,13 @@ static CPolyEdge *remove_edge(CPolyEdge *list, CPolyEdge *edge)
 	else return edge->next;
 }
 
-// Global polygon quick buffer
+// Polygon quick buffer size
 const int QuickPolyBufSize = 20;
-CPolyEdge QuickPolyBuf[QuickPolyBufSize];
 
-void CSurface8::Polygon(int iNum, int *ipVtx, int iCol)
+void CSurface8::Polygon(int iNum, int *ipVtx, int iCol, int iClipY, int iClipY2)
 {
+	// Local quick buffer, so polygons may be drawn to different rows in parallel
+	CPolyEdge QuickPolyBuf[QuickPolyBufSize];
 	// Variables for polygon drawer
 	int c, x1, x2, y;
 	int top = INT_MAX;
@@ -346,6 +347,7 @@ void CSurface8::Polygon(int iNum, int *ipVtx, int iCol)
 	}
 
 	// For each scanline in the polygon...
+	bottom = std::min(bottom, iClipY2);
 	for (c = top; c <= bottom; c++)
 	{
 		// Check for newly active edges
@@ -359,7 +361,7 @@ void CSurface8::Polygon(int iNum, int *ipVtx, int iCol)
 		}
 
 		// Draw horizontal line segments
-		edge = active_edges;
+		edge = (c >= iClipY) ? active_edges : nullptr;
 		while ((edge) && (edge->next))
 		{
 			x1 = edge->x >> POLYGON_FIX_SHIFT;
@@ -22,6 +22,8 @@
 #include <Standard.h>
 #include <StdColors.h>
 
+#include <climits>
+
 class CSurface8
 {
 public:
@@ -36,7 +38,7 @@ public:
 	CStdPalette *pPal; // pal for this surface (usually points to the main pal)
 	bool HasOwnPal(); // return whether the surface palette is owned
 	void HLine(int iX, int iX2, int iY, int iCol);
-	void Polygon(int iNum, int *ipVtx, int iCol);
+	void Polygon(int iNum, int *ipVtx, int iCol, int iClipY = 0, int iClipY2 = INT_MAX); // rows outside iClipY to iClipY2 are skipped, too
 	void Box(int iX, int iY, int iX2, int iY2, int iCol);
 	void Circle(int x, int y, int r, uint8_t col);
 	void ClearBox8Only(int iX, int iY, int iWdt, int iHgt); // clear box in 8bpp-surface only
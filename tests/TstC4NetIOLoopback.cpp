@@ -0,0 +1,166 @@
+// Loopback test of C4NetIOUDP: a client sends packets of different sizes to a server through a relay
+// that drops and delays datagrams. All packets must arrive intact and in order.
+// Usage: TstC4NetIOLoopback [loss latency] (loss in percent, latency in ms)
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <C4NetIO.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <utility>
+
+using namespace std;
+
+bool Log(char const *text) { cout << text << endl; return true; }
+
+class LossyRelay : public C4NetIO::CBClass
+{
+	C4NetIOSimpleUDP ClientSide, ServerSide;
+	C4NetIO::addr_t ClientAddr, ServerAddr;
+	std::multimap<unsigned int, std::pair<C4NetIOSimpleUDP *, C4NetIOPacket>> Delayed; // by delivery time
+	unsigned int iLastDelivery[2] = { 0, 0 }; // per direction, so jitter doesn't reorder
+	int iLoss, iLatency;
+
+public:
+	LossyRelay(int iLoss, int iLatency) : iLoss(iLoss), iLatency(iLatency) {}
+
+	bool Init(uint16_t iClientPort, uint16_t iServerPort, const C4NetIO::addr_t &nServerAddr)
+	{
+		ServerAddr = nServerAddr;
+		ClientSide.SetCallback(this); ServerSide.SetCallback(this);
+		return ClientSide.Init(iClientPort) && ServerSide.Init(iServerPort);
+	}
+
+	void Execute()
+	{
+		ClientSide.Execute(0); ServerSide.Execute(0);
+		// deliver due datagrams
+		const unsigned int iNow = timeGetTime();
+		while (!Delayed.empty() && Delayed.begin()->first <= iNow)
+		{
+			Delayed.begin()->second.first->Send(Delayed.begin()->second.second);
+			Delayed.erase(Delayed.begin());
+		}
+	}
+
+	virtual void OnPacket(const C4NetIOPacket &rPacket, C4NetIO *pNetIO) override
+	{
+		if (pNetIO == &ClientSide) ClientAddr = rPacket.getAddr();
+		if (rand() % 100 < iLoss) return;
+		// latency with up to 50% jitter
+		const bool fToServer = pNetIO == &ClientSide;
+		C4NetIOPacket Pkt = rPacket.Duplicate();
+		Pkt.SetAddr(fToServer ? ServerAddr : ClientAddr);
+		unsigned int &iDelivery = iLastDelivery[fToServer];
+		iDelivery = std::max<unsigned int>(iDelivery, timeGetTime() + iLatency + rand() % (iLatency / 2 + 1));
+		Delayed.emplace(iDelivery, std::make_pair(fToServer ? &ServerSide : &ClientSide, std::move(Pkt)));
+	}
+};
+
+class LoopbackCB : public C4NetIO::CBClass
+{
+public:
+	bool fConnected = false, fDisconnected = false, fCorrupt = false;
+	int iReceived = 0;
+
+	static size_t GetPacketSize(int i)
+	{
+		// single byte, single fragment, several fragments, large
+		static const size_t Sizes[] = { 1, 100, 1232 * 3 + 7, 8000 };
+		return Sizes[i % 4];
+	}
+
+	virtual bool OnConn(const C4NetIO::addr_t &AddrPeer, const C4NetIO::addr_t &AddrConnect, const C4NetIO::addr_t *pOwnAddr, C4NetIO *pNetIO) override
+	{
+		fConnected = true;
+		return true;
+	}
+	virtual void OnDisconn(const C4NetIO::addr_t &AddrPeer, C4NetIO *pNetIO, const char *szReason) override
+	{
+		cout << "disconnected (" << szReason << ")" << endl;
+		fDisconnected = true;
+	}
+	virtual void OnPacket(const C4NetIOPacket &rPacket, C4NetIO *pNetIO) override
+	{
+		bool fOK = rPacket.getSize() == GetPacketSize(iReceived);
+		for (size_t i = 0; fOK && i < rPacket.getSize(); i++)
+			fOK = getBufPtr<uint8_t>(rPacket)[i] == static_cast<uint8_t>(iReceived + i);
+		if (!fOK)
+		{
+			cout << "packet " << iReceived << " corrupt or out of order" << endl;
+			fCorrupt = true;
+		}
+		iReceived++;
+	}
+};
+
+int LoopbackTest(int iLoss, int iLatency)
+{
+	const int iPacketCnt = 200;
+	const uint16_t iServerPort = 11121, iRelayClientPort = 11122, iRelayServerPort = 11123, iClientPort = 11124;
+	cout << "loopback test: " << iPacketCnt << " packets, " << iLoss << "% loss, " << iLatency << " ms latency" << endl;
+
+	C4NetIOUDP Server, Client;
+	LoopbackCB ServerCB, ClientCB;
+	LossyRelay Relay(iLoss, iLatency);
+	Server.SetCallback(&ServerCB); Client.SetCallback(&ClientCB);
+	if (!Server.Init(iServerPort) || !Client.Init(iClientPort) ||
+		!Relay.Init(iRelayClientPort, iRelayServerPort, C4NetIO::addr_t(C4NetIO::HostAddress::Loopback, iServerPort)))
+	{
+		cout << "init failed" << endl;
+		return 1;
+	}
+	const C4NetIO::addr_t RelayAddr(C4NetIO::HostAddress::Loopback, iRelayClientPort);
+	Client.Connect(RelayAddr);
+
+	const unsigned int iStart = timeGetTime();
+	int iSent = 0;
+	while (ServerCB.iReceived < iPacketCnt && !ServerCB.fCorrupt && !ServerCB.fDisconnected && !ClientCB.fDisconnected)
+	{
+		if (timeGetTime() > iStart + 120000)
+		{
+			cout << "timeout, " << ServerCB.iReceived << " packets received" << endl;
+			return 1;
+		}
+		// keep some packets queued
+		if (ClientCB.fConnected)
+			for (; iSent < iPacketCnt && iSent < ServerCB.iReceived + 50; iSent++)
+			{
+				StdBuf Data; Data.New(LoopbackCB::GetPacketSize(iSent));
+				for (size_t i = 0; i < Data.getSize(); i++)
+					getMBufPtr<uint8_t>(Data)[i] = static_cast<uint8_t>(iSent + i);
+				if (!Client.Send(C4NetIOPacket(Data, RelayAddr)))
+				{
+					cout << "send failed: " << Client.GetError() << endl;
+					return 1;
+				}
+			}
+		Client.Execute(1); Relay.Execute(); Server.Execute(1);
+	}
+	if (ServerCB.iReceived < iPacketCnt || ServerCB.fCorrupt)
+		return 1;
+	cout << "ok, " << timeGetTime() - iStart << " ms" << endl;
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+#ifdef HAVE_WINSOCK
+	WSADATA wsaData;
+	WSAStartup(0x0202, &wsaData);
+#endif
+	srand(static_cast<unsigned int>(time(nullptr)));
+	int iLoss = 5, iLatency = 50;
+	if (argc > 2)
+	{
+		iLoss = atoi(argv[1]);
+		iLatency = atoi(argv[2]);
+	}
+	return LoopbackTest(iLoss, iLatency);
+}